@@ -89,10 +89,14 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
   //  `empty_accumulator` is an Accumulator instance used as a prototype for
   //      creating new accumulators. Note that a given accumulator may be used
   //      for multiple groups within a single operation.
+  //  `options` are passed to DenseGroupOps when all the arguments are in
+  //      the dense form. Other forms are always processed sequentially.
   explicit ArrayGroupOpImpl(RawBufferFactory* buffer_factory,
-                            Accumulator empty_accumulator = Accumulator())
+                            Accumulator empty_accumulator = Accumulator(),
+                            DenseGroupOpsOptions options = {})
       : buffer_factory_(buffer_factory),
-        empty_accumulator_(std::move(empty_accumulator)) {}
+        empty_accumulator_(std::move(empty_accumulator)),
+        options_(options) {}
 
   // Applies this group operator.
   //
@@ -112,7 +116,7 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
           (p_args.IsDenseForm() && ... && true) &&
           (c_args.IsDenseForm() && ... && true)) {
         auto op = [this](const auto&... args) ABSL_ATTRIBUTE_NOINLINE {
-          return DenseGroupOp(buffer_factory_, empty_accumulator_)
+          return DenseGroupOp(buffer_factory_, empty_accumulator_, options_)
               .Apply(args...);
         };
         ASSIGN_OR_RETURN(DenseArray<ResT> res,
@@ -188,7 +192,7 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
     if constexpr (UseDenseGroupOps) {
       if ((c_args.IsDenseForm() && ... && true)) {
         auto op = [this](const auto&... args) ABSL_ATTRIBUTE_NOINLINE {
-          return DenseGroupOp(buffer_factory_, empty_accumulator_)
+          return DenseGroupOp(buffer_factory_, empty_accumulator_, options_)
               .Apply(args...);
         };
         ASSIGN_OR_RETURN(auto res, op(edge.ToDenseArrayGroupScalarEdge(),
@@ -612,6 +616,7 @@ class ArrayGroupOpImpl<Accumulator, meta::type_list<ParentTs...>,
 
   RawBufferFactory* buffer_factory_;
   const Accumulator empty_accumulator_;
+  const DenseGroupOpsOptions options_;
 };
 
 }  // namespace array_ops_internal
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <iterator>
 #include <optional>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/memory/simple_buffer.h"
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
@@ -63,21 +65,28 @@ class ArrayToFramesCopier : public BatchToFramesCopier {
 
   void CopyNextBatch(absl::Span<FramePtr> output_buffers) final {
     if (!IsStarted()) Start();  // Forbid adding new mappings.
+    CopyBatchAt(current_row_id_, output_buffers);
+    current_row_id_ += output_buffers.size();
+  }
+
+  bool SupportsCopyBatchAt() const final { return true; }
+
+  void CopyBatchAt(int64_t row_id,
+                   absl::Span<FramePtr> output_buffers) const final {
     for (const Mapping& mapping : mappings_) {
       const DenseArray<T>& data = mapping.array.dense_data();
       auto scalar_slot = mapping.scalar_slot;
       if (mapping.array.IsFullForm()) {
-        auto iter = data.values.begin() + current_row_id_;
+        auto iter = data.values.begin() + row_id;
         for (FramePtr frame : output_buffers) {
           frame.Set(scalar_slot, {true, T(*(iter++))});
         }
       } else if (mapping.array.IsDenseForm()) {
         bitmap::IterateByGroups(
-            data.bitmap.begin(), current_row_id_ + data.bitmap_bit_offset,
+            data.bitmap.begin(), row_id + data.bitmap_bit_offset,
             output_buffers.size(), [&](int64_t offset) {
               FramePtr* frames_group = output_buffers.begin() + offset;
-              auto values_group =
-                  data.values.begin() + current_row_id_ + offset;
+              auto values_group = data.values.begin() + row_id + offset;
               return [=](int64_t i, bool present) {
                 frames_group[i].Set(scalar_slot, {present, T(values_group[i])});
               };
@@ -90,14 +99,14 @@ class ArrayToFramesCopier : public BatchToFramesCopier {
         const IdFilter& id_filter = mapping.array.id_filter();
         const int64_t* ids_iter =
             std::lower_bound(id_filter.ids().begin(), id_filter.ids().end(),
-                             current_row_id_ + id_filter.ids_offset());
+                             row_id + id_filter.ids_offset());
         int64_t offset_from = std::distance(id_filter.ids().begin(), ids_iter);
         auto iter_to = std::lower_bound(
             id_filter.ids().begin(), id_filter.ids().end(),
-            current_row_id_ + output_buffers.size() + id_filter.ids_offset());
+            row_id + output_buffers.size() + id_filter.ids_offset());
         int64_t count = std::distance(ids_iter, iter_to);
         FramePtr* frames =
-            output_buffers.begin() - id_filter.ids_offset() - current_row_id_;
+            output_buffers.begin() - id_filter.ids_offset() - row_id;
         if (data.bitmap.empty()) {
           auto values_iter = data.values.begin() + offset_from;
           for (int64_t i = 0; i < count; ++i) {
@@ -117,7 +126,6 @@ class ArrayToFramesCopier : public BatchToFramesCopier {
         }
       }
     }
-    current_row_id_ += output_buffers.size();
   }
 
  private:
@@ -162,40 +170,23 @@ class ArrayFromFramesCopier : public BatchFromFramesCopier {
       return absl::FailedPreconditionError(
           "Start(row_count) should be called before CopyNextBatch");
     }
-
-    for (Mapping& mapping : mappings_) {
-      DCHECK(mapping.values_builder.has_value());
-      if (std::holds_alternative<FrameLayout::Slot<T>>(mapping.scalar_slot)) {
-        // copy from non-optional scalars into array.
-        auto scalar_slot =
-            *std::get_if<FrameLayout::Slot<T>>(&mapping.scalar_slot);
-        const ConstFramePtr* iter = input_buffers.data();
-        mapping.values_builder->SetN(
-            current_row_id_, input_buffers.size(),
-            [&] { return (iter++)->Get(scalar_slot); });
-      } else {
-        // copy from optional scalars into array.
-        DCHECK(std::holds_alternative<FrameLayout::Slot<OptionalValue<T>>>(
-            mapping.scalar_slot));
-        DCHECK(mapping.bitmap_builder.has_value());
-        auto scalar_slot = *std::get_if<FrameLayout::Slot<OptionalValue<T>>>(
-            &mapping.scalar_slot);
-        auto values_inserter =
-            mapping.values_builder->GetInserter(current_row_id_);
-        auto fn = [&](ConstFramePtr frame) {
-          const OptionalValue<T>& v = frame.Get(scalar_slot);
-          values_inserter.Add(v.value);
-          return v.present;
-        };
-        // Callback `fn` inserts values as a side-effect while setting presence
-        // bits.
-        mapping.bitmap_builder->AddForEach(input_buffers, fn);
-      }
-    }
+    CopyRows</*kConcurrent=*/false>(current_row_id_, input_buffers);
     current_row_id_ += input_buffers.size();
     return absl::OkStatus();
   }
 
+  // Not supported for non-trivial buffers (e.g. strings), because their
+  // builders can't be filled concurrently.
+  bool SupportsCopyBatchAt() const final {
+    return std::is_same_v<Buffer<T>, SimpleBuffer<T>>;
+  }
+
+  void CopyBatchAt(int64_t row_id,
+                   absl::Span<const ConstFramePtr> input_buffers) final {
+    DCHECK(SupportsCopyBatchAt());
+    CopyRows</*kConcurrent=*/true>(row_id, input_buffers);
+  }
+
   absl::Status Finalize(FramePtr arrays_frame) final {
     if (finished_) {
       return absl::FailedPreconditionError("finalize can be called only once");
@@ -226,6 +217,43 @@ class ArrayFromFramesCopier : public BatchFromFramesCopier {
     std::optional<bitmap::Builder> bitmap_builder;
   };
 
+  template <bool kConcurrent>
+  void CopyRows(int64_t row_id,
+                absl::Span<const ConstFramePtr> input_buffers) {
+    for (Mapping& mapping : mappings_) {
+      DCHECK(mapping.values_builder.has_value());
+      if (std::holds_alternative<FrameLayout::Slot<T>>(mapping.scalar_slot)) {
+        // copy from non-optional scalars into array.
+        auto scalar_slot =
+            *std::get_if<FrameLayout::Slot<T>>(&mapping.scalar_slot);
+        const ConstFramePtr* iter = input_buffers.data();
+        mapping.values_builder->SetN(
+            row_id, input_buffers.size(),
+            [&] { return (iter++)->Get(scalar_slot); });
+      } else {
+        // copy from optional scalars into array.
+        DCHECK(std::holds_alternative<FrameLayout::Slot<OptionalValue<T>>>(
+            mapping.scalar_slot));
+        DCHECK(mapping.bitmap_builder.has_value());
+        auto scalar_slot = *std::get_if<FrameLayout::Slot<OptionalValue<T>>>(
+            &mapping.scalar_slot);
+        auto values_inserter = mapping.values_builder->GetInserter(row_id);
+        auto fn = [&](ConstFramePtr frame) {
+          const OptionalValue<T>& v = frame.Get(scalar_slot);
+          values_inserter.Add(v.value);
+          return v.present;
+        };
+        // Callback `fn` inserts values as a side-effect while setting presence
+        // bits.
+        if constexpr (kConcurrent) {
+          mapping.bitmap_builder->SetForEach(row_id, input_buffers, fn);
+        } else {
+          mapping.bitmap_builder->AddForEach(input_buffers, fn);
+        }
+      }
+    }
+  }
+
   void SetArraySize(int64_t size) final {
     // Initialize builders
     for (auto& mapping : mappings_) {
@@ -0,0 +1,411 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/arrow/c_data.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/base/config.h"
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/arrow/c_data_interface.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
+
+namespace arolla {
+namespace {
+
+#ifdef ABSL_IS_LITTLE_ENDIAN
+// Arolla bitmap words have the same memory layout as Arrow bitmaps.
+constexpr bool kIsLittleEndian = true;
+#else
+constexpr bool kIsLittleEndian = false;
+#endif
+
+template <typename T>
+constexpr bool kIsString = std::is_same_v<T, Text> || std::is_same_v<T, Bytes>;
+
+// Format of the exported arrays.
+template <typename T>
+constexpr const char* kArrowFormat = nullptr;
+template <>
+constexpr const char* kArrowFormat<int32_t> = "i";
+template <>
+constexpr const char* kArrowFormat<int64_t> = "l";
+template <>
+constexpr const char* kArrowFormat<uint64_t> = "L";
+template <>
+constexpr const char* kArrowFormat<float> = "f";
+template <>
+constexpr const char* kArrowFormat<double> = "g";
+template <>
+constexpr const char* kArrowFormat<bool> = "b";
+template <>
+constexpr const char* kArrowFormat<Text> = "U";  // large_utf8
+template <>
+constexpr const char* kArrowFormat<Bytes> = "Z";  // large_binary
+
+// Format of the strings with 32-bit offsets.
+template <typename T>
+constexpr const char* kArrowSmallStringFormat = nullptr;
+template <>
+constexpr const char* kArrowSmallStringFormat<Text> = "u";
+template <>
+constexpr const char* kArrowSmallStringFormat<Bytes> = "z";
+
+// Arrow requires non-null pointers for buffers, even empty ones.
+constexpr int64_t kEmptyBuffer = 0;
+
+bool GetArrowBit(const uint8_t* bits, int64_t i) {
+  return (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+// Keeps the exported data alive until the consumer releases the array.
+struct ExportedArrayData {
+  std::vector<std::shared_ptr<const void>> holders;
+  const void* buffers[3] = {nullptr, nullptr, nullptr};
+};
+
+void ReleaseExportedArray(ArrowArray* array) {
+  delete static_cast<ExportedArrayData*>(array->private_data);
+  array->release = nullptr;
+}
+
+void ReleaseExportedSchema(ArrowSchema* schema) { schema->release = nullptr; }
+
+// Returns the validity buffer of the array, that stores the presence of the
+// element `i` in the bit `i`. Arrow applies ArrowArray::offset to all the
+// buffers, so a non-zero bitmap_bit_offset can not be exported as is: the
+// values buffer would have to start before its allocation.
+template <typename T>
+const void* ExportBitmap(const DenseArray<T>& array, ExportedArrayData& data) {
+  if (kIsLittleEndian && array.bitmap_bit_offset == 0) {
+    return array.bitmap.begin();
+  }
+  const int64_t byte_count = (array.size() + 7) / 8;
+  auto bytes = std::make_shared<std::vector<uint8_t>>(byte_count);
+  for (int64_t i = 0; i < byte_count; ++i) {
+    bitmap::Word word = bitmap::GetWordWithOffset(
+        array.bitmap, i / sizeof(bitmap::Word), array.bitmap_bit_offset);
+    (*bytes)[i] = word >> (8 * (i % sizeof(bitmap::Word)));
+  }
+  data.holders.push_back(bytes);
+  return bytes->data();
+}
+
+template <typename T>
+void ExportValues(const DenseArray<T>& array, ExportedArrayData& data) {
+  const int64_t size = array.size();
+  if constexpr (std::is_same_v<T, bool>) {
+    auto bits = std::make_shared<std::vector<uint8_t>>(
+        std::max<int64_t>((size + 7) / 8, 1));
+    for (int64_t i = 0; i < size; ++i) {
+      if (array.values[i]) {
+        (*bits)[i >> 3] |= 1 << (i & 7);
+      }
+    }
+    data.holders.push_back(bits);
+    data.buffers[1] = bits->data();
+  } else if constexpr (kIsString<T>) {
+    const StringsBuffer& values = array.values;
+    auto offsets = std::make_shared<std::vector<int64_t>>(size + 1);
+    std::vector<int64_t>& row_offsets = *offsets;
+    bool contiguous = true;
+    for (int64_t i = 1; i < size; ++i) {
+      if (values.offsets()[i].start != values.offsets()[i - 1].end) {
+        contiguous = false;
+        break;
+      }
+    }
+    if (contiguous && size > 0) {
+      const int64_t begin = values.offsets()[0].start;
+      for (int64_t i = 0; i < size; ++i) {
+        row_offsets[i] = values.offsets()[i].start - begin;
+      }
+      row_offsets[size] = values.offsets()[size - 1].end - begin;
+      data.buffers[2] =
+          values.characters().begin() + (begin - values.base_offset());
+    } else {
+      auto characters = std::make_shared<std::string>();
+      for (int64_t i = 0; i < size; ++i) {
+        row_offsets[i] = characters->size();
+        absl::string_view row = values[i];
+        characters->append(row.data(), row.size());
+      }
+      row_offsets[size] = characters->size();
+      data.holders.push_back(characters);
+      data.buffers[2] = characters->data();
+    }
+    data.holders.push_back(offsets);
+    data.buffers[1] = offsets->data();
+  } else {
+    data.buffers[1] = array.values.begin() != nullptr
+                          ? static_cast<const void*>(array.values.begin())
+                          : &kEmptyBuffer;
+  }
+}
+
+// Takes ownership of an imported array. The array is released when the last
+// copy of the pointer is destroyed.
+std::shared_ptr<const ArrowArray> TakeArrowArray(ArrowArray* array) {
+  std::shared_ptr<const ArrowArray> result(
+      new ArrowArray(*array), [](ArrowArray* array) {
+        if (array->release != nullptr) {
+          array->release(array);
+        }
+        delete array;
+      });
+  array->release = nullptr;  // Moved.
+  return result;
+}
+
+absl::Status ImportBitmap(const std::shared_ptr<const ArrowArray>& array,
+                          bitmap::Bitmap& bitmap, int& bitmap_bit_offset) {
+  const auto* bits = static_cast<const uint8_t*>(array->buffers[0]);
+  if (bits == nullptr || array->null_count == 0) {
+    return absl::OkStatus();  // All present.
+  }
+  const int64_t offset = array->offset;
+  const int64_t length = array->length;
+  const int64_t first_word = offset / bitmap::kWordBitCount;
+  const int64_t word_count =
+      bitmap::BitmapSize(offset % bitmap::kWordBitCount + length);
+  // Arrow only guarantees the bytes that contain the bits of the elements.
+  const int64_t byte_count = (offset + length + 7) / 8;
+  if (kIsLittleEndian &&
+      reinterpret_cast<uintptr_t>(bits) % alignof(bitmap::Word) == 0 &&
+      static_cast<int64_t>((first_word + word_count) * sizeof(bitmap::Word)) <=
+          byte_count) {
+    bitmap = bitmap::Bitmap(
+        array, absl::MakeConstSpan(
+                   reinterpret_cast<const bitmap::Word*>(bits) + first_word,
+                   word_count));
+    bitmap_bit_offset = offset % bitmap::kWordBitCount;
+    return absl::OkStatus();
+  }
+  bitmap::Bitmap::Builder builder(bitmap::BitmapSize(length));
+  auto words = builder.GetMutableSpan();
+  std::fill(words.begin(), words.end(), 0);
+  if (kIsLittleEndian && offset % 8 == 0) {
+    std::memcpy(words.data(), bits + offset / 8, (length + 7) / 8);
+  } else {
+    for (int64_t i = 0; i < length; ++i) {
+      if (GetArrowBit(bits, offset + i)) {
+        words[i / bitmap::kWordBitCount] |= bitmap::Word{1}
+                                            << (i % bitmap::kWordBitCount);
+      }
+    }
+  }
+  bitmap = std::move(builder).Build();
+  bitmap_bit_offset = 0;
+  return absl::OkStatus();
+}
+
+template <typename OffsetT>
+absl::StatusOr<StringsBuffer> ImportStrings(
+    const std::shared_ptr<const ArrowArray>& array) {
+  const int64_t offset = array->offset;
+  const int64_t length = array->length;
+  const auto* offsets = static_cast<const char*>(array->buffers[1]);
+  const auto* characters = static_cast<const char*>(array->buffers[2]);
+  if (length == 0) {
+    return StringsBuffer();
+  }
+  if (offsets == nullptr || characters == nullptr) {
+    return absl::InvalidArgumentError("missing buffers of a string array");
+  }
+  // The offsets are not necessarily aligned, and are converted anyway.
+  auto load_offset = [&](int64_t i) -> int64_t {
+    OffsetT result;
+    std::memcpy(&result, offsets + i * sizeof(OffsetT), sizeof(OffsetT));
+    return result;
+  };
+  const int64_t begin = load_offset(offset);
+  const int64_t end = load_offset(offset + length);
+  if (begin < 0 || end < begin) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("invalid string offsets: [%d, %d)", begin, end));
+  }
+  SimpleBuffer<StringsBuffer::Offsets>::Builder builder(length);
+  int64_t start = begin;
+  for (int64_t i = 0; i < length; ++i) {
+    int64_t next = load_offset(offset + i + 1);
+    if (next < start || next > end) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "invalid string offsets of row %d: [%d, %d)", i, start, next));
+    }
+    builder.Set(i, {start, next});
+    start = next;
+  }
+  return StringsBuffer(
+      std::move(builder).Build(),
+      SimpleBuffer<char>(array,
+                         absl::MakeConstSpan(characters + begin, end - begin)),
+      /*base_offset=*/begin);
+}
+
+template <typename T>
+absl::StatusOr<Buffer<T>> ImportValues(
+    const std::shared_ptr<const ArrowArray>& array, bool large_offsets) {
+  const int64_t offset = array->offset;
+  const int64_t length = array->length;
+  if constexpr (kIsString<T>) {
+    if (large_offsets) {
+      return ImportStrings<int64_t>(array);
+    } else {
+      return ImportStrings<int32_t>(array);
+    }
+  } else {
+    const auto* data = static_cast<const char*>(array->buffers[1]);
+    if (length == 0) {
+      return Buffer<T>();
+    }
+    if (data == nullptr) {
+      return absl::InvalidArgumentError("missing values buffer");
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      typename Buffer<bool>::Builder builder(length);
+      const auto* bits = reinterpret_cast<const uint8_t*>(data);
+      for (int64_t i = 0; i < length; ++i) {
+        builder.Set(i, GetArrowBit(bits, offset + i));
+      }
+      return std::move(builder).Build();
+    } else {
+      const char* begin = data + offset * sizeof(T);
+      if (reinterpret_cast<uintptr_t>(begin) % alignof(T) == 0) {
+        return Buffer<T>(
+            array,
+            absl::MakeConstSpan(reinterpret_cast<const T*>(begin), length));
+      }
+      typename Buffer<T>::Builder builder(length);
+      std::memcpy(builder.GetMutableSpan().data(), begin, length * sizeof(T));
+      return std::move(builder).Build();
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+absl::Status ExportToArrow(const DenseArray<T>& array, ArrowArray* out_array,
+                           ArrowSchema* out_schema) {
+  auto data = std::make_unique<ExportedArrayData>();
+  // Keeps the values and the bitmap alive.
+  data->holders.push_back(std::make_shared<DenseArray<T>>(array));
+  int64_t null_count = 0;
+  if (!array.bitmap.empty()) {
+    null_count = array.size() - array.PresentCount();
+  }
+  if (null_count > 0) {
+    data->buffers[0] = ExportBitmap(array, *data);
+  }
+  ExportValues(array, *data);
+  *out_array = ArrowArray{
+      .length = array.size(),
+      .null_count = null_count,
+      .offset = 0,
+      .n_buffers = kIsString<T> ? 3 : 2,
+      .n_children = 0,
+      .buffers = data->buffers,
+      .children = nullptr,
+      .dictionary = nullptr,
+      .release = ReleaseExportedArray,
+      .private_data = data.release(),
+  };
+  *out_schema = ArrowSchema{
+      .format = kArrowFormat<T>,
+      .name = "",
+      .metadata = nullptr,
+      .flags = ARROW_FLAG_NULLABLE,
+      .n_children = 0,
+      .children = nullptr,
+      .dictionary = nullptr,
+      .release = ReleaseExportedSchema,
+      .private_data = nullptr,
+  };
+  return absl::OkStatus();
+}
+
+template <typename T>
+absl::StatusOr<DenseArray<T>> ImportDenseArrayFromArrow(
+    ArrowArray* array, const ArrowSchema& schema) {
+  if (array == nullptr || array->release == nullptr) {
+    return absl::InvalidArgumentError("arrow array is released");
+  }
+  std::shared_ptr<const ArrowArray> imported = TakeArrowArray(array);
+  absl::string_view format =
+      schema.format != nullptr ? schema.format : absl::string_view();
+  bool large_offsets = true;
+  if constexpr (kIsString<T>) {
+    large_offsets = format != kArrowSmallStringFormat<T>;
+  }
+  if (format != kArrowFormat<T> && large_offsets) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unexpected arrow format \"%s\", expected \"%s\"",
+                        absl::CHexEscape(format), kArrowFormat<T>));
+  }
+  if (imported->n_children != 0 || imported->dictionary != nullptr) {
+    return absl::InvalidArgumentError(
+        "nested and dictionary arrays are not supported");
+  }
+  if (imported->n_buffers != (kIsString<T> ? 3 : 2)) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "unexpected number of buffers: %d", imported->n_buffers));
+  }
+  if (imported->length < 0 || imported->offset < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("invalid arrow array length %d or offset %d",
+                        imported->length, imported->offset));
+  }
+  DenseArray<T> result;
+  ASSIGN_OR_RETURN(result.values, ImportValues<T>(imported, large_offsets));
+  RETURN_IF_ERROR(
+      ImportBitmap(imported, result.bitmap, result.bitmap_bit_offset));
+  return result;
+}
+
+#define AROLLA_DEFINE_ARROW_CONVERSION(T)                                  \
+  template absl::Status ExportToArrow<T>(const DenseArray<T>&, ArrowArray*, \
+                                         ArrowSchema*);                    \
+  template absl::StatusOr<DenseArray<T>> ImportDenseArrayFromArrow<T>(     \
+      ArrowArray*, const ArrowSchema&);
+
+AROLLA_DEFINE_ARROW_CONVERSION(int32_t);
+AROLLA_DEFINE_ARROW_CONVERSION(int64_t);
+AROLLA_DEFINE_ARROW_CONVERSION(uint64_t);
+AROLLA_DEFINE_ARROW_CONVERSION(float);
+AROLLA_DEFINE_ARROW_CONVERSION(double);
+AROLLA_DEFINE_ARROW_CONVERSION(bool);
+AROLLA_DEFINE_ARROW_CONVERSION(Text);
+AROLLA_DEFINE_ARROW_CONVERSION(Bytes);
+
+#undef AROLLA_DEFINE_ARROW_CONVERSION
+
+}  // namespace arolla
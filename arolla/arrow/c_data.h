@@ -0,0 +1,111 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_ARROW_C_DATA_H_
+#define AROLLA_ARROW_C_DATA_H_
+
+// Conversion of DenseArray<T> and Array<T> from and to the Arrow C data
+// interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+// Doesn't depend on the Arrow library.
+//
+// Supported types (Arolla type: Arrow format):
+//   int32_t: "i", int64_t: "l", uint64_t: "L", float: "f", double: "g",
+//   bool: "b", Text: "u" and "U", Bytes: "z" and "Z".
+//
+// Both directions avoid copying the data when possible:
+//   - Values of fixed width types are never copied.
+//   - Presence bitmaps are not copied on little-endian platforms. The
+//     exceptions are an imported bitmap that is not aligned to 4 bytes, or
+//     whose last 32-bit word would extend past the end of the Arrow buffer,
+//     and an exported bitmap with a non-zero bitmap_bit_offset (Arrow applies
+//     the same offset to all buffers, so the bitmap is shifted instead, and
+//     arrays are always exported with offset 0).
+//   - Characters of strings are not copied. Offsets are always converted,
+//     because StringsBuffer stores a (start, end) pair per row. Texts and
+//     Bytes are exported as "U" and "Z" (64-bit offsets). If the rows of a
+//     StringsBuffer are not stored contiguously, the characters are
+//     compacted on export.
+//   - Booleans are bit-packed in Arrow and one byte per value in Arolla, so
+//     they are always copied.
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
+#include "arolla/array/array.h"
+#include "arolla/arrow/c_data_interface.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
+
+namespace arolla {
+
+// Exports `array` into `out_array` and `out_schema`. On success the caller
+// owns both structs and must call their `release` callbacks. The exported
+// array keeps the buffers of `array` alive until it is released.
+template <typename T>
+absl::Status ExportToArrow(const DenseArray<T>& array, ArrowArray* out_array,
+                           ArrowSchema* out_schema);
+
+// Array<T> is converted to the dense form before exporting.
+template <typename T>
+absl::Status ExportToArrow(const Array<T>& array, ArrowArray* out_array,
+                           ArrowSchema* out_schema);
+
+// Imports `array` of the type described by `schema`. Takes ownership of
+// `array` (even in case of an error) and marks it as released. The returned
+// DenseArray references the foreign buffers where possible, and calls the
+// original `release` callback when the last of them is destroyed. `schema` is
+// not modified and remains owned by the caller.
+template <typename T>
+absl::StatusOr<DenseArray<T>> ImportDenseArrayFromArrow(
+    ArrowArray* array, const ArrowSchema& schema);
+
+template <typename T>
+absl::StatusOr<Array<T>> ImportArrayFromArrow(ArrowArray* array,
+                                              const ArrowSchema& schema) {
+  ASSIGN_OR_RETURN(DenseArray<T> dense_array,
+                   ImportDenseArrayFromArrow<T>(array, schema));
+  return Array<T>(std::move(dense_array));
+}
+
+template <typename T>
+absl::Status ExportToArrow(const Array<T>& array, ArrowArray* out_array,
+                           ArrowSchema* out_schema) {
+  return ExportToArrow(array.ToDenseForm().dense_data(), out_array,
+                       out_schema);
+}
+
+#define AROLLA_DECLARE_ARROW_CONVERSION(T)                             \
+  extern template absl::Status ExportToArrow<T>(                       \
+      const DenseArray<T>&, ArrowArray*, ArrowSchema*);                \
+  extern template absl::StatusOr<DenseArray<T>>                        \
+  ImportDenseArrayFromArrow<T>(ArrowArray*, const ArrowSchema&);
+
+AROLLA_DECLARE_ARROW_CONVERSION(int32_t);
+AROLLA_DECLARE_ARROW_CONVERSION(int64_t);
+AROLLA_DECLARE_ARROW_CONVERSION(uint64_t);
+AROLLA_DECLARE_ARROW_CONVERSION(float);
+AROLLA_DECLARE_ARROW_CONVERSION(double);
+AROLLA_DECLARE_ARROW_CONVERSION(bool);
+AROLLA_DECLARE_ARROW_CONVERSION(Text);
+AROLLA_DECLARE_ARROW_CONVERSION(Bytes);
+
+#undef AROLLA_DECLARE_ARROW_CONVERSION
+
+}  // namespace arolla
+
+#endif  // AROLLA_ARROW_C_DATA_H_
@@ -0,0 +1,310 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/arrow/c_data.h"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/string_view.h"
+#include "arolla/array/array.h"
+#include "arolla/arrow/c_data_interface.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/util/bytes.h"
+#include "arolla/util/text.h"
+
+namespace arolla {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
+
+// An array produced by a "foreign" library, that reports its release.
+struct ForeignArrayData {
+  std::vector<const void*> buffers;
+  bool* released;
+};
+
+ArrowArray MakeForeignArray(int64_t length, int64_t offset, int64_t null_count,
+                            std::vector<const void*> buffers, bool* released) {
+  auto* data = new ForeignArrayData{std::move(buffers), released};
+  return ArrowArray{
+      .length = length,
+      .null_count = null_count,
+      .offset = offset,
+      .n_buffers = static_cast<int64_t>(data->buffers.size()),
+      .n_children = 0,
+      .buffers = data->buffers.data(),
+      .children = nullptr,
+      .dictionary = nullptr,
+      .release =
+          [](ArrowArray* array) {
+            auto* data = static_cast<ForeignArrayData*>(array->private_data);
+            *data->released = true;
+            delete data;
+            array->release = nullptr;
+          },
+      .private_data = data,
+  };
+}
+
+ArrowSchema MakeSchema(const char* format) {
+  return ArrowSchema{.format = format,
+                     .name = "",
+                     .metadata = nullptr,
+                     .flags = ARROW_FLAG_NULLABLE,
+                     .n_children = 0,
+                     .children = nullptr,
+                     .dictionary = nullptr,
+                     .release = nullptr,
+                     .private_data = nullptr};
+}
+
+TEST(ArrowCDataTest, RoundTrip) {
+  auto array = CreateDenseArray<int32_t>(
+                   {1, 2, std::nullopt, 4, 5, std::nullopt, 7, 8, 9})
+                   .Slice(3, 5);
+  ASSERT_EQ(array.bitmap_bit_offset, 3);
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "i");
+  EXPECT_EQ(arrow_array.length, 5);
+  // The bitmap is shifted, so that the values buffer can be exported as is.
+  EXPECT_EQ(arrow_array.offset, 0);
+  EXPECT_EQ(arrow_array.null_count, 1);
+  EXPECT_NE(arrow_array.buffers[0], array.bitmap.begin());
+  EXPECT_EQ(arrow_array.buffers[1], array.values.begin());
+
+  ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<int32_t>(
+                                          &arrow_array, arrow_schema));
+  EXPECT_EQ(arrow_array.release, nullptr);
+  EXPECT_THAT(imported, ElementsAre(4, 5, std::nullopt, 7, 8));
+  EXPECT_EQ(imported.values.begin(), array.values.begin());
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, BitmapOffsetWithFreshValues) {
+  // The values buffer starts at the first element, while the bitmap has an
+  // offset. Exporting the offset would make the values pointer point before
+  // the allocation.
+  DenseArray<int64_t> array{
+      .values = CreateBuffer<int64_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}),
+      .bitmap = CreateBuffer<bitmap::Word>({0b111111110101}),
+      .bitmap_bit_offset = 2};
+  ASSERT_TRUE(array.CheckBitmapMatchesValues());
+  ASSERT_THAT(array, ElementsAre(1, std::nullopt, 3, 4, 5, 6, 7, 8, 9, 10));
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(arrow_array.offset, 0);
+  EXPECT_EQ(arrow_array.null_count, 1);
+  EXPECT_EQ(arrow_array.buffers[1], array.values.begin());
+  const auto* bits = static_cast<const uint8_t*>(arrow_array.buffers[0]);
+  EXPECT_EQ(bits[0], 0b11111101);
+  EXPECT_EQ(bits[1] & 0b11, 0b11);
+
+  ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<int64_t>(
+                                          &arrow_array, arrow_schema));
+  EXPECT_THAT(imported, ElementsAre(1, std::nullopt, 3, 4, 5, 6, 7, 8, 9, 10));
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, FullArray) {
+  auto array = CreateDenseArray<double>({1.5, 2.5, 3.5});
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "g");
+  EXPECT_EQ(arrow_array.null_count, 0);
+  EXPECT_EQ(arrow_array.buffers[0], nullptr);
+  ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<double>(
+                                          &arrow_array, arrow_schema));
+  EXPECT_TRUE(imported.bitmap.empty());
+  EXPECT_THAT(imported, ElementsAre(1.5, 2.5, 3.5));
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, ExportedArrayOwnsBuffers) {
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  {
+    auto array = CreateDenseArray<int64_t>({1, std::nullopt, 3});
+    ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  }
+  const auto* values = static_cast<const int64_t*>(arrow_array.buffers[1]);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[2], 3);
+  arrow_array.release(&arrow_array);
+  EXPECT_EQ(arrow_array.release, nullptr);
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, Bool) {
+  auto array = CreateDenseArray<bool>(
+      {true, false, std::nullopt, true, true, false, false, true, true, false});
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "b");
+  const auto* bits = static_cast<const uint8_t*>(arrow_array.buffers[1]);
+  EXPECT_EQ(bits[0], 0b10011001);
+  ASSERT_OK_AND_ASSIGN(
+      auto imported,
+      ImportDenseArrayFromArrow<bool>(&arrow_array, arrow_schema));
+  EXPECT_THAT(imported, ElementsAreArray(array));
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, Strings) {
+  auto array = CreateDenseArray<Text>(
+      {Text("abc"), std::nullopt, Text(""), Text("de"), Text("fgh")});
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array.Slice(1, 4), &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "U");
+  EXPECT_EQ(arrow_array.n_buffers, 3);
+  ASSERT_OK_AND_ASSIGN(
+      auto imported,
+      ImportDenseArrayFromArrow<Text>(&arrow_array, arrow_schema));
+  EXPECT_THAT(imported, ElementsAre(std::nullopt, "", "de", "fgh"));
+  // The characters are not copied.
+  EXPECT_EQ(imported[3].value.data(), array[4].value.data());
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, NonContiguousStrings) {
+  // The rows are stored in the reverse order.
+  DenseArray<Bytes> array{StringsBuffer(
+      CreateBuffer<StringsBuffer::Offsets>({{3, 5}, {1, 3}, {0, 1}}),
+      CreateBuffer<char>({'a', 'b', 'c', 'd', 'e'}))};
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "Z");
+  ASSERT_OK_AND_ASSIGN(
+      auto imported,
+      ImportDenseArrayFromArrow<Bytes>(&arrow_array, arrow_schema));
+  EXPECT_THAT(imported, ElementsAre("de", "bc", "a"));
+  arrow_schema.release(&arrow_schema);
+}
+
+TEST(ArrowCDataTest, ImportForeignArray) {
+  alignas(8) int32_t values[32];
+  for (int i = 0; i < 32; ++i) values[i] = i;
+  // Bits 4 and 7 are not set. The bitmap has a whole word for rows [3, 32).
+  alignas(8) uint8_t validity[] = {0b01101111, 0xff, 0xff, 0xff};
+  bool released = false;
+  ArrowArray arrow_array =
+      MakeForeignArray(/*length=*/29, /*offset=*/3, /*null_count=*/2,
+                       {validity, values}, &released);
+  ArrowSchema arrow_schema = MakeSchema("i");
+  {
+    ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<int32_t>(
+                                            &arrow_array, arrow_schema));
+    EXPECT_EQ(arrow_array.release, nullptr);
+    ASSERT_EQ(imported.size(), 29);
+    EXPECT_THAT(imported.Slice(0, 6),
+                ElementsAre(3, std::nullopt, 5, 6, std::nullopt, 8));
+    EXPECT_EQ(imported.PresentCount(), 27);
+    EXPECT_EQ(imported.values.begin(), values + 3);
+    // The bitmap is shared as well.
+    EXPECT_EQ(imported.bitmap_bit_offset, 3);
+    EXPECT_EQ(static_cast<const void*>(imported.bitmap.begin()), validity);
+    EXPECT_FALSE(released);
+  }
+  EXPECT_TRUE(released);
+}
+
+TEST(ArrowCDataTest, ImportBitmapWithShortBuffer) {
+  alignas(8) int32_t values[] = {0, 1, 2};
+  // Only one byte of the bitmap is guaranteed, so it can't be read as a word.
+  alignas(8) uint8_t validity[] = {0b101};
+  bool released = false;
+  ArrowArray arrow_array =
+      MakeForeignArray(/*length=*/3, /*offset=*/0, /*null_count=*/1,
+                       {validity, values}, &released);
+  ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<int32_t>(
+                                          &arrow_array, MakeSchema("i")));
+  EXPECT_THAT(imported, ElementsAre(0, std::nullopt, 2));
+  EXPECT_NE(static_cast<const void*>(imported.bitmap.begin()), validity);
+}
+
+TEST(ArrowCDataTest, ImportSmallStrings) {
+  int32_t offsets[] = {0, 2, 2, 5};
+  const char characters[] = "abcde";
+  bool released = false;
+  ArrowArray arrow_array =
+      MakeForeignArray(/*length=*/2, /*offset=*/1, /*null_count=*/0,
+                       {nullptr, offsets, characters}, &released);
+  ASSERT_OK_AND_ASSIGN(auto imported, ImportDenseArrayFromArrow<Text>(
+                                          &arrow_array, MakeSchema("u")));
+  EXPECT_THAT(imported, ElementsAre("", "cde"));
+  EXPECT_EQ(imported[1].value.data(), characters + 2);
+}
+
+TEST(ArrowCDataTest, ImportErrors) {
+  int64_t values[] = {1, 2};
+  bool released = false;
+  ArrowArray arrow_array = MakeForeignArray(
+      /*length=*/2, /*offset=*/0, /*null_count=*/0, {nullptr, values},
+      &released);
+  EXPECT_THAT(
+      ImportDenseArrayFromArrow<int32_t>(&arrow_array, MakeSchema("l")),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("unexpected arrow format \"l\", expected \"i\"")));
+  // The array is released even in case of an error.
+  EXPECT_TRUE(released);
+  EXPECT_THAT(
+      ImportDenseArrayFromArrow<int64_t>(&arrow_array, MakeSchema("l")),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("released")));
+
+  int32_t bad_offsets[] = {0, 3, 2};
+  arrow_array = MakeForeignArray(/*length=*/2, /*offset=*/0,
+                                 /*null_count=*/0,
+                                 {nullptr, bad_offsets, "abc"}, &released);
+  EXPECT_THAT(ImportDenseArrayFromArrow<Bytes>(&arrow_array, MakeSchema("z")),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid string offsets")));
+}
+
+TEST(ArrowCDataTest, Array) {
+  auto array = CreateArray<float>({std::nullopt, 1.0f, std::nullopt, 2.0f})
+                   .ToSparseForm();
+  ASSERT_TRUE(array.IsSparseForm());
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  ASSERT_OK(ExportToArrow(array, &arrow_array, &arrow_schema));
+  EXPECT_EQ(absl::string_view(arrow_schema.format), "f");
+  ASSERT_OK_AND_ASSIGN(
+      auto imported, ImportArrayFromArrow<float>(&arrow_array, arrow_schema));
+  EXPECT_TRUE(imported.IsDenseForm());
+  EXPECT_THAT(imported, ElementsAre(std::nullopt, 1.0f, std::nullopt, 2.0f));
+  arrow_schema.release(&arrow_schema);
+}
+
+}  // namespace
+}  // namespace arolla
@@ -16,11 +16,13 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/no_destructor.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
@@ -31,19 +33,25 @@
 #include "absl/types/span.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
+#include "arolla/decision_forest/batched_evaluation/oblivious_forest_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/array_like/frame_iter.h"
+#include "arolla/qtype/base_types.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/util/meta.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
@@ -84,6 +92,85 @@ absl::StatusOr<TypedValue> AddFullFloatArrays(TypedRef a, TypedRef b) {
   }
 }
 
+// Concatenates full float arrays (all of the same type).
+absl::StatusOr<TypedValue> ConcatFullFloatArrays(
+    absl::Span<const TypedRef> parts, int64_t row_count,
+    RawBufferFactory* factory) {
+  DCHECK(!parts.empty());
+  if (factory == nullptr) {
+    factory = GetHeapBufferFactory();
+  }
+  QTypePtr qtype = parts[0].GetType();
+  Buffer<float>::Builder bldr(row_count, factory);
+  auto sr = bldr.GetMutableSpan();
+  int64_t offset = 0;
+  for (const TypedRef& part : parts) {
+    absl::Span<const float> values;
+    if (qtype == GetDenseArrayQType<float>()) {
+      const auto& v = part.UnsafeAs<DenseArray<float>>();
+      DCHECK(v.IsFull());
+      values = v.values.span();
+    } else if (qtype == GetArrayQType<float>()) {
+      const auto& v = part.UnsafeAs<Array<float>>();
+      DCHECK(v.IsFullForm());
+      values = v.dense_data().values.span();
+    } else {
+      return absl::InternalError(
+          "Invalid type in BatchedForestEvaluator/Concat");
+    }
+    DCHECK_LE(offset + values.size(), row_count);
+    std::copy(values.begin(), values.end(), sr.begin() + offset);
+    offset += values.size();
+  }
+  DCHECK_EQ(offset, row_count);
+  if (qtype == GetDenseArrayQType<float>()) {
+    return TypedValue::FromValue(DenseArray<float>{std::move(bldr).Build()});
+  } else {
+    return TypedValue::FromValue(Array<float>{std::move(bldr).Build()});
+  }
+}
+
+// Returns rows [offset, offset + count) of a DenseArray or an Array. The result
+// shares buffers with the original array.
+absl::StatusOr<TypedValue> SliceArray(TypedRef array, int64_t offset,
+                                      int64_t count) {
+  std::optional<TypedValue> result;
+  meta::foreach_type<ScalarTypes>([&](auto meta_type) {
+    using T = typename decltype(meta_type)::type;
+    if (result.has_value()) {
+      return;
+    }
+    if (array.GetType() == GetDenseArrayQType<T>()) {
+      result = TypedValue::FromValue(
+          array.UnsafeAs<DenseArray<T>>().Slice(offset, count));
+    } else if (array.GetType() == GetArrayQType<T>()) {
+      result = TypedValue::FromValue(
+          array.UnsafeAs<Array<T>>().Slice(offset, count));
+    }
+  });
+  if (!result.has_value()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("unsupported input type in BatchedForestEvaluator: %s",
+                        array.GetType()->name()));
+  }
+  return *std::move(result);
+}
+
+bool IsColumnarEvalApplicable(
+    const BatchedForestEvaluator::CompilationParams& params,
+    const DecisionForest& decision_forest) {
+  const int64_t max_splits = params.max_splits_per_tree_for_columnar_eval;
+  if (max_splits <= 0) {
+    return false;
+  }
+  for (const auto& tree : decision_forest.GetTrees()) {
+    if (tree.split_nodes.size() > max_splits) {
+      return false;
+    }
+  }
+  return ColumnarForestEvaluator::IsSupported(decision_forest);
+}
+
 absl::StatusOr<std::vector<ForestEvaluator>> CreatePointwiseEvaluators(
     const BatchedForestEvaluator::CompilationParams& params,
     const DecisionForest& decision_forest, const std::vector<TypedSlot>& inputs,
@@ -176,14 +263,80 @@ BatchedForestEvaluator::Compile(const DecisionForest& decision_forest,
 
   auto pointwise_layout = std::move(bldr).Build();
 
+  // A precompiled evaluator replaces both the pointwise and the columnar
+  // compilation.
+  std::optional<ColumnarForestEvaluator> precompiled;
+  if (params.max_splits_per_tree_for_columnar_eval > 0) {
+    precompiled = ColumnarForestEvaluator::FindPrecompiled(
+        ColumnarForestEvaluator::SourceFingerprint(decision_forest, groups));
+  }
+
   // Create evaluator
-  ASSIGN_OR_RETURN(
-      std::vector<ForestEvaluator> pointwise_evaluators,
-      CreatePointwiseEvaluators(params, decision_forest, input_pointwise_slots,
-                                pointwise_outputs));
-  return absl::WrapUnique(new BatchedForestEvaluator(
+  std::vector<ForestEvaluator> pointwise_evaluators;
+  if (!precompiled.has_value()) {
+    ASSIGN_OR_RETURN(pointwise_evaluators,
+                     CreatePointwiseEvaluators(params, decision_forest,
+                                               input_pointwise_slots,
+                                               pointwise_outputs));
+  }
+  auto res = absl::WrapUnique(new BatchedForestEvaluator(
       std::move(pointwise_layout), std::move(input_slots_mapping),
       std::move(output_pointwise_slots), std::move(pointwise_evaluators)));
+
+  if (precompiled.has_value()) {
+    res->columnar_evaluator_ = *std::move(precompiled);
+    res->InitColumnarInputPositions(res->columnar_evaluator_->input_ids());
+  } else if (params.enable_oblivious_eval &&
+             ObliviousForestEvaluator::IsSupported(decision_forest)) {
+    ASSIGN_OR_RETURN(
+        res->oblivious_evaluator_,
+        ObliviousForestEvaluator::Compile(decision_forest, groups));
+    res->InitColumnarInputPositions(res->oblivious_evaluator_->input_ids());
+    res->min_rows_for_columnar_eval_ = params.min_rows_for_columnar_eval;
+  } else if (IsColumnarEvalApplicable(params, decision_forest)) {
+    ASSIGN_OR_RETURN(
+        res->columnar_evaluator_,
+        ColumnarForestEvaluator::Compile(decision_forest, groups));
+    res->InitColumnarInputPositions(res->columnar_evaluator_->input_ids());
+    res->min_rows_for_columnar_eval_ = params.min_rows_for_columnar_eval;
+  }
+  return res;
+}
+
+std::unique_ptr<BatchedForestEvaluator> BatchedForestEvaluator::FromColumnar(
+    ColumnarForestEvaluator evaluator) {
+  // Split conditions of ColumnarForestEvaluator are IntervalSplitConditions,
+  // so all inputs are OPTIONAL_FLOAT32.
+  FrameLayout::Builder bldr;
+  std::vector<SlotMapping> input_slots_mapping;
+  for (int input_id : evaluator.input_ids()) {
+    input_slots_mapping.push_back(
+        {input_id, TypedSlot::FromSlot(bldr.AddSlot<OptionalValue<float>>())});
+  }
+  std::vector<TypedSlot> output_pointwise_slots;
+  output_pointwise_slots.reserve(evaluator.group_count());
+  for (int i = 0; i < evaluator.group_count(); ++i) {
+    output_pointwise_slots.push_back(
+        TypedSlot::FromSlot(bldr.AddSlot<float>()));
+  }
+  auto res = absl::WrapUnique(new BatchedForestEvaluator(
+      std::move(bldr).Build(), std::move(input_slots_mapping),
+      std::move(output_pointwise_slots), /*pointwise_evaluators=*/{}));
+  res->columnar_evaluator_ = std::move(evaluator);
+  res->InitColumnarInputPositions(res->columnar_evaluator_->input_ids());
+  return res;
+}
+
+void BatchedForestEvaluator::InitColumnarInputPositions(
+    absl::Span<const int> input_ids) {
+  for (int input_id : input_ids) {
+    auto it = absl::c_find_if(input_mapping_, [&](const SlotMapping& m) {
+      return m.input_index == input_id;
+    });
+    DCHECK(it != input_mapping_.end());
+    columnar_input_positions_.push_back(
+        std::distance(input_mapping_.begin(), it));
+  }
 }
 
 absl::Status BatchedForestEvaluator::GetInputsFromSlots(
@@ -205,10 +358,6 @@ absl::Status BatchedForestEvaluator::EvalBatch(
     absl::Span<const TypedSlot> input_slots,
     absl::Span<const TypedSlot> output_slots, FramePtr frame,
     RawBufferFactory* buffer_factory, std::optional<int64_t> row_count) const {
-  // TODO: Try also the non-pointwise algorithm:
-  //     Iterate through split nodes in the outer loop, and iterate through rows
-  //     in the inner loop.
-
   std::vector<TypedRef> input_arrays;
   input_arrays.reserve(input_mapping_.size());
   RETURN_IF_ERROR(GetInputsFromSlots(input_slots, frame, &input_arrays));
@@ -223,16 +372,34 @@ absl::Status BatchedForestEvaluator::EvalBatch(
   }
 
   int thread_count = 1;
-
-  // TODO: The parallel implementation work slower than single
-  // threaded one (it wasn't this way when the algorithm was implemented,
-  // probably became slower after some infrastructure changes), so we disable it
-  // for now. Need to implement a different algorithm.
-  /*if (*threading_ && row_count.has_value()) {
-    thread_count = std::clamp<int>(
+  if (*threading_ && row_count.has_value()) {
+    thread_count = std::clamp<int64_t>(
         (*row_count + min_rows_per_thread_ - 1) / min_rows_per_thread_, 1,
         (*threading_)->GetRecommendedThreadCount());
-  }*/
+  }
+
+  if (thread_count > 1) {
+    return EvalBatchInParallel(input_arrays, output_slots, frame,
+                               buffer_factory, *row_count, thread_count);
+  } else {
+    return EvalBatchInCurrentThread(input_arrays, output_slots, frame,
+                                    buffer_factory, row_count);
+  }
+}
+
+absl::Status BatchedForestEvaluator::EvalBatchInCurrentThread(
+    absl::Span<const TypedRef> input_arrays,
+    absl::Span<const TypedSlot> output_slots, FramePtr frame,
+    RawBufferFactory* buffer_factory, std::optional<int64_t> row_count) const {
+  if ((columnar_evaluator_.has_value() || oblivious_evaluator_.has_value()) &&
+      row_count.has_value() && *row_count >= min_rows_for_columnar_eval_) {
+    return EvalColumnar(input_arrays, output_slots, frame, buffer_factory,
+                        *row_count);
+  }
+  if (pointwise_evaluators_.empty()) {
+    return absl::InvalidArgumentError(
+        "row_count must be specified for a forest without inputs");
+  }
 
   // Runs given evaluator and stores the results to `frame`.
   auto run_evaluator = [&](const ForestEvaluator& eval) -> absl::Status {
@@ -242,15 +409,9 @@ absl::Status BatchedForestEvaluator::EvalBatch(
             input_arrays, {input_pointwise_slots_.data(), input_arrays.size()},
             output_slots, output_pointwise_slots_, &pointwise_layout_,
             FrameIterator::Options{.row_count = row_count,
-                                   .frame_buffer_count = 64 * thread_count,
                                    .buffer_factory = buffer_factory}));
-
-    if (thread_count > 1) {
-      frame_iterator.ForEachFrame([&eval](FramePtr f) { eval.Eval(f, f); },
-                                  **threading_, thread_count);
-    } else {
-      frame_iterator.ForEachFrame([&eval](FramePtr f) { eval.Eval(f, f); });
-    }
+    frame_iterator.ForEachFrameBatch(
+        [&eval](absl::Span<const FramePtr> frames) { eval.EvalBatch(frames); });
     return frame_iterator.StoreOutput(frame);
   };
 
@@ -285,4 +446,167 @@ absl::Status BatchedForestEvaluator::EvalBatch(
   }
 }
 
+absl::Status BatchedForestEvaluator::EvalColumnar(
+    absl::Span<const TypedRef> input_arrays,
+    absl::Span<const TypedSlot> output_slots, FramePtr frame,
+    RawBufferFactory* buffer_factory, int64_t row_count) const {
+  if (output_slots.size() != output_pointwise_slots_.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "incorrect number of outputs: %d expected, %d found",
+        output_pointwise_slots_.size(), output_slots.size()));
+  }
+  for (const TypedSlot& slot : output_slots) {
+    if (slot.GetType() != GetDenseArrayQType<float>() &&
+        slot.GetType() != GetArrayQType<float>()) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("unsupported output type in BatchedForestEvaluator: "
+                          "%s, expected DENSE_ARRAY_FLOAT32 or ARRAY_FLOAT32",
+                          slot.GetType()->name()));
+    }
+  }
+  if (buffer_factory == nullptr) {
+    buffer_factory = GetHeapBufferFactory();
+  }
+
+  std::vector<DenseArray<float>> inputs;
+  inputs.reserve(columnar_input_positions_.size());
+  for (int pos : columnar_input_positions_) {
+    TypedRef array = input_arrays[pos];
+    if (array.GetType() == GetDenseArrayQType<float>()) {
+      inputs.push_back(array.UnsafeAs<DenseArray<float>>());
+    } else if (array.GetType() == GetArrayQType<float>()) {
+      inputs.push_back(
+          array.UnsafeAs<Array<float>>().ToDenseForm().dense_data());
+    } else {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "unsupported input type in BatchedForestEvaluator: %s, expected "
+          "DENSE_ARRAY_FLOAT32 or ARRAY_FLOAT32",
+          array.GetType()->name()));
+    }
+    if (inputs.back().size() != row_count) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("input array has incorrect size: %d vs %d",
+                          inputs.back().size(), row_count));
+    }
+  }
+  std::vector<const DenseArray<float>*> input_ptrs;
+  input_ptrs.reserve(inputs.size());
+  for (const DenseArray<float>& input : inputs) {
+    input_ptrs.push_back(&input);
+  }
+
+  std::vector<Buffer<float>::Builder> builders;
+  std::vector<absl::Span<float>> outputs;
+  builders.reserve(output_slots.size());
+  outputs.reserve(output_slots.size());
+  for (int i = 0; i < output_slots.size(); ++i) {
+    builders.emplace_back(row_count, buffer_factory);
+    outputs.push_back(builders.back().GetMutableSpan());
+  }
+
+  if (oblivious_evaluator_.has_value()) {
+    oblivious_evaluator_->Eval(input_ptrs, row_count, outputs);
+  } else {
+    columnar_evaluator_->Eval(input_ptrs, row_count, outputs);
+  }
+
+  for (int i = 0; i < output_slots.size(); ++i) {
+    Buffer<float> values = std::move(builders[i]).Build();
+    if (output_slots[i].GetType() == GetDenseArrayQType<float>()) {
+      frame.Set(output_slots[i].UnsafeToSlot<DenseArray<float>>(),
+                DenseArray<float>{std::move(values)});
+    } else {
+      frame.Set(output_slots[i].UnsafeToSlot<Array<float>>(),
+                Array<float>{std::move(values)});
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BatchedForestEvaluator::EvalBatchInParallel(
+    absl::Span<const TypedRef> input_arrays,
+    absl::Span<const TypedSlot> output_slots, FramePtr frame,
+    RawBufferFactory* buffer_factory, int64_t row_count,
+    int thread_count) const {
+  DCHECK_GT(thread_count, 1);
+  // Every shard stores its results into its own frame. The outputs have the
+  // same types as the final outputs.
+  FrameLayout::Builder shard_layout_bldr;
+  std::vector<TypedSlot> shard_output_slots;
+  shard_output_slots.reserve(output_slots.size());
+  for (const TypedSlot& slot : output_slots) {
+    shard_output_slots.push_back(AddSlot(slot.GetType(), &shard_layout_bldr));
+  }
+  FrameLayout shard_layout = std::move(shard_layout_bldr).Build();
+
+  struct Shard {
+    int64_t offset;
+    int64_t row_count;
+    MemoryAllocation outputs;
+    absl::Status status;
+  };
+  std::vector<Shard> shards;
+  shards.reserve(thread_count);
+  const int64_t rows_per_shard = row_count / thread_count;
+  const int64_t extra_rows = row_count % thread_count;
+  int64_t offset = 0;
+  for (int i = 0; i < thread_count; ++i) {
+    int64_t shard_size = rows_per_shard + (i < extra_rows ? 1 : 0);
+    shards.push_back({.offset = offset,
+                      .row_count = shard_size,
+                      .outputs = MemoryAllocation(&shard_layout)});
+    offset += shard_size;
+  }
+  DCHECK_EQ(offset, row_count);
+
+  auto eval_shard = [&](Shard& shard) -> absl::Status {
+    std::vector<TypedValue> sliced_arrays;
+    sliced_arrays.reserve(input_arrays.size());
+    for (const TypedRef& array : input_arrays) {
+      ASSIGN_OR_RETURN(TypedValue sliced,
+                       SliceArray(array, shard.offset, shard.row_count));
+      sliced_arrays.push_back(std::move(sliced));
+    }
+    std::vector<TypedRef> sliced_refs;
+    sliced_refs.reserve(sliced_arrays.size());
+    for (const TypedValue& array : sliced_arrays) {
+      sliced_refs.push_back(array.AsRef());
+    }
+    // `buffer_factory` is not necessarily thread-safe (e.g. an arena), so the
+    // intermediate results are allocated on heap.
+    return EvalBatchInCurrentThread(sliced_refs, shard_output_slots,
+                                    shard.outputs.frame(),
+                                    GetHeapBufferFactory(), shard.row_count);
+  };
+
+  ThreadingInterface& threading = **threading_;
+  threading.WithThreading([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    join_fns.reserve(thread_count - 1);
+    for (int i = 1; i < thread_count; ++i) {
+      Shard& shard = shards[i];
+      join_fns.push_back(threading.StartThread(
+          [&eval_shard, &shard] { shard.status = eval_shard(shard); }));
+    }
+    shards[0].status = eval_shard(shards[0]);
+    for (auto& join : join_fns) join();
+  });
+  for (const Shard& shard : shards) {
+    RETURN_IF_ERROR(shard.status);
+  }
+
+  for (int i = 0; i < output_slots.size(); ++i) {
+    std::vector<TypedRef> parts;
+    parts.reserve(shards.size());
+    for (Shard& shard : shards) {
+      parts.push_back(
+          TypedRef::FromSlot(shard_output_slots[i], shard.outputs.frame()));
+    }
+    ASSIGN_OR_RETURN(TypedValue result,
+                     ConcatFullFloatArrays(parts, row_count, buffer_factory));
+    RETURN_IF_ERROR(result.CopyToSlot(output_slots[i], frame));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace arolla
@@ -26,6 +26,8 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
+#include "arolla/decision_forest/batched_evaluation/oblivious_forest_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/pointwise_evaluation/forest_evaluator.h"
 #include "arolla/memory/frame.h"
@@ -49,6 +51,23 @@ class BatchedForestEvaluator {
     // evaluators. Important for performance if the forest doesn't fit into
     // processor cache in one piece.
     int64_t optimal_splits_per_evaluator = 500000;
+
+    // If all split conditions are supported by ColumnarForestEvaluator and
+    // every tree has at most this number of split nodes, then big batches are
+    // evaluated by ColumnarForestEvaluator (split nodes in the outer loop, rows
+    // in the inner loop). 0 disables the columnar algorithm. If an evaluator
+    // is registered with ColumnarForestEvaluator::RegisterPrecompiled for the
+    // same forest and groups, it is used for batches of all sizes, and nothing
+    // is compiled (this has priority over the oblivious algorithm).
+    int64_t max_splits_per_tree_for_columnar_eval = 32;
+
+    // If all trees are oblivious and supported by ObliviousForestEvaluator,
+    // then big batches are evaluated by ObliviousForestEvaluator (has priority
+    // over ColumnarForestEvaluator).
+    bool enable_oblivious_eval = true;
+
+    // Batches with fewer rows are always evaluated pointwise.
+    int64_t min_rows_for_columnar_eval = 64;
   };
 
   struct SlotMapping {
@@ -65,6 +84,13 @@ class BatchedForestEvaluator {
       absl::Span<const TreeFilter> groups = {{}},
       const CompilationParams& params = CompilationParams::Default());
 
+  // Creates BatchedForestEvaluator that evaluates batches of all sizes with
+  // the given evaluator, e.g. loaded by
+  // ColumnarForestEvaluator::FromFlatBufferFile. Doesn't require the
+  // DecisionForest. The outputs correspond to the groups of the evaluator.
+  static std::unique_ptr<BatchedForestEvaluator> FromColumnar(
+      ColumnarForestEvaluator evaluator);
+
   // Evaluates decision forest on a set of arrays.
   // All input_slots should store arrays of the same size.
   // Types of input_slots should correspond to required types of the decision.
@@ -76,6 +102,9 @@ class BatchedForestEvaluator {
                          RawBufferFactory* = GetHeapBufferFactory(),
                          std::optional<int64_t> row_count = {}) const;
 
+  // Enables multithreaded evaluation of big batches. Rows are split into
+  // disjoint ranges of at least `min_rows_per_thread` rows, and every range is
+  // evaluated independently in its own thread. Pass nullptr to disable.
   static void SetThreading(std::unique_ptr<ThreadingInterface> threading,
                            int64_t min_rows_per_thread = 128) {
     *threading_ = std::move(threading);
@@ -102,17 +131,52 @@ class BatchedForestEvaluator {
     }
   }
 
+  // Sets columnar_input_positions_ for the inputs of the columnar (or
+  // oblivious) evaluator.
+  void InitColumnarInputPositions(absl::Span<const int> input_ids);
+
   // Gets values from input_slots and remaps it according to input_mapping_.
   absl::Status GetInputsFromSlots(absl::Span<const TypedSlot> input_slots,
                                   ConstFramePtr frame,
                                   std::vector<TypedRef>* input_arrays) const;
 
+  // Evaluates the forest on input_arrays (already remapped according to
+  // input_mapping_) in the current thread.
+  absl::Status EvalBatchInCurrentThread(
+      absl::Span<const TypedRef> input_arrays,
+      absl::Span<const TypedSlot> output_slots, FramePtr frame,
+      RawBufferFactory* buffer_factory, std::optional<int64_t> row_count) const;
+
+  // Evaluates the forest using oblivious_evaluator_ or columnar_evaluator_.
+  absl::Status EvalColumnar(absl::Span<const TypedRef> input_arrays,
+                            absl::Span<const TypedSlot> output_slots,
+                            FramePtr frame, RawBufferFactory* buffer_factory,
+                            int64_t row_count) const;
+
+  // Splits rows into `thread_count` disjoint ranges and evaluates every range
+  // in a separate thread with its own FrameIterator. Threads don't synchronize
+  // until all of them are finished, then the results are concatenated.
+  absl::Status EvalBatchInParallel(absl::Span<const TypedRef> input_arrays,
+                                   absl::Span<const TypedSlot> output_slots,
+                                   FramePtr frame,
+                                   RawBufferFactory* buffer_factory,
+                                   int64_t row_count, int thread_count) const;
+
   FrameLayout pointwise_layout_;
   std::vector<SlotMapping> input_mapping_;
   std::vector<TypedSlot> input_pointwise_slots_;
   std::vector<TypedSlot> output_pointwise_slots_;
   int input_count_;
   std::vector<ForestEvaluator> pointwise_evaluators_;
+
+  // At most one of columnar_evaluator_ and oblivious_evaluator_ is set.
+  std::optional<ColumnarForestEvaluator> columnar_evaluator_;
+  std::optional<ObliviousForestEvaluator> oblivious_evaluator_;
+  // Positions in input_mapping_ of input_ids() of the evaluator above.
+  std::vector<int> columnar_input_positions_;
+  // Smaller batches are evaluated pointwise. 0 if there are no
+  // pointwise_evaluators_.
+  int64_t min_rows_for_columnar_eval_ = 0;
 };
 
 }  // namespace arolla
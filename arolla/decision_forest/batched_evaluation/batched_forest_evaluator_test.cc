@@ -16,19 +16,23 @@
 
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/numeric/int128.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "arolla/array/array.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/split_conditions/interval_split_condition.h"
 #include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
@@ -37,7 +41,10 @@
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
@@ -260,5 +267,236 @@ TEST(BatchedForestEvaluator, SplitCountPerEvaluator) {
   }
 }
 
+TEST(BatchedForestEvaluator, MultithreadedEvaluation) {
+  constexpr int64_t num_trees = 50;
+  constexpr int64_t batch_size = 1001;
+
+  absl::BitGen rnd;
+  auto forest = CreateRandomForest(&rnd, /*num_features=*/10,
+                                   /*interactions=*/true, /*min_num_splits=*/1,
+                                   /*max_num_splits=*/15, num_trees);
+  ASSERT_OK_AND_ASSIGN(auto evaluator,
+                       BatchedForestEvaluator::Compile(*forest));
+  ASSERT_OK_AND_ASSIGN(auto subdivided_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()},
+                           {.optimal_splits_per_evaluator = 100}));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto dense_array_output_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto array_output_slot = layout_builder.AddSlot<Array<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd));
+  }
+
+  ASSERT_OK(evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(dense_array_output_slot)}, frame));
+  DenseArray<float> expected = frame.Get(dense_array_output_slot);
+  ASSERT_EQ(expected.size(), batch_size);
+
+  BatchedForestEvaluator::SetThreading(std::make_unique<StdThreading>(4),
+                                       /*min_rows_per_thread=*/100);
+  for (const auto* eval : {evaluator.get(), subdivided_evaluator.get()}) {
+    frame.Set(dense_array_output_slot, DenseArray<float>());
+    frame.Set(array_output_slot, Array<float>());
+    ASSERT_OK(eval->EvalBatch(slots,
+                              {TypedSlot::FromSlot(dense_array_output_slot),
+                               TypedSlot::FromSlot(array_output_slot)},
+                              frame));
+    const DenseArray<float>& dense_array = frame.Get(dense_array_output_slot);
+    const Array<float>& array = frame.Get(array_output_slot);
+    ASSERT_EQ(dense_array.size(), batch_size);
+    ASSERT_EQ(array.size(), batch_size);
+    for (int64_t i = 0; i < batch_size; ++i) {
+      EXPECT_FLOAT_EQ(dense_array[i].value, expected[i].value);
+      EXPECT_FLOAT_EQ(array[i].value, expected[i].value);
+    }
+  }
+  BatchedForestEvaluator::SetThreading(nullptr);
+}
+
+TEST(BatchedForestEvaluator, ColumnarEvaluation) {
+  constexpr int64_t batch_size = 1000;
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/10, /*interactions=*/true, /*min_num_splits=*/1,
+      /*max_num_splits=*/31, /*num_trees=*/50);
+  BatchedForestEvaluator::CompilationParams pointwise_params{
+      .max_splits_per_tree_for_columnar_eval = 0};
+  BatchedForestEvaluator::CompilationParams columnar_params{
+      .max_splits_per_tree_for_columnar_eval = 31,
+      .min_rows_for_columnar_eval = 1};
+  ASSERT_OK_AND_ASSIGN(auto pointwise_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()}, pointwise_params));
+  ASSERT_OK_AND_ASSIGN(auto columnar_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()}, columnar_params));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto dense_array_output_slot = layout_builder.AddSlot<DenseArray<float>>();
+  auto array_output_slot = layout_builder.AddSlot<Array<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd,
+                                        /*missed_prob=*/0.2));
+  }
+
+  ASSERT_OK(pointwise_evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(dense_array_output_slot)}, frame));
+  DenseArray<float> expected = frame.Get(dense_array_output_slot);
+  ASSERT_EQ(expected.size(), batch_size);
+
+  frame.Set(dense_array_output_slot, DenseArray<float>());
+  ASSERT_OK(columnar_evaluator->EvalBatch(
+      slots,
+      {TypedSlot::FromSlot(dense_array_output_slot),
+       TypedSlot::FromSlot(array_output_slot)},
+      frame));
+  const DenseArray<float>& dense_array = frame.Get(dense_array_output_slot);
+  const Array<float>& array = frame.Get(array_output_slot);
+  ASSERT_EQ(dense_array.size(), batch_size);
+  ASSERT_EQ(array.size(), batch_size);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_FLOAT_EQ(dense_array[i].value, expected[i].value);
+    EXPECT_FLOAT_EQ(array[i].value, expected[i].value);
+  }
+}
+
+TEST(BatchedForestEvaluator, ObliviousEvaluation) {
+  constexpr int64_t batch_size = 1000;
+  absl::BitGen rnd;
+  std::vector<QTypePtr> types(10, GetOptionalQType<float>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 30; ++i) {
+    int depth = absl::Uniform<int32_t>(rnd, 1, 8);
+    trees.push_back(CreateRandomObliviousTree(&rnd, depth, &types));
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  BatchedForestEvaluator::CompilationParams pointwise_params{
+      .max_splits_per_tree_for_columnar_eval = 0,
+      .enable_oblivious_eval = false};
+  BatchedForestEvaluator::CompilationParams oblivious_params{
+      .enable_oblivious_eval = true, .min_rows_for_columnar_eval = 1};
+  ASSERT_OK_AND_ASSIGN(auto pointwise_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()}, pointwise_params));
+  ASSERT_OK_AND_ASSIGN(auto oblivious_evaluator,
+                       BatchedForestEvaluator::Compile(
+                           *forest, {TreeFilter()}, oblivious_params));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto output_slot = layout_builder.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd,
+                                        /*missed_prob=*/0.2));
+  }
+
+  ASSERT_OK(pointwise_evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(output_slot)}, frame));
+  DenseArray<float> expected = frame.Get(output_slot);
+  ASSERT_EQ(expected.size(), batch_size);
+
+  frame.Set(output_slot, DenseArray<float>());
+  ASSERT_OK(oblivious_evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(output_slot)}, frame));
+  const DenseArray<float>& result = frame.Get(output_slot);
+  ASSERT_EQ(result.size(), batch_size);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_FLOAT_EQ(result[i].value, expected[i].value);
+  }
+}
+
+TEST(BatchedForestEvaluator, PrecompiledColumnarEvaluator) {
+  constexpr int64_t batch_size = 10;
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/10, /*interactions=*/true, /*min_num_splits=*/1,
+      /*max_num_splits=*/31, /*num_trees=*/50);
+  // The same trees with doubled adjustments, so that the results show which
+  // evaluator is used.
+  std::vector<DecisionTree> doubled_trees(forest->GetTrees().begin(),
+                                          forest->GetTrees().end());
+  for (DecisionTree& tree : doubled_trees) {
+    for (float& adjustment : tree.adjustments) adjustment *= 2;
+  }
+  ASSERT_OK_AND_ASSIGN(auto doubled_forest,
+                       DecisionForest::FromTrees(std::move(doubled_trees)));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  ASSERT_OK(CreateArraySlotsForForest(*forest, &layout_builder, &slots));
+  auto output_slot = layout_builder.AddSlot<DenseArray<float>>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation ctx(&layout);
+  FramePtr frame = ctx.frame();
+  for (auto slot : slots) {
+    ASSERT_OK(FillArrayWithRandomValues(batch_size, slot, frame, &rnd,
+                                        /*missed_prob=*/0.2));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto pointwise_evaluator,
+                       BatchedForestEvaluator::Compile(*forest));
+  ASSERT_OK(pointwise_evaluator->EvalBatch(
+      slots, {TypedSlot::FromSlot(output_slot)}, frame));
+  DenseArray<float> expected = frame.Get(output_slot);
+  ASSERT_EQ(expected.size(), batch_size);
+
+  // Evaluation without the DecisionForest.
+  ASSERT_OK_AND_ASSIGN(auto doubled_columnar,
+                       ColumnarForestEvaluator::Compile(*doubled_forest,
+                                                        {TreeFilter()}));
+  auto from_columnar = BatchedForestEvaluator::FromColumnar(doubled_columnar);
+  frame.Set(output_slot, DenseArray<float>());
+  ASSERT_OK(from_columnar->EvalBatch(slots, {TypedSlot::FromSlot(output_slot)},
+                                     frame));
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_FLOAT_EQ(frame.Get(output_slot)[i].value, 2 * expected[i].value);
+  }
+
+  // Register the doubled evaluator under the fingerprint of `forest`, so
+  // Compile(*forest) uses it even for small batches.
+  std::string data = doubled_columnar.SerializeAsFlatBuffer();
+  Fingerprint fingerprint =
+      ColumnarForestEvaluator::SourceFingerprint(*forest, {TreeFilter()});
+  uint64_t fingerprint_high = absl::Uint128High64(fingerprint.value);
+  uint64_t fingerprint_low = absl::Uint128Low64(fingerprint.value);
+  // The fingerprint follows magic (8 bytes), byte order mark and version.
+  std::memcpy(data.data() + 16, &fingerprint_high, sizeof(fingerprint_high));
+  std::memcpy(data.data() + 24, &fingerprint_low, sizeof(fingerprint_low));
+  auto owned_data = std::make_shared<const std::string>(std::move(data));
+  ASSERT_OK_AND_ASSIGN(
+      auto precompiled,
+      ColumnarForestEvaluator::FromFlatBuffer(*owned_data, owned_data));
+  ASSERT_OK(ColumnarForestEvaluator::RegisterPrecompiled(precompiled));
+
+  ASSERT_OK_AND_ASSIGN(auto evaluator,
+                       BatchedForestEvaluator::Compile(*forest));
+  frame.Set(output_slot, DenseArray<float>());
+  ASSERT_OK(
+      evaluator->EvalBatch(slots, {TypedSlot::FromSlot(output_slot)}, frame));
+  for (int64_t i = 0; i < batch_size; ++i) {
+    EXPECT_FLOAT_EQ(frame.Get(output_slot)[i].value, 2 * expected[i].value);
+  }
+}
+
 }  // namespace
 }  // namespace arolla
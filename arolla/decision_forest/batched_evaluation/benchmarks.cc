@@ -16,6 +16,8 @@
 //   use:    --benchmarks="BM_Prod_"
 // To run benchmarks on wider range of parameters
 //   use:    --benchmarks="BM_Main_"
+// To compare scaling with the number of threads
+//   use:    --benchmarks="BM_ThreadSweep_"
 
 #include <cstddef>
 #include <cstdint>
@@ -89,6 +91,19 @@ void BM_IntervalSplits(benchmark::State& state, size_t batch_size) {
                                num_splits * num_trees));
 }
 
+// The same as BM_IntervalSplits, but ColumnarForestEvaluator is disabled.
+void BM_PointwiseIntervalSplits(benchmark::State& state, size_t batch_size) {
+  int64_t num_splits = state.range(0);
+  int64_t num_trees = state.range(1);
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/10, /*interactions=*/true,
+      /*min_num_splits=*/num_splits, /*max_num_splits=*/num_splits, num_trees);
+  CHECK_OK(RunBatchedBenchmark(batch_size, *forest,
+                               {.max_splits_per_tree_for_columnar_eval = 0},
+                               state, num_splits * num_trees));
+}
+
 void BM_MixedSplits(benchmark::State& state, size_t batch_size) {
   int64_t num_splits = state.range(0);
   int64_t num_trees = state.range(1);
@@ -183,6 +198,10 @@ BATCH_BENCHMARK(Prod, IntervalSplits, 1000);
 BATCH_BENCHMARK(Prod, IntervalSplits, 10000);
 BATCH_BENCHMARK(Prod, IntervalSplits, 100000);
 
+BATCH_BENCHMARK(Prod, PointwiseIntervalSplits, 100);
+BATCH_BENCHMARK(Prod, PointwiseIntervalSplits, 1000);
+BATCH_BENCHMARK(Prod, PointwiseIntervalSplits, 100000);
+
 BATCH_BENCHMARK(Prod, MixedSplits, 1);
 BATCH_BENCHMARK(Prod, MixedSplits, 100);
 BATCH_BENCHMARK(Prod, MixedSplits, 1000);
@@ -193,6 +212,51 @@ THREADED_BENCHMARK(Prod, MixedSplits, 100);
 THREADED_BENCHMARK(Prod, MixedSplits, 1000);
 THREADED_BENCHMARK(Prod, MixedSplits, 100000);
 
+// Args: {thread_count, num_splits, num_trees, batch_size}.
+// thread_count = 1 means that multithreading is disabled.
+void RunThreadSweep(benchmark::State& state, bool mixed_splits) {
+  int thread_count = state.range(0);
+  int64_t num_splits = state.range(1);
+  int64_t num_trees = state.range(2);
+  int64_t batch_size = state.range(3);
+  absl::BitGen rnd;
+  auto forest =
+      mixed_splits
+          ? CreateRandomForest(&rnd, /*num_features=*/10, /*interactions=*/true,
+                               num_splits, num_splits, num_trees)
+          : CreateRandomFloatForest(&rnd, /*num_features=*/10,
+                                    /*interactions=*/true, num_splits,
+                                    num_splits, num_trees);
+  if (thread_count > 1) {
+    BatchedForestEvaluator::SetThreading(
+        std::make_unique<StdThreading>(thread_count));
+  }
+  CHECK_OK(RunBatchedBenchmark(batch_size, *forest, {}, state,
+                               num_splits * num_trees));
+  BatchedForestEvaluator::SetThreading(nullptr);
+}
+
+void BM_ThreadSweep_IntervalSplits(benchmark::State& state) {
+  RunThreadSweep(state, /*mixed_splits=*/false);
+}
+
+void BM_ThreadSweep_MixedSplits(benchmark::State& state) {
+  RunThreadSweep(state, /*mixed_splits=*/true);
+}
+
+void ThreadSweepArgs(::benchmark::Benchmark* b) {
+  for (int64_t batch_size : {10000, 100000}) {
+    for (int thread_count : {1, 2, 4, 8, 16}) {
+      b->Args({thread_count, (1 << 6) - 1, 2000, batch_size});
+      b->Args({thread_count, (1 << 3) - 1, 1000, batch_size});
+    }
+  }
+  b->UseRealTime();
+}
+
+BENCHMARK(BM_ThreadSweep_IntervalSplits)->Apply(&ThreadSweepArgs);
+BENCHMARK(BM_ThreadSweep_MixedSplits)->Apply(&ThreadSweepArgs);
+
 BATCH_BENCHMARK(BigModel, IntervalSplits, 100);
 BATCH_BENCHMARK(BigModel, IntervalSplits, 1000);
 
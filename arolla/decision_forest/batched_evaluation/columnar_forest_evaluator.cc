@@ -0,0 +1,623 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/numeric/int128.h"
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/util/fast_dynamic_downcast_final.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+
+namespace {
+
+using ::arolla::decision_forest_internal::UnpackColumn;
+
+const IntervalSplitCondition* AsIntervalSplit(const SplitCondition* cond) {
+  return fast_dynamic_downcast_final<const IntervalSplitCondition*>(cond);
+}
+
+int32_t EncodeChild(DecisionTreeNodeId id) {
+  return id.is_leaf() ? ~static_cast<int32_t>(id.adjustment_index())
+                      : static_cast<int32_t>(id.split_node_index());
+}
+
+// Header of the flat buffer format. It is followed by the arrays input_ids,
+// splits, adjustments, trees, bin_boundaries and bin_boundary_offsets, in
+// this order and without gaps.
+struct FlatHeader {
+  char magic[8];
+  uint32_t byte_order_mark;
+  uint32_t version;
+  uint64_t source_fingerprint_high;
+  uint64_t source_fingerprint_low;
+  int32_t group_count;
+  int32_t max_split_count;
+  int32_t input_count;
+  int32_t split_count;
+  int32_t adjustment_count;
+  int32_t tree_count;
+  int32_t bin_boundary_count;
+  int32_t bin_boundary_offset_count;
+};
+
+constexpr char kFlatMagic[8] = "ARLCFE\0";
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint32_t kFlatVersion = 3;
+
+template <typename T>
+void AppendArray(absl::Span<const T> array, std::string& out) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(alignof(T) <= alignof(FlatHeader));
+  out.append(reinterpret_cast<const char*>(array.data()),
+             array.size() * sizeof(T));
+}
+
+// Returns a view of `count` elements of type T at the beginning of `data`
+// and removes them from `data`.
+template <typename T>
+absl::StatusOr<absl::Span<const T>> ConsumeArray(int32_t count,
+                                                 absl::string_view& data) {
+  if (count < 0 || data.size() / sizeof(T) < count) {
+    return absl::InvalidArgumentError("flat buffer is truncated");
+  }
+  absl::Span<const T> res(reinterpret_cast<const T*>(data.data()), count);
+  data.remove_prefix(count * sizeof(T));
+  return res;
+}
+
+// Returns the index of the bin of `x`, i.e. the number of boundaries that are
+// less than or equal to `x`. NaN is in the bin 0, so no split condition is
+// true for it.
+uint8_t GetBin(absl::Span<const float> boundaries, float x) {
+  if (std::isnan(x)) {
+    return 0;
+  }
+  return std::upper_bound(boundaries.begin(), boundaries.end(), x) -
+         boundaries.begin();
+}
+
+struct PrecompiledRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_map<Fingerprint, ColumnarForestEvaluator> evaluators
+      ABSL_GUARDED_BY(mutex);
+};
+
+PrecompiledRegistry& GetPrecompiledRegistry() {
+  static absl::NoDestructor<PrecompiledRegistry> registry;
+  return *registry;
+}
+
+}  // namespace
+
+namespace decision_forest_internal {
+
+void UnpackColumn(const DenseArray<float>& array, int64_t offset,
+                  int64_t count, float* dst) {
+  const float* values = array.values.span().data() + offset;
+  std::copy(values, values + count, dst);
+  if (!array.bitmap.empty()) {
+    bitmap::IterateByGroups(
+        array.bitmap.begin(), array.bitmap_bit_offset + offset, count,
+        [dst](int64_t group_offset) {
+          float* group = dst + group_offset;
+          return [group](int i, bool present) {
+            if (!present) group[i] = std::numeric_limits<float>::quiet_NaN();
+          };
+        });
+  }
+}
+
+}  // namespace decision_forest_internal
+
+absl::StatusOr<int32_t> ColumnarForestEvaluator::GetTreeDepth(
+    absl::Span<const Split> splits) {
+  if (splits.empty()) {
+    return 0;
+  }
+  // Iterative DFS with memoization, so every node is expanded only once.
+  // depths[i] is 0 if the node is not visited yet, -1 if it is on the current
+  // path (its children are being processed), and the depth of its subtree
+  // otherwise.
+  std::vector<int32_t> depths(splits.size(), 0);
+  std::vector<int32_t> stack = {0};
+  while (!stack.empty()) {
+    const int32_t node_id = stack.back();
+    const Split& split = splits[node_id];
+    if (depths[node_id] > 0) {  // A duplicate entry of a processed node.
+      stack.pop_back();
+    } else if (depths[node_id] == 0) {
+      depths[node_id] = -1;
+      for (int32_t child : {split.child_if_false, split.child_if_true}) {
+        if (child >= 0) {
+          if (depths[child] == -1) {
+            return absl::InvalidArgumentError("cycle in a decision tree");
+          }
+          if (depths[child] == 0) {
+            stack.push_back(child);
+          }
+        }
+      }
+    } else {  // All children are processed.
+      int32_t depth = 1;
+      for (int32_t child : {split.child_if_false, split.child_if_true}) {
+        if (child >= 0) {
+          depth = std::max(depth, depths[child] + 1);
+        }
+      }
+      depths[node_id] = depth;
+      stack.pop_back();
+    }
+  }
+  return depths[0];
+}
+
+Fingerprint ColumnarForestEvaluator::SourceFingerprint(
+    const DecisionForest& forest, absl::Span<const TreeFilter> groups,
+    CompilationParams params) {
+  return FingerprintHasher("::arolla::ColumnarForestEvaluator")
+      .Combine(forest.fingerprint(), params.enable_quantization, groups.size())
+      .CombineSpan(groups)
+      .Finish();
+}
+
+bool ColumnarForestEvaluator::IsSupported(const DecisionForest& forest) {
+  for (const DecisionTree& tree : forest.GetTrees()) {
+    for (const SplitNode& node : tree.split_nodes) {
+      if (AsIntervalSplit(node.condition.get()) == nullptr) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<ColumnarForestEvaluator> ColumnarForestEvaluator::Compile(
+    const DecisionForest& forest, absl::Span<const TreeFilter> groups,
+    CompilationParams params) {
+  auto data = std::make_shared<OwnedData>();
+  ColumnarForestEvaluator res;
+  res.group_count_ = groups.size();
+  res.source_fingerprint_ = SourceFingerprint(forest, groups, params);
+  absl::flat_hash_map<int, int32_t> input_id_to_column;
+  for (const DecisionTree& tree : forest.GetTrees()) {
+    int32_t group = -1;
+    for (int32_t i = 0; i < groups.size(); ++i) {
+      if (groups[i](tree.tag)) {
+        group = i;
+        break;
+      }
+    }
+    if (group == -1) {
+      continue;
+    }
+    const int32_t first_split = data->splits.size();
+    for (const SplitNode& node : tree.split_nodes) {
+      const IntervalSplitCondition* cond =
+          AsIntervalSplit(node.condition.get());
+      if (cond == nullptr) {
+        return absl::InvalidArgumentError(
+            "ColumnarForestEvaluator supports only IntervalSplitCondition");
+      }
+      auto [it, inserted] = input_id_to_column.emplace(
+          cond->input_id(), static_cast<int32_t>(data->input_ids.size()));
+      if (inserted) {
+        data->input_ids.push_back(cond->input_id());
+      }
+      data->splits.push_back(
+          {.column = it->second,
+           .left = cond->left(),
+           .right = cond->right(),
+           .child_if_false = EncodeChild(node.child_if_false),
+           .child_if_true = EncodeChild(node.child_if_true)});
+    }
+    ASSIGN_OR_RETURN(
+        int32_t depth,
+        GetTreeDepth(absl::MakeConstSpan(data->splits).subspan(first_split)));
+    data->trees.push_back(
+        {.first_split = first_split,
+         .split_count = static_cast<int32_t>(tree.split_nodes.size()),
+         .first_adjustment = static_cast<int32_t>(data->adjustments.size()),
+         .adjustment_count = static_cast<int32_t>(tree.adjustments.size()),
+         .depth = depth,
+         .group = group});
+    res.max_split_count_ = std::max<int32_t>(res.max_split_count_,
+                                             tree.split_nodes.size());
+    for (float adjustment : tree.adjustments) {
+      data->adjustments.push_back(adjustment * tree.weight);
+    }
+  }
+  if (params.enable_quantization) {
+    Quantize(*data);
+  }
+  res.input_ids_ = data->input_ids;
+  res.splits_ = data->splits;
+  res.adjustments_ = data->adjustments;
+  res.trees_ = data->trees;
+  res.bin_boundaries_ = data->bin_boundaries;
+  res.bin_boundary_offsets_ = data->bin_boundary_offsets;
+  res.storage_ = std::move(data);
+  return res;
+}
+
+void ColumnarForestEvaluator::Quantize(OwnedData& data) {
+  // `x <= right` is equivalent to `!(x >= nextafter(right, inf))`, so all
+  // conditions can be expressed via `x >= boundary`. `x <= inf` is always
+  // true for non-NaN values and doesn't need a boundary.
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  auto right_boundary = [](float right) { return std::nextafter(right, kInf); };
+  std::vector<std::vector<float>> boundaries(data.input_ids.size());
+  for (const Split& split : data.splits) {
+    if (std::isnan(split.left) || std::isnan(split.right)) {
+      return;
+    }
+    boundaries[split.column].push_back(split.left);
+    if (split.right != kInf) {
+      boundaries[split.column].push_back(right_boundary(split.right));
+    }
+  }
+  for (auto& column_boundaries : boundaries) {
+    std::sort(column_boundaries.begin(), column_boundaries.end());
+    column_boundaries.erase(
+        std::unique(column_boundaries.begin(), column_boundaries.end()),
+        column_boundaries.end());
+    if (column_boundaries.size() >= kMaxBinCount) {
+      return;
+    }
+  }
+  auto index_of = [](absl::Span<const float> column_boundaries, float value) {
+    return std::lower_bound(column_boundaries.begin(), column_boundaries.end(),
+                            value) -
+           column_boundaries.begin();
+  };
+  for (Split& split : data.splits) {
+    absl::Span<const float> column_boundaries = boundaries[split.column];
+    split.bin_left = index_of(column_boundaries, split.left);
+    split.bin_right = split.right == kInf
+                          ? column_boundaries.size()
+                          : index_of(column_boundaries,
+                                     right_boundary(split.right));
+  }
+  data.bin_boundary_offsets.push_back(0);
+  for (const auto& column_boundaries : boundaries) {
+    data.bin_boundaries.insert(data.bin_boundaries.end(),
+                               column_boundaries.begin(),
+                               column_boundaries.end());
+    data.bin_boundary_offsets.push_back(data.bin_boundaries.size());
+  }
+}
+
+std::string ColumnarForestEvaluator::SerializeAsFlatBuffer() const {
+  FlatHeader header;
+  std::copy(std::begin(kFlatMagic), std::end(kFlatMagic), header.magic);
+  header.byte_order_mark = kByteOrderMark;
+  header.version = kFlatVersion;
+  header.source_fingerprint_high =
+      absl::Uint128High64(source_fingerprint_.value);
+  header.source_fingerprint_low = absl::Uint128Low64(source_fingerprint_.value);
+  header.group_count = group_count_;
+  header.max_split_count = max_split_count_;
+  header.input_count = input_ids_.size();
+  header.split_count = splits_.size();
+  header.adjustment_count = adjustments_.size();
+  header.tree_count = trees_.size();
+  header.bin_boundary_count = bin_boundaries_.size();
+  header.bin_boundary_offset_count = bin_boundary_offsets_.size();
+  std::string res;
+  AppendArray(absl::Span<const FlatHeader>(&header, 1), res);
+  AppendArray(input_ids_, res);
+  AppendArray(splits_, res);
+  AppendArray(adjustments_, res);
+  AppendArray(trees_, res);
+  AppendArray(bin_boundaries_, res);
+  AppendArray(bin_boundary_offsets_, res);
+  return res;
+}
+
+absl::StatusOr<ColumnarForestEvaluator> ColumnarForestEvaluator::FromFlatBuffer(
+    absl::string_view data, std::shared_ptr<const void> owner) {
+  if (reinterpret_cast<uintptr_t>(data.data()) % alignof(FlatHeader) != 0) {
+    return absl::InvalidArgumentError("flat buffer is not aligned");
+  }
+  ASSIGN_OR_RETURN(auto header, ConsumeArray<FlatHeader>(1, data));
+  if (!std::equal(std::begin(kFlatMagic), std::end(kFlatMagic),
+                  header[0].magic)) {
+    return absl::InvalidArgumentError("not a ColumnarForestEvaluator buffer");
+  }
+  if (header[0].byte_order_mark != kByteOrderMark) {
+    return absl::InvalidArgumentError("flat buffer has a different byte order");
+  }
+  if (header[0].version != kFlatVersion) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "unsupported flat buffer version: %d", header[0].version));
+  }
+  ColumnarForestEvaluator res;
+  res.source_fingerprint_ = Fingerprint{absl::MakeUint128(
+      header[0].source_fingerprint_high, header[0].source_fingerprint_low)};
+  res.group_count_ = header[0].group_count;
+  res.max_split_count_ = header[0].max_split_count;
+  ASSIGN_OR_RETURN(res.input_ids_,
+                   ConsumeArray<int>(header[0].input_count, data));
+  ASSIGN_OR_RETURN(res.splits_,
+                   ConsumeArray<Split>(header[0].split_count, data));
+  ASSIGN_OR_RETURN(res.adjustments_,
+                   ConsumeArray<float>(header[0].adjustment_count, data));
+  ASSIGN_OR_RETURN(res.trees_,
+                   ConsumeArray<Tree>(header[0].tree_count, data));
+  ASSIGN_OR_RETURN(res.bin_boundaries_,
+                   ConsumeArray<float>(header[0].bin_boundary_count, data));
+  ASSIGN_OR_RETURN(
+      res.bin_boundary_offsets_,
+      ConsumeArray<int32_t>(header[0].bin_boundary_offset_count, data));
+  if (!data.empty()) {
+    return absl::InvalidArgumentError("unexpected data after the flat buffer");
+  }
+  RETURN_IF_ERROR(res.Validate());
+  res.storage_ = std::move(owner);
+  return res;
+}
+
+absl::StatusOr<ColumnarForestEvaluator>
+ColumnarForestEvaluator::FromFlatBufferFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("unable to open ", path));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    int errno_copy = errno;
+    close(fd);
+    return absl::ErrnoToStatus(errno_copy,
+                               absl::StrCat("unable to stat ", path));
+  }
+  const size_t size = file_stat.st_size;
+  if (size == 0) {
+    close(fd);
+    return absl::InvalidArgumentError(absl::StrCat(path, " is empty"));
+  }
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  int errno_copy = errno;
+  close(fd);  // The mapping stays valid after closing the file.
+  if (addr == MAP_FAILED) {
+    return absl::ErrnoToStatus(errno_copy,
+                               absl::StrCat("unable to map ", path));
+  }
+  std::shared_ptr<const void> mapping(addr, [size](const void* ptr) {
+    munmap(const_cast<void*>(ptr), size);
+  });
+  ASSIGN_OR_RETURN(
+      ColumnarForestEvaluator res,
+      FromFlatBuffer(absl::string_view(static_cast<const char*>(addr), size),
+                     std::move(mapping)),
+      _ << "in " << path);
+  return res;
+}
+
+absl::Status ColumnarForestEvaluator::RegisterPrecompiled(
+    ColumnarForestEvaluator evaluator) {
+  if (evaluator.storage_ == nullptr) {
+    return absl::InvalidArgumentError(
+        "ColumnarForestEvaluator doesn't own its data; pass an owner to "
+        "FromFlatBuffer to register it");
+  }
+  PrecompiledRegistry& registry = GetPrecompiledRegistry();
+  absl::MutexLock lock(registry.mutex);
+  Fingerprint fingerprint = evaluator.source_fingerprint();
+  registry.evaluators.insert_or_assign(fingerprint, std::move(evaluator));
+  return absl::OkStatus();
+}
+
+std::optional<ColumnarForestEvaluator> ColumnarForestEvaluator::FindPrecompiled(
+    Fingerprint source_fingerprint) {
+  PrecompiledRegistry& registry = GetPrecompiledRegistry();
+  absl::MutexLock lock(registry.mutex);
+  auto it = registry.evaluators.find(source_fingerprint);
+  if (it == registry.evaluators.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+absl::Status ColumnarForestEvaluator::Validate() const {
+  auto error = [](absl::string_view msg) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("invalid ColumnarForestEvaluator flat buffer: ", msg));
+  };
+  if (group_count_ < 0 || max_split_count_ < 0) {
+    return error("negative group_count or max_split_count");
+  }
+  if (is_quantized()) {
+    if (bin_boundary_offsets_.size() != input_ids_.size() + 1 ||
+        bin_boundary_offsets_.front() != 0 ||
+        bin_boundary_offsets_.back() != bin_boundaries_.size()) {
+      return error("inconsistent bin boundaries");
+    }
+    for (size_t i = 0; i < input_ids_.size(); ++i) {
+      int32_t count = bin_boundary_offsets_[i + 1] - bin_boundary_offsets_[i];
+      if (count < 0 || count >= kMaxBinCount) {
+        return error("inconsistent bin boundaries");
+      }
+    }
+  } else if (!bin_boundaries_.empty()) {
+    return error("inconsistent bin boundaries");
+  }
+  for (const Tree& tree : trees_) {
+    if (tree.group < 0 || tree.group >= group_count_) {
+      return error("group is out of range");
+    }
+    if (tree.split_count < 0 || tree.split_count > max_split_count_ ||
+        tree.first_split < 0 ||
+        int64_t{tree.first_split} + tree.split_count > splits_.size()) {
+      return error("split range is out of bounds");
+    }
+    if (tree.adjustment_count <= 0 || tree.first_adjustment < 0 ||
+        int64_t{tree.first_adjustment} + tree.adjustment_count >
+            adjustments_.size()) {
+      return error("adjustment range is out of bounds");
+    }
+    auto splits = splits_.subspan(tree.first_split, tree.split_count);
+    for (const Split& split : splits) {
+      if (split.column < 0 || split.column >= input_ids_.size()) {
+        return error("column is out of range");
+      }
+      for (int32_t child : {split.child_if_false, split.child_if_true}) {
+        if (child >= tree.split_count || ~child >= tree.adjustment_count) {
+          return error("child is out of range");
+        }
+      }
+    }
+    // Eval makes exactly `tree.depth` steps, so a smaller value would leave
+    // rows on split nodes and a greater one would waste time.
+    ASSIGN_OR_RETURN(int32_t depth, GetTreeDepth(splits));
+    if (tree.depth != depth) {
+      return error("depth doesn't match the tree");
+    }
+  }
+  return absl::OkStatus();
+}
+
+void ColumnarForestEvaluator::UnpackBlock(
+    absl::Span<const DenseArray<float>* const> inputs, int64_t offset,
+    int64_t count, float* columns, uint8_t* bins) const {
+  if (!is_quantized()) {
+    for (int64_t col = 0; col < inputs.size(); ++col) {
+      UnpackColumn(*inputs[col], offset, count, columns + col * kBlockSize);
+    }
+    return;
+  }
+  float values[kBlockSize];
+  for (int64_t col = 0; col < inputs.size(); ++col) {
+    UnpackColumn(*inputs[col], offset, count, values);
+    auto boundaries = bin_boundaries_.subspan(
+        bin_boundary_offsets_[col],
+        bin_boundary_offsets_[col + 1] - bin_boundary_offsets_[col]);
+    uint8_t* column_bins = bins + col * kBlockSize;
+    for (int64_t i = 0; i < count; ++i) {
+      column_bins[i] = GetBin(boundaries, values[i]);
+    }
+  }
+}
+
+void ColumnarForestEvaluator::Eval(
+    absl::Span<const DenseArray<float>* const> inputs, int64_t row_count,
+    absl::Span<const absl::Span<float>> outputs) const {
+  DCHECK_EQ(inputs.size(), input_ids_.size());
+  for (const DenseArray<float>* input : inputs) {
+    DCHECK_EQ(input->size(), row_count);
+  }
+  DCHECK_EQ(outputs.size(), group_count_);
+
+  std::vector<float> columns(is_quantized() ? 0
+                                            : input_ids_.size() * kBlockSize);
+  std::vector<uint8_t> bins(is_quantized() ? input_ids_.size() * kBlockSize
+                                           : 0);
+  std::vector<uint8_t> conditions(max_split_count_ * kBlockSize);
+  std::vector<int32_t> nodes(kBlockSize);
+  std::vector<double> sums(group_count_ * kBlockSize);
+
+  for (int64_t block_offset = 0; block_offset < row_count;
+       block_offset += kBlockSize) {
+    const int64_t n = std::min(kBlockSize, row_count - block_offset);
+    UnpackBlock(inputs, block_offset, n, columns.data(), bins.data());
+    std::fill(sums.begin(), sums.end(), 0.0);
+
+    for (const Tree& tree : trees_) {
+      const Split* splits = splits_.data() + tree.first_split;
+      // Split nodes in the outer loop, rows in the inner loop.
+      for (int32_t s = 0; s < tree.split_count; ++s) {
+        uint8_t* cond = conditions.data() + s * kBlockSize;
+        if (is_quantized()) {
+          const uint8_t* b = bins.data() + splits[s].column * kBlockSize;
+          const uint8_t left = splits[s].bin_left;
+          const uint8_t right = splits[s].bin_right;
+          for (int64_t i = 0; i < n; ++i) {
+            cond[i] = (left < b[i]) & (b[i] <= right);
+          }
+        } else {
+          const float* x = columns.data() + splits[s].column * kBlockSize;
+          const float left = splits[s].left;
+          const float right = splits[s].right;
+          for (int64_t i = 0; i < n; ++i) {
+            cond[i] = (left <= x[i]) & (x[i] <= right);
+          }
+        }
+      }
+      // ~0 encodes adjustment #0 (the only leaf of a tree without splits).
+      std::fill(nodes.begin(), nodes.begin() + n,
+                tree.split_count > 0 ? 0 : ~0);
+      for (int32_t level = 0; level < tree.depth; ++level) {
+        for (int64_t i = 0; i < n; ++i) {
+          int32_t node = nodes[i];
+          if (node >= 0) {
+            nodes[i] = conditions[node * kBlockSize + i]
+                           ? splits[node].child_if_true
+                           : splits[node].child_if_false;
+          }
+        }
+      }
+      const float* adjustments = adjustments_.data() + tree.first_adjustment;
+      double* sum = sums.data() + tree.group * kBlockSize;
+      for (int64_t i = 0; i < n; ++i) {
+        DCHECK_LT(nodes[i], 0);
+        sum[i] += adjustments[~nodes[i]];
+      }
+    }
+
+    for (int g = 0; g < group_count_; ++g) {
+      DCHECK_EQ(outputs[g].size(), row_count);
+      const double* sum = sums.data() + g * kBlockSize;
+      float* out = outputs[g].data() + block_offset;
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = sum[i];
+      }
+    }
+  }
+}
+
+}  // namespace arolla
@@ -0,0 +1,221 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_BATCHED_EVALUATION_COLUMNAR_FOREST_EVALUATOR_H_
+#define AROLLA_DECISION_FOREST_BATCHED_EVALUATION_COLUMNAR_FOREST_EVALUATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+
+namespace decision_forest_internal {
+
+// Copies values of `array` in range [offset, offset + count) to `dst`.
+// Missing values are replaced with NaN.
+void UnpackColumn(const DenseArray<float>& array, int64_t offset,
+                  int64_t count, float* dst);
+
+}  // namespace decision_forest_internal
+
+// Batched decision forest evaluator that iterates over split nodes in the
+// outer loop and over rows in the inner loop. Only forests with
+// IntervalSplitCondition splits are supported.
+//
+// Rows are processed in blocks of kBlockSize. For every block the used inputs
+// are unpacked into contiguous float columns (missing values are replaced with
+// NaN, so all comparisons with them are false). Then for every tree:
+//   1) each split condition is evaluated over the whole column block, giving
+//      one byte per row (the loop has no branches and is vectorized);
+//   2) rows descend the tree level by level using a vector of node indices,
+//      reading only the precomputed conditions;
+//   3) leaf adjustments are gathered and added to the sums of the tree group.
+//
+// Evaluates all split nodes of every tree, so it is efficient only for small
+// trees. See BatchedForestEvaluator::CompilationParams for the heuristics.
+//
+// If every input has at most kMaxBinCount - 1 distinct thresholds, the inputs
+// are quantized: each value is replaced with the number of thresholds that
+// are not greater than the value (the bin index, one byte per row), and all
+// split conditions become integer comparisons of bin indices.
+//
+// The compiled state consists of a few flat arrays and can be saved with
+// SerializeAsFlatBuffer. FromFlatBuffer creates an evaluator that reads the
+// arrays directly from the buffer, and FromFlatBufferFile maps a file into
+// memory read-only, so the pages are shared between processes without
+// compilation and copying. Such an evaluator can be used without the
+// DecisionForest via BatchedForestEvaluator::FromColumnar. An evaluator
+// registered with RegisterPrecompiled is used by
+// BatchedForestEvaluator::Compile (and so by the batched decision forest
+// operator) for batches of all sizes, so neither it nor the pointwise
+// ForestEvaluator is compiled again.
+class ColumnarForestEvaluator {
+ public:
+  static constexpr int64_t kBlockSize = 256;
+  static constexpr int kMaxBinCount = 256;
+
+  struct CompilationParams {
+    static constexpr CompilationParams Default() { return {}; }
+    // Use quantized inputs if all inputs have few enough distinct thresholds.
+    bool enable_quantization = true;
+  };
+
+  // Returns true if all split conditions in the forest are supported.
+  static bool IsSupported(const DecisionForest& forest);
+
+  // The "groups" argument has the same meaning as in
+  // BatchedForestEvaluator::Compile.
+  static absl::StatusOr<ColumnarForestEvaluator> Compile(
+      const DecisionForest& forest, absl::Span<const TreeFilter> groups,
+      CompilationParams params = CompilationParams::Default());
+
+  // Returns the fingerprint of the arguments of Compile. Evaluators with the
+  // same source fingerprint produce the same results.
+  static Fingerprint SourceFingerprint(
+      const DecisionForest& forest, absl::Span<const TreeFilter> groups,
+      CompilationParams params = CompilationParams::Default());
+
+  // Serializes the compiled state into a flat binary format. The format
+  // depends on the byte order of the platform.
+  std::string SerializeAsFlatBuffer() const;
+
+  // Creates an evaluator over the data produced by SerializeAsFlatBuffer.
+  // The data is not copied. It is kept alive by `owner` (shared by all copies
+  // of the evaluator), or, if `owner` is nullptr, must outlive the evaluator
+  // and all its copies. The data must be 8-byte aligned.
+  static absl::StatusOr<ColumnarForestEvaluator> FromFlatBuffer(
+      absl::string_view data, std::shared_ptr<const void> owner = nullptr);
+
+  // Maps the file written from SerializeAsFlatBuffer into memory (read-only)
+  // and creates an evaluator over it. The mapping is released when the
+  // evaluator and all its copies are destroyed.
+  static absl::StatusOr<ColumnarForestEvaluator> FromFlatBufferFile(
+      const std::string& path);
+
+  // Registers the evaluator in a process-wide registry, replacing an evaluator
+  // with the same source_fingerprint() if any. The registry shares the
+  // ownership of the evaluator data, so an evaluator created by FromFlatBuffer
+  // without an `owner` is rejected.
+  static absl::Status RegisterPrecompiled(ColumnarForestEvaluator evaluator);
+
+  // Returns a registered evaluator with the given source fingerprint.
+  static std::optional<ColumnarForestEvaluator> FindPrecompiled(
+      Fingerprint source_fingerprint);
+
+  // Fingerprint of the arguments of Compile (see SourceFingerprint).
+  Fingerprint source_fingerprint() const { return source_fingerprint_; }
+
+  // The inputs required by the forest, in the order expected by Eval.
+  absl::Span<const int> input_ids() const { return input_ids_; }
+
+  // The number of tree groups, i.e. the number of outputs of Eval.
+  int group_count() const { return group_count_; }
+
+  // Returns true if the inputs are quantized (see the class comment).
+  bool is_quantized() const { return !bin_boundary_offsets_.empty(); }
+
+  // Evaluates the forest on `row_count` rows. `inputs[i]` corresponds to the
+  // forest input `input_ids()[i]`. `outputs` should contain a span of size
+  // `row_count` for each group.
+  void Eval(absl::Span<const DenseArray<float>* const> inputs,
+            int64_t row_count,
+            absl::Span<const absl::Span<float>> outputs) const;
+
+ private:
+  // Children are encoded as int32_t: non-negative values are split node
+  // indices within the tree, negative values are `~adjustment_index`.
+  // For quantized inputs `left <= x <= right` is equivalent to
+  // `bin_left < bin(x) <= bin_right`.
+  struct Split {
+    int32_t column;
+    float left;
+    float right;
+    int32_t child_if_false;
+    int32_t child_if_true;
+    uint16_t bin_left;
+    uint16_t bin_right;
+  };
+
+  struct Tree {
+    int32_t first_split;
+    int32_t split_count;
+    int32_t first_adjustment;
+    int32_t adjustment_count;
+    int32_t depth;
+    int32_t group;
+  };
+
+  // Storage for the arrays of a compiled (not loaded) evaluator.
+  struct OwnedData {
+    std::vector<int> input_ids;
+    std::vector<Split> splits;
+    std::vector<float> adjustments;
+    std::vector<Tree> trees;
+    std::vector<float> bin_boundaries;
+    std::vector<int32_t> bin_boundary_offsets;
+  };
+
+  ColumnarForestEvaluator() = default;
+
+  // Returns the max number of split nodes on a path from the root to a leaf.
+  // Runs in O(splits.size()) even if the nodes form a DAG (e.g. in a forged
+  // flat buffer), and fails on cycles.
+  static absl::StatusOr<int32_t> GetTreeDepth(absl::Span<const Split> splits);
+
+  // Verifies that all indices are in range and the tree depths are exact, so
+  // Eval can trust them.
+  absl::Status Validate() const;
+
+  // Fills bin_* fields of the splits, or does nothing if some input has too
+  // many thresholds.
+  static void Quantize(OwnedData& data);
+
+  // Unpacks the given rows of `inputs` into `columns` (kBlockSize per input),
+  // or into `bins` if the inputs are quantized.
+  void UnpackBlock(absl::Span<const DenseArray<float>* const> inputs,
+                   int64_t offset, int64_t count, float* columns,
+                   uint8_t* bins) const;
+
+  // Keeps the arrays alive: OwnedData for a compiled evaluator, the file
+  // mapping or the `owner` passed to FromFlatBuffer. nullptr if the arrays are
+  // owned by an external buffer.
+  std::shared_ptr<const void> storage_;
+  Fingerprint source_fingerprint_{};
+  absl::Span<const int> input_ids_;
+  absl::Span<const Split> splits_;
+  absl::Span<const float> adjustments_;  // Multiplied by tree weight.
+  absl::Span<const Tree> trees_;
+  // Sorted thresholds of the input i are
+  // bin_boundaries_[bin_boundary_offsets_[i]:bin_boundary_offsets_[i+1]].
+  // Both are empty if the inputs are not quantized.
+  absl::Span<const float> bin_boundaries_;
+  absl::Span<const int32_t> bin_boundary_offsets_;
+  int32_t max_split_count_ = 0;
+  int group_count_ = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_BATCHED_EVALUATION_COLUMNAR_FOREST_EVALUATOR_H_
@@ -0,0 +1,362 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
+#include "arolla/decision_forest/testing/test_util.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
+
+std::vector<float> Eval(const ColumnarForestEvaluator& eval,
+                        absl::Span<const DenseArray<float>> inputs,
+                        int64_t row_count, int group_count = 1,
+                        int output_id = 0) {
+  std::vector<const DenseArray<float>*> input_ptrs;
+  for (int id : eval.input_ids()) {
+    input_ptrs.push_back(&inputs[id]);
+  }
+  std::vector<std::vector<float>> results(group_count,
+                                          std::vector<float>(row_count));
+  std::vector<absl::Span<float>> outputs;
+  for (auto& r : results) outputs.push_back(absl::MakeSpan(r));
+  eval.Eval(input_ptrs, row_count, outputs);
+  return results[output_id];
+}
+
+TEST(ColumnarForestEvaluator, IsSupported) {
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {0, 1};
+  trees[0].split_nodes = {{A(0), A(1), IntervalSplit(0, 1, 5)}};
+  ASSERT_OK_AND_ASSIGN(auto forest, DecisionForest::FromTrees(
+                                        std::vector<DecisionTree>(trees)));
+  EXPECT_TRUE(ColumnarForestEvaluator::IsSupported(*forest));
+
+  trees[0].split_nodes = {
+      {A(0), A(1), SetOfValuesSplit<int64_t>(0, {1, 2}, false)}};
+  ASSERT_OK_AND_ASSIGN(
+      forest, DecisionForest::FromTrees(std::vector<DecisionTree>(trees)));
+  EXPECT_FALSE(ColumnarForestEvaluator::IsSupported(*forest));
+}
+
+TEST(ColumnarForestEvaluator, Eval) {
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  std::vector<DecisionTree> trees(3);
+  trees[0].tag = {.submodel_id = 0};
+  trees[0].adjustments = {0.5, 1.5, 2.5, 3.5};
+  trees[0].split_nodes = {{S(1), S(2), IntervalSplit(0, 1.5, kInf)},
+                          {A(0), A(2), IntervalSplit(1, 1, 2)},
+                          {A(1), A(3), IntervalSplit(0, -kInf, 10)}};
+  trees[1].tag = {.submodel_id = 1};
+  trees[1].adjustments = {-1.0, 1.0};
+  trees[1].split_nodes = {{A(0), A(1), IntervalSplit(0, 1, 5)}};
+  trees[2].tag = {.submodel_id = 0};
+  trees[2].adjustments = {10.0};
+  trees[2].weight = 0.5;
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+  std::vector<DenseArray<float>> inputs = {
+      CreateDenseArray<float>({0, 0, 1.2, 1.6, 7.0, 13.5, NAN, {}, 1.5, 5.0,
+                               kInf, -kInf}),
+      CreateDenseArray<float>({3, 1, 1, 1, 1, 1, {}, 1, 1, 1, 1, 1})};
+  for (bool quantize : {false, true}) {
+    ASSERT_OK_AND_ASSIGN(
+        auto eval, ColumnarForestEvaluator::Compile(
+                       *forest, groups, {.enable_quantization = quantize}));
+    EXPECT_EQ(eval.is_quantized(), quantize);
+    EXPECT_THAT(eval.input_ids(), ElementsAre(0, 1));
+    EXPECT_THAT(Eval(eval, inputs, 12, 2, 0),
+                ElementsAre(5.5, 7.5, 7.5, 8.5, 8.5, 6.5, 5.5, 7.5, 8.5, 8.5,
+                            6.5, 7.5));
+    EXPECT_THAT(Eval(eval, inputs, 12, 2, 1),
+                ElementsAre(-1, -1, 1, 1, -1, -1, -1, -1, 1, 1, -1, -1));
+  }
+}
+
+TEST(ColumnarForestEvaluator, FlatBuffer) {
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/5, /*interactions=*/true, /*min_num_splits=*/0,
+      /*max_num_splits=*/15, /*num_trees=*/10);
+  ASSERT_OK_AND_ASSIGN(auto eval, ColumnarForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+  ASSERT_TRUE(eval.is_quantized());
+  std::string data = eval.SerializeAsFlatBuffer();
+  ASSERT_OK_AND_ASSIGN(auto loaded,
+                       ColumnarForestEvaluator::FromFlatBuffer(data));
+  EXPECT_THAT(loaded.input_ids(), ElementsAreArray(eval.input_ids()));
+  EXPECT_TRUE(loaded.is_quantized());
+  EXPECT_EQ(loaded.source_fingerprint(), eval.source_fingerprint());
+  EXPECT_EQ(
+      loaded.source_fingerprint(),
+      ColumnarForestEvaluator::SourceFingerprint(*forest, {TreeFilter()}));
+
+  constexpr int64_t kRowCount = 100;
+  std::vector<DenseArray<float>> inputs;
+  for (int i = 0; i < 5; ++i) {
+    DenseArrayBuilder<float> bldr(kRowCount);
+    for (int64_t row = 0; row < kRowCount; ++row) {
+      bldr.Set(row, absl::Uniform<float>(rnd, 0, 1));
+    }
+    inputs.push_back(std::move(bldr).Build());
+  }
+  EXPECT_THAT(Eval(loaded, inputs, kRowCount),
+              ElementsAreArray(Eval(eval, inputs, kRowCount)));
+
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBuffer(
+                  absl::string_view(data).substr(0, data.size() - 4)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("truncated")));
+  std::string corrupted = data + "abcd";
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBuffer(corrupted),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unexpected data after the flat buffer")));
+  corrupted = data;
+  corrupted[0] = 'X';
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBuffer(corrupted),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a ColumnarForestEvaluator buffer")));
+  // Corrupt the `column` field of the first split, which follows the header
+  // (64 bytes) and input_ids.
+  constexpr int64_t kHeaderSize = 64;
+  const int64_t splits_offset = kHeaderSize + 4 * eval.input_ids().size();
+  corrupted = data;
+  int32_t bad_column = 1000;
+  std::memcpy(corrupted.data() + splits_offset, &bad_column,
+              sizeof(bad_column));
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBuffer(corrupted),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("column is out of range")));
+  // Corrupt the `depth` field of the first tree, which follows the splits
+  // (24 bytes each) and the adjustments. The counts are taken from the header.
+  int32_t split_count, adjustment_count;
+  std::memcpy(&split_count, data.data() + 44, sizeof(split_count));
+  std::memcpy(&adjustment_count, data.data() + 48, sizeof(adjustment_count));
+  corrupted = data;
+  int32_t bad_depth = 1 << 20;
+  std::memcpy(corrupted.data() + splits_offset + 24 * split_count +
+                  4 * adjustment_count + 16,
+              &bad_depth, sizeof(bad_depth));
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBuffer(corrupted),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("depth doesn't match the tree")));
+}
+
+TEST(ColumnarForestEvaluator, FlatBufferFile) {
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/5, /*interactions=*/true, /*min_num_splits=*/0,
+      /*max_num_splits=*/15, /*num_trees=*/10);
+  ASSERT_OK_AND_ASSIGN(auto eval, ColumnarForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+  std::string path = ::testing::TempDir() + "/columnar_forest.bin";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << eval.SerializeAsFlatBuffer();
+  }
+  ASSERT_OK_AND_ASSIGN(auto loaded,
+                       ColumnarForestEvaluator::FromFlatBufferFile(path));
+  EXPECT_THAT(loaded.input_ids(), ElementsAreArray(eval.input_ids()));
+  EXPECT_EQ(loaded.source_fingerprint(), eval.source_fingerprint());
+
+  constexpr int64_t kRowCount = 100;
+  std::vector<DenseArray<float>> inputs;
+  for (int i = 0; i < 5; ++i) {
+    DenseArrayBuilder<float> bldr(kRowCount);
+    for (int64_t row = 0; row < kRowCount; ++row) {
+      bldr.Set(row, absl::Uniform<float>(rnd, 0, 1));
+    }
+    inputs.push_back(std::move(bldr).Build());
+  }
+  // The copy shares the mapping, so it stays valid after `loaded` is gone.
+  ColumnarForestEvaluator copy = loaded;
+  loaded = eval;
+  EXPECT_THAT(Eval(copy, inputs, kRowCount),
+              ElementsAreArray(Eval(eval, inputs, kRowCount)));
+
+  EXPECT_THAT(ColumnarForestEvaluator::FromFlatBufferFile(path + ".missing"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(ColumnarForestEvaluator, Precompiled) {
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, /*num_features=*/5, /*interactions=*/true, /*min_num_splits=*/0,
+      /*max_num_splits=*/15, /*num_trees=*/10);
+  Fingerprint fingerprint =
+      ColumnarForestEvaluator::SourceFingerprint(*forest, {TreeFilter()});
+  EXPECT_NE(fingerprint, ColumnarForestEvaluator::SourceFingerprint(
+                             *forest, {TreeFilter()},
+                             {.enable_quantization = false}));
+  EXPECT_FALSE(ColumnarForestEvaluator::FindPrecompiled(fingerprint));
+
+  ASSERT_OK_AND_ASSIGN(auto eval, ColumnarForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+  auto data =
+      std::make_shared<const std::string>(eval.SerializeAsFlatBuffer());
+  ASSERT_OK_AND_ASSIGN(auto not_owning,
+                       ColumnarForestEvaluator::FromFlatBuffer(*data));
+  EXPECT_THAT(ColumnarForestEvaluator::RegisterPrecompiled(not_owning),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("doesn't own its data")));
+  EXPECT_FALSE(ColumnarForestEvaluator::FindPrecompiled(fingerprint));
+
+  ASSERT_OK_AND_ASSIGN(auto owning,
+                       ColumnarForestEvaluator::FromFlatBuffer(*data, data));
+  ASSERT_OK(ColumnarForestEvaluator::RegisterPrecompiled(owning));
+  // The registry keeps the data alive.
+  data.reset();
+  owning = eval;
+  auto found = ColumnarForestEvaluator::FindPrecompiled(fingerprint);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->source_fingerprint(), fingerprint);
+  EXPECT_THAT(found->input_ids(), ElementsAreArray(eval.input_ids()));
+
+  constexpr int64_t kRowCount = 100;
+  std::vector<DenseArray<float>> inputs;
+  for (int i = 0; i < 5; ++i) {
+    DenseArrayBuilder<float> bldr(kRowCount);
+    for (int64_t row = 0; row < kRowCount; ++row) {
+      bldr.Set(row, absl::Uniform<float>(rnd, 0, 1));
+    }
+    inputs.push_back(std::move(bldr).Build());
+  }
+  EXPECT_THAT(Eval(*found, inputs, kRowCount),
+              ElementsAreArray(Eval(eval, inputs, kRowCount)));
+}
+
+TEST(ColumnarForestEvaluator, SharedSplitNodes) {
+  // Every split node points both children to the next one, so there are 2^63
+  // paths from the root, but the depth is computed in linear time.
+  constexpr int kSplitCount = 64;
+  constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+  constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments.resize(kSplitCount + 1, 0.0f);
+  trees[0].adjustments[0] = 1.0f;
+  trees[0].adjustments[1] = 2.0f;
+  for (int i = 0; i + 1 < kSplitCount; ++i) {
+    trees[0].split_nodes.push_back(
+        {S(i + 1), S(i + 1), IntervalSplit(0, 0.5, 1.5)});
+  }
+  trees[0].split_nodes.push_back({A(0), A(1), IntervalSplit(0, 0.5, 1.5)});
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  ASSERT_OK_AND_ASSIGN(auto eval, ColumnarForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+  std::string data = eval.SerializeAsFlatBuffer();
+  ASSERT_OK_AND_ASSIGN(auto loaded,
+                       ColumnarForestEvaluator::FromFlatBuffer(data));
+  EXPECT_THAT(Eval(loaded, {CreateDenseArray<float>({0, 1})}, 2),
+              ElementsAre(1.0f, 2.0f));
+
+  std::vector<DecisionTree> cyclic_trees(1);
+  cyclic_trees[0].adjustments = {0.0f, 0.0f, 0.0f};
+  cyclic_trees[0].split_nodes = {{S(1), A(0), IntervalSplit(0, 0.5, 1.5)},
+                                 {A(1), S(0), IntervalSplit(0, 0.5, 1.5)}};
+  ASSERT_OK_AND_ASSIGN(auto cyclic_forest,
+                       DecisionForest::FromTrees(std::move(cyclic_trees)));
+  EXPECT_THAT(
+      ColumnarForestEvaluator::Compile(*cyclic_forest, {TreeFilter()}),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("cycle")));
+}
+
+TEST(ColumnarForestEvaluator, CompareWithNaiveEvaluation) {
+  constexpr int64_t kRowCount = ColumnarForestEvaluator::kBlockSize * 3 + 17;
+  constexpr int kNumFeatures = 10;
+  absl::BitGen rnd;
+  auto forest = CreateRandomFloatForest(
+      &rnd, kNumFeatures, /*interactions=*/true, /*min_num_splits=*/0,
+      /*max_num_splits=*/31, /*num_trees=*/30);
+  ASSERT_OK_AND_ASSIGN(auto eval, ColumnarForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+  ASSERT_OK_AND_ASSIGN(auto not_quantized_eval,
+                       ColumnarForestEvaluator::Compile(
+                           *forest, {TreeFilter()},
+                           {.enable_quantization = false}));
+  ASSERT_FALSE(not_quantized_eval.is_quantized());
+
+  std::vector<DenseArray<float>> inputs;
+  for (int i = 0; i < kNumFeatures; ++i) {
+    DenseArrayBuilder<float> bldr(kRowCount);
+    for (int64_t row = 0; row < kRowCount; ++row) {
+      if (absl::Bernoulli(rnd, 0.8)) {
+        bldr.Set(row, absl::Uniform<float>(rnd, 0, 1));
+      }
+    }
+    // Slicing checks that bitmap_bit_offset is taken into account.
+    inputs.push_back(std::move(bldr).Build().Slice(1, kRowCount - 1));
+  }
+  std::vector<float> results = Eval(eval, inputs, kRowCount - 1);
+  EXPECT_THAT(Eval(not_quantized_eval, inputs, kRowCount - 1),
+              ElementsAreArray(results));
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  CreateSlotsForForest(*forest, &layout_builder, &slots);
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  for (int64_t row = 0; row < kRowCount - 1; ++row) {
+    for (int i = 0; i < slots.size(); ++i) {
+      if (slots[i].byte_offset() !=
+          FrameLayout::Slot<float>::kUninitializedOffset) {
+        frame.Set(slots[i].UnsafeToSlot<OptionalValue<float>>(),
+                  inputs[i][row]);
+      }
+    }
+    EXPECT_FLOAT_EQ(results[row],
+                    DecisionForestNaiveEvaluation(*forest, frame, slots));
+  }
+}
+
+}  // namespace
+}  // namespace arolla
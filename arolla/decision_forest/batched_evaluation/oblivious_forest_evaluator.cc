@@ -0,0 +1,163 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/oblivious_forest_evaluator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/batched_evaluation/columnar_forest_evaluator.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/pointwise_evaluation/oblivious.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/util/fast_dynamic_downcast_final.h"
+
+namespace arolla {
+
+namespace {
+
+using ::arolla::decision_forest_internal::UnpackColumn;
+
+const IntervalSplitCondition* AsIntervalSplit(const SplitCondition* cond) {
+  return fast_dynamic_downcast_final<const IntervalSplitCondition*>(cond);
+}
+
+bool IsSupportedTree(const std::optional<ObliviousDecisionTree>& tree) {
+  if (!tree.has_value() ||
+      tree->layer_splits.size() > ObliviousForestEvaluator::kMaxDepth) {
+    return false;
+  }
+  return std::all_of(tree->layer_splits.begin(), tree->layer_splits.end(),
+                     [](const auto& split) {
+                       return AsIntervalSplit(split.get()) != nullptr;
+                     });
+}
+
+}  // namespace
+
+bool ObliviousForestEvaluator::IsSupported(const DecisionForest& forest) {
+  for (const DecisionTree& tree : forest.GetTrees()) {
+    if (!IsSupportedTree(ToObliviousTree(tree))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<ObliviousForestEvaluator> ObliviousForestEvaluator::Compile(
+    const DecisionForest& forest, absl::Span<const TreeFilter> groups) {
+  ObliviousForestEvaluator res;
+  res.group_count_ = groups.size();
+  absl::flat_hash_map<int, int32_t> input_id_to_column;
+  for (const DecisionTree& tree : forest.GetTrees()) {
+    int32_t group = -1;
+    for (int32_t i = 0; i < groups.size(); ++i) {
+      if (groups[i](tree.tag)) {
+        group = i;
+        break;
+      }
+    }
+    if (group == -1) {
+      continue;
+    }
+    std::optional<ObliviousDecisionTree> oblivious_tree =
+        ToObliviousTree(tree);
+    if (!IsSupportedTree(oblivious_tree)) {
+      return absl::InvalidArgumentError(
+          "ObliviousForestEvaluator supports only oblivious trees with "
+          "IntervalSplitCondition");
+    }
+    res.trees_.push_back(
+        {.first_level = static_cast<int32_t>(res.levels_.size()),
+         .depth = static_cast<int32_t>(oblivious_tree->layer_splits.size()),
+         .first_leaf = static_cast<int32_t>(res.leaves_.size()),
+         .group = group});
+    for (const auto& split : oblivious_tree->layer_splits) {
+      const IntervalSplitCondition* cond = AsIntervalSplit(split.get());
+      auto [it, inserted] = input_id_to_column.emplace(
+          cond->input_id(), static_cast<int32_t>(res.input_ids_.size()));
+      if (inserted) {
+        res.input_ids_.push_back(cond->input_id());
+      }
+      res.levels_.push_back(
+          {.column = it->second, .left = cond->left(), .right = cond->right()});
+    }
+    // Already multiplied by the tree weight.
+    res.leaves_.insert(res.leaves_.end(), oblivious_tree->adjustments.begin(),
+                       oblivious_tree->adjustments.end());
+  }
+  return res;
+}
+
+void ObliviousForestEvaluator::Eval(
+    absl::Span<const DenseArray<float>* const> inputs, int64_t row_count,
+    absl::Span<const absl::Span<float>> outputs) const {
+  DCHECK_EQ(inputs.size(), input_ids_.size());
+  DCHECK_EQ(outputs.size(), group_count_);
+
+  std::vector<float> columns(input_ids_.size() * kBlockSize);
+  std::vector<uint32_t> leaf_ids(kBlockSize);
+  std::vector<double> sums(group_count_ * kBlockSize);
+
+  for (int64_t block_offset = 0; block_offset < row_count;
+       block_offset += kBlockSize) {
+    const int64_t n = std::min(kBlockSize, row_count - block_offset);
+    for (int64_t col = 0; col < inputs.size(); ++col) {
+      DCHECK_EQ(inputs[col]->size(), row_count);
+      UnpackColumn(*inputs[col], block_offset, n,
+                   columns.data() + col * kBlockSize);
+    }
+    std::fill(sums.begin(), sums.end(), 0.0);
+
+    for (const Tree& tree : trees_) {
+      // Leaves are numbered from the "all false" to the "all true" side, so
+      // the condition of the first level is the most significant bit.
+      std::fill(leaf_ids.begin(), leaf_ids.begin() + n, 0);
+      for (int32_t l = 0; l < tree.depth; ++l) {
+        const Level& level = levels_[tree.first_level + l];
+        const float* x = columns.data() + level.column * kBlockSize;
+        const float left = level.left;
+        const float right = level.right;
+        for (int64_t i = 0; i < n; ++i) {
+          leaf_ids[i] = (leaf_ids[i] << 1) |
+                        static_cast<uint32_t>((left <= x[i]) & (x[i] <= right));
+        }
+      }
+      const float* leaves = leaves_.data() + tree.first_leaf;
+      double* sum = sums.data() + tree.group * kBlockSize;
+      for (int64_t i = 0; i < n; ++i) {
+        sum[i] += leaves[leaf_ids[i]];
+      }
+    }
+
+    for (int g = 0; g < group_count_; ++g) {
+      DCHECK_EQ(outputs[g].size(), row_count);
+      const double* sum = sums.data() + g * kBlockSize;
+      float* out = outputs[g].data() + block_offset;
+      for (int64_t i = 0; i < n; ++i) {
+        out[i] = sum[i];
+      }
+    }
+  }
+}
+
+}  // namespace arolla
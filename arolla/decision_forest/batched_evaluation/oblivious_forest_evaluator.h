@@ -0,0 +1,86 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_BATCHED_EVALUATION_OBLIVIOUS_FOREST_EVALUATOR_H_
+#define AROLLA_DECISION_FOREST_BATCHED_EVALUATION_OBLIVIOUS_FOREST_EVALUATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/dense_array/dense_array.h"
+
+namespace arolla {
+
+// Batched evaluator for forests where all trees are oblivious (see
+// pointwise_evaluation/oblivious.h) and all splits are IntervalSplitCondition.
+//
+// Rows are processed in blocks of kBlockSize. For every tree the leaf index of
+// each row is built level by level: the split condition of the level is
+// evaluated for the whole block and shifted into the index
+// (`index = (index << 1) | condition`), so every level is one branchless
+// vectorized loop. Leaves of all trees are stored contiguously in one array.
+class ObliviousForestEvaluator {
+ public:
+  static constexpr int64_t kBlockSize = 256;
+  // Deeper trees are not supported (the leaf index is uint32_t).
+  static constexpr int kMaxDepth = 31;
+
+  // Returns true if all trees in the forest are oblivious with supported
+  // split conditions.
+  static bool IsSupported(const DecisionForest& forest);
+
+  // The "groups" argument has the same meaning as in
+  // BatchedForestEvaluator::Compile.
+  static absl::StatusOr<ObliviousForestEvaluator> Compile(
+      const DecisionForest& forest, absl::Span<const TreeFilter> groups);
+
+  // The inputs required by the forest, in the order expected by Eval.
+  absl::Span<const int> input_ids() const { return input_ids_; }
+
+  // Evaluates the forest on `row_count` rows. `inputs[i]` corresponds to the
+  // forest input `input_ids()[i]`. `outputs` should contain a span of size
+  // `row_count` for each group.
+  void Eval(absl::Span<const DenseArray<float>* const> inputs,
+            int64_t row_count,
+            absl::Span<const absl::Span<float>> outputs) const;
+
+ private:
+  struct Level {
+    int32_t column;
+    float left;
+    float right;
+  };
+
+  struct Tree {
+    int32_t first_level;
+    int32_t depth;
+    int32_t first_leaf;
+    int32_t group;
+  };
+
+  ObliviousForestEvaluator() = default;
+
+  std::vector<int> input_ids_;
+  std::vector<Level> levels_;
+  std::vector<float> leaves_;  // Multiplied by tree weight.
+  std::vector<Tree> trees_;
+  int group_count_ = 0;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_BATCHED_EVALUATION_OBLIVIOUS_FOREST_EVALUATOR_H_
@@ -0,0 +1,160 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/batched_evaluation/oblivious_forest_evaluator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/random/random.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/decision_forest/testing/test_util.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+
+std::vector<float> Eval(const ObliviousForestEvaluator& eval,
+                        absl::Span<const DenseArray<float>> inputs,
+                        int64_t row_count, int group_count = 1,
+                        int output_id = 0) {
+  std::vector<const DenseArray<float>*> input_ptrs;
+  for (int id : eval.input_ids()) {
+    input_ptrs.push_back(&inputs[id]);
+  }
+  std::vector<std::vector<float>> results(group_count,
+                                          std::vector<float>(row_count));
+  std::vector<absl::Span<float>> outputs;
+  for (auto& r : results) outputs.push_back(absl::MakeSpan(r));
+  eval.Eval(input_ptrs, row_count, outputs);
+  return results[output_id];
+}
+
+TEST(ObliviousForestEvaluator, IsSupported) {
+  std::vector<DecisionTree> trees(1);
+  trees[0].adjustments = {0, 1, 2, 3};
+  trees[0].split_nodes = {{S(1), S(2), IntervalSplit(0, 1, 5)},
+                          {A(0), A(1), IntervalSplit(1, 1, 5)},
+                          {A(2), A(3), IntervalSplit(1, 1, 5)}};
+  ASSERT_OK_AND_ASSIGN(auto forest, DecisionForest::FromTrees(
+                                        std::vector<DecisionTree>(trees)));
+  EXPECT_TRUE(ObliviousForestEvaluator::IsSupported(*forest));
+
+  // Different splits on the second level.
+  trees[0].split_nodes[2].condition = IntervalSplit(1, 2, 5);
+  ASSERT_OK_AND_ASSIGN(
+      forest, DecisionForest::FromTrees(std::vector<DecisionTree>(trees)));
+  EXPECT_FALSE(ObliviousForestEvaluator::IsSupported(*forest));
+}
+
+TEST(ObliviousForestEvaluator, Eval) {
+  std::vector<DecisionTree> trees(3);
+  trees[0].tag = {.submodel_id = 0};
+  trees[0].adjustments = {0.5, 1.5, 2.5, 3.5};
+  trees[0].split_nodes = {{S(1), S(2), IntervalSplit(0, 1.5, kInf)},
+                          {A(0), A(1), IntervalSplit(1, 1, 2)},
+                          {A(2), A(3), IntervalSplit(1, 1, 2)}};
+  trees[1].tag = {.submodel_id = 1};
+  trees[1].adjustments = {-1.0, 1.0};
+  trees[1].split_nodes = {{A(0), A(1), IntervalSplit(0, 1, 5)}};
+  trees[2].tag = {.submodel_id = 0};
+  trees[2].adjustments = {10.0};
+  trees[2].weight = 0.5;
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  std::vector<TreeFilter> groups{{.submodels = {0}}, {.submodels = {1}}};
+  ASSERT_OK_AND_ASSIGN(auto eval,
+                       ObliviousForestEvaluator::Compile(*forest, groups));
+  EXPECT_THAT(eval.input_ids(), ElementsAre(0, 1));
+
+  std::vector<DenseArray<float>> inputs = {
+      CreateDenseArray<float>({0, 0, 1.2, 1.6, 7.0, NAN, {}}),
+      CreateDenseArray<float>({3, 1, 1, 1, 3, {}, 1})};
+  EXPECT_THAT(Eval(eval, inputs, 7, 2, 0),
+              ElementsAre(5.5, 6.5, 6.5, 8.5, 7.5, 5.5, 6.5));
+  EXPECT_THAT(Eval(eval, inputs, 7, 2, 1),
+              ElementsAre(-1, -1, 1, 1, -1, -1, -1));
+}
+
+TEST(ObliviousForestEvaluator, CompareWithNaiveEvaluation) {
+  constexpr int64_t kRowCount = ObliviousForestEvaluator::kBlockSize * 3 + 17;
+  constexpr int kNumFeatures = 10;
+  absl::BitGen rnd;
+  std::vector<QTypePtr> types(kNumFeatures, GetOptionalQType<float>());
+  std::vector<DecisionTree> trees;
+  for (int i = 0; i < 20; ++i) {
+    int depth = absl::Uniform<int32_t>(rnd, 0, 10);
+    trees.push_back(CreateRandomObliviousTree(&rnd, depth, &types));
+    trees.back().weight = absl::Uniform<float>(rnd, 0.5, 1.5);
+  }
+  ASSERT_OK_AND_ASSIGN(auto forest,
+                       DecisionForest::FromTrees(std::move(trees)));
+  ASSERT_TRUE(ObliviousForestEvaluator::IsSupported(*forest));
+  ASSERT_OK_AND_ASSIGN(auto eval, ObliviousForestEvaluator::Compile(
+                                      *forest, {TreeFilter()}));
+
+  std::vector<DenseArray<float>> inputs;
+  for (int i = 0; i < kNumFeatures; ++i) {
+    DenseArrayBuilder<float> bldr(kRowCount);
+    for (int64_t row = 0; row < kRowCount; ++row) {
+      if (absl::Bernoulli(rnd, 0.8)) {
+        bldr.Set(row, absl::Uniform<float>(rnd, 0, 1));
+      }
+    }
+    inputs.push_back(std::move(bldr).Build());
+  }
+  std::vector<float> results = Eval(eval, inputs, kRowCount);
+
+  std::vector<TypedSlot> slots;
+  FrameLayout::Builder layout_builder;
+  CreateSlotsForForest(*forest, &layout_builder, &slots);
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  for (int64_t row = 0; row < kRowCount; ++row) {
+    for (int i = 0; i < slots.size(); ++i) {
+      if (slots[i].byte_offset() !=
+          FrameLayout::Slot<float>::kUninitializedOffset) {
+        frame.Set(slots[i].UnsafeToSlot<OptionalValue<float>>(),
+                  inputs[i][row]);
+      }
+    }
+    EXPECT_FLOAT_EQ(results[row],
+                    DecisionForestNaiveEvaluation(*forest, frame, slots));
+  }
+}
+
+}  // namespace
+}  // namespace arolla
@@ -17,21 +17,30 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "arolla/decision_forest/decision_forest.h"
 #include "arolla/decision_forest/split_conditions/interval_split_condition.h"
 #include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/invoke.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/tuple_qtype.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -101,5 +110,30 @@ TEST(DecisionForestOperatorTest, GetOutputQType) {
   }
 }
 
+TEST(DecisionForestOperatorTest, ParallelCompilation) {
+  ASSERT_OK_AND_ASSIGN(const DecisionForestPtr forest, CreateForest());
+  std::vector<absl::StatusOr<expr::ExprNodePtr>> forest_nodes;
+  for (int i = 0; i < 5; ++i) {
+    auto forest_op = std::make_shared<DecisionForestOperator>(
+        forest, std::vector<TreeFilter>{TreeFilter{.submodels = {i % 2}}});
+    forest_nodes.push_back(expr::CallOp(
+        forest_op, {expr::Leaf(absl::StrCat("x", i)), expr::Leaf("y")}));
+  }
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       expr::CallOp("core.make_tuple", forest_nodes));
+  absl::flat_hash_map<std::string, TypedValue> leaf_values = {
+      {"y", TypedValue::FromValue(OptionalValue<int64_t>(5))}};
+  for (int i = 0; i < 5; ++i) {
+    leaf_values.emplace(absl::StrCat("x", i),
+                        TypedValue::FromValue(OptionalValue<float>(i)));
+  }
+  ASSERT_OK_AND_ASSIGN(auto expected, expr::Invoke(expr, leaf_values));
+  StdThreading threading(4);
+  ASSERT_OK_AND_ASSIGN(
+      auto actual,
+      expr::Invoke(expr, leaf_values, {.threading = &threading}));
+  EXPECT_EQ(actual.GetFingerprint(), expected.GetFingerprint());
+}
+
 }  // namespace
 }  // namespace arolla
@@ -0,0 +1,218 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/expr_operator/fuse_decision_forests.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/tuple_expr_operator.h"
+#include "arolla/util/class_info.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+namespace {
+
+const DecisionForestOperator* GetForestOp(const expr::ExprNodePtr& node) {
+  if (!node->is_op()) {
+    return nullptr;
+  }
+  return FastDowncast<DecisionForestOperator>(node->op().get());
+}
+
+const expr::GetNthOperator* GetNthOp(const expr::ExprNodePtr& node) {
+  if (!node->is_op()) {
+    return nullptr;
+  }
+  return FastDowncast<const expr::GetNthOperator>(node->op().get());
+}
+
+Fingerprint DepsFingerprint(const expr::ExprNodePtr& node) {
+  FingerprintHasher hasher("::arolla::FuseDecisionForestOperators");
+  for (const auto& dep : node->node_deps()) {
+    hasher.Combine(dep->fingerprint());
+  }
+  return std::move(hasher).Finish();
+}
+
+// Creates a forest operator that evaluates all the given operators. Submodel
+// ids are renumbered so that trees of different forests never match the same
+// filter. Outputs of the operators are concatenated in the given order.
+absl::StatusOr<std::shared_ptr<DecisionForestOperator>> MergeForestOps(
+    absl::Span<const DecisionForestOperator* const> ops) {
+  std::vector<DecisionTree> trees;
+  std::vector<TreeFilter> filters;
+  int next_submodel_id = 0;
+  for (const DecisionForestOperator* op : ops) {
+    absl::flat_hash_map<int, int> submodel_ids;
+    for (const DecisionTree& tree : op->forest()->GetTrees()) {
+      auto [it, inserted] =
+          submodel_ids.emplace(tree.tag.submodel_id, next_submodel_id);
+      if (inserted) {
+        next_submodel_id++;
+      }
+      DecisionTree& new_tree = trees.emplace_back(tree);
+      new_tree.tag.submodel_id = it->second;
+    }
+    for (const TreeFilter& filter : op->tree_filters()) {
+      TreeFilter& new_filter = filters.emplace_back();
+      new_filter.step_range_from = filter.step_range_from;
+      new_filter.step_range_to = filter.step_range_to;
+      for (const auto& [old_id, new_id] : submodel_ids) {
+        if (filter.submodels.empty() || filter.submodels.contains(old_id)) {
+          new_filter.submodels.insert(new_id);
+        }
+      }
+      if (new_filter.submodels.empty()) {
+        // The filter doesn't match any tree. Use an id that is not assigned
+        // to any tree, since an empty set would mean "all submodels".
+        new_filter.submodels.insert(next_submodel_id++);
+      }
+    }
+  }
+  ASSIGN_OR_RETURN(DecisionForestPtr forest,
+                   DecisionForest::FromTrees(std::move(trees)));
+  return std::make_shared<DecisionForestOperator>(std::move(forest),
+                                                  std::move(filters));
+}
+
+}  // namespace
+
+absl::StatusOr<expr::ExprNodePtr> FuseDecisionForestOperators(
+    expr::ExprNodePtr expr) {
+  expr::PostOrder post_order(expr);
+
+  // Group forest operator nodes by their arguments.
+  struct Group {
+    std::vector<const DecisionForestOperator*> ops;
+    std::shared_ptr<DecisionForestOperator> fused_op;
+    expr::ExprNodePtr fused_node;  // Created on the first use.
+  };
+  std::vector<Group> groups;
+  absl::flat_hash_map<Fingerprint, size_t> group_ids;
+  // node index -> (group id, offset of the node outputs in the fused node)
+  absl::flat_hash_map<size_t, std::pair<size_t, int64_t>> fused_outputs;
+  for (size_t i = 0; i < post_order.nodes_size(); ++i) {
+    const auto& node = post_order.node(i);
+    const DecisionForestOperator* op = GetForestOp(node);
+    if (op == nullptr) {
+      continue;
+    }
+    auto [it, inserted] =
+        group_ids.emplace(DepsFingerprint(node), groups.size());
+    if (inserted) {
+      groups.emplace_back();
+    }
+    Group& group = groups[it->second];
+    int64_t offset = 0;
+    for (const DecisionForestOperator* prev_op : group.ops) {
+      offset += prev_op->tree_filters().size();
+    }
+    group.ops.push_back(op);
+    fused_outputs[i] = {it->second, offset};
+  }
+  bool has_fusion = false;
+  for (Group& group : groups) {
+    if (group.ops.size() < 2) {
+      continue;
+    }
+    auto fused_op = MergeForestOps(group.ops);
+    // Not an error (e.g. the forests have conflicting input types), the nodes
+    // are just evaluated separately.
+    if (fused_op.ok()) {
+      group.fused_op = *std::move(fused_op);
+      has_fusion = true;
+    }
+  }
+  if (!has_fusion) {
+    return expr;
+  }
+
+  // Returns the group and the output offset if the node was fused.
+  auto find_fused =
+      [&](size_t i) -> std::optional<std::pair<size_t, int64_t>> {
+    auto it = fused_outputs.find(i);
+    if (it == fused_outputs.end() ||
+        groups[it->second.first].fused_op == nullptr) {
+      return std::nullopt;
+    }
+    return it->second;
+  };
+  std::vector<expr::ExprNodePtr> results(post_order.nodes_size());
+  for (size_t i = 0; i < post_order.nodes_size(); ++i) {
+    const auto& node = post_order.node(i);
+    std::vector<expr::ExprNodePtr> deps;
+    bool has_modified_dep = false;
+    for (size_t k : post_order.dep_indices(i)) {
+      deps.push_back(results[k]);
+      has_modified_dep |= results[k] != post_order.node(k);
+    }
+    if (auto fused = find_fused(i)) {
+      auto [group_id, offset] = *fused;
+      Group& group = groups[group_id];
+      // All nodes in the group have the same deps, so the first one can
+      // create the fused node.
+      if (group.fused_node == nullptr) {
+        ASSIGN_OR_RETURN(group.fused_node,
+                         expr::MakeOpNode(group.fused_op, std::move(deps)));
+      }
+      std::vector<expr::ExprNodePtr> outputs;
+      for (size_t j = 0; j < GetForestOp(node)->tree_filters().size(); ++j) {
+        ASSIGN_OR_RETURN(auto get_nth_op,
+                         expr::GetNthOperator::Make(offset + j));
+        ASSIGN_OR_RETURN(outputs.emplace_back(),
+                         expr::MakeOpNode(get_nth_op, {group.fused_node}));
+      }
+      ASSIGN_OR_RETURN(results[i],
+                       expr::MakeOpNode(expr::MakeTupleOperator::Make(),
+                                        std::move(outputs)));
+    } else if (const auto* get_nth = GetNthOp(node);
+               get_nth != nullptr &&
+               find_fused(post_order.dep_indices(i)[0]).has_value()) {
+      // Take the output directly from the fused node rather than from the
+      // tuple above, so the tuple is not needed in the common case.
+      auto [group_id, offset] = *find_fused(post_order.dep_indices(i)[0]);
+      ASSIGN_OR_RETURN(auto get_nth_op,
+                       expr::GetNthOperator::Make(offset + get_nth->index()));
+      ASSIGN_OR_RETURN(
+          results[i],
+          expr::MakeOpNode(get_nth_op, {groups[group_id].fused_node}));
+    } else if (has_modified_dep) {
+      ASSIGN_OR_RETURN(results[i],
+                       expr::WithNewDependencies(node, std::move(deps)));
+    } else {
+      results[i] = node;
+    }
+  }
+  return results.back();
+}
+
+Fingerprint FuseDecisionForestOperatorsFingerprint() {
+  return FingerprintHasher("::arolla::FuseDecisionForestOperators").Finish();
+}
+
+}  // namespace arolla
@@ -0,0 +1,58 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DECISION_FOREST_EXPR_OPERATOR_FUSE_DECISION_FORESTS_H_
+#define AROLLA_DECISION_FOREST_EXPR_OPERATOR_FUSE_DECISION_FORESTS_H_
+
+#include "absl/status/statusor.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla {
+
+// Merges DecisionForestOperator nodes that are applied to the same list of
+// arguments into a single DecisionForestOperator node. Each of the original
+// nodes is replaced with a tuple of the corresponding outputs of the merged
+// node.
+//
+// Only nodes with identical argument lists (the same expressions in the same
+// order) are merged. Forests that share just some of the inputs, or get them
+// in a different order, are evaluated separately.
+//
+// The merged forest is compiled into one evaluator, so the split conditions
+// of all the forests are evaluated together (e.g. bitmask evaluation does one
+// lookup per input in the sorted thresholds of all forests).
+//
+// Nodes whose forests can not be merged (e.g. they require different types
+// for the same input) are left unchanged.
+//
+// The pass needs the lowered expression (ForestModel is expanded into
+// DecisionForestOperator only when the input types are known), so it should be
+// applied during the compilation:
+//
+//   ExprCompiler<Input, Output>()
+//       .SetExprGlobalOptimizer(FuseDecisionForestOperators,
+//                               FuseDecisionForestOperatorsFingerprint())
+//
+// or via DynamicEvaluationEngineOptions::global_optimizer.
+absl::StatusOr<expr::ExprNodePtr> FuseDecisionForestOperators(
+    expr::ExprNodePtr expr);
+
+// Identifies FuseDecisionForestOperators for the compiled expressions cache
+// (see DynamicEvaluationEngineOptions::optimizer_fingerprint).
+Fingerprint FuseDecisionForestOperatorsFingerprint();
+
+}  // namespace arolla
+
+#endif  // AROLLA_DECISION_FOREST_EXPR_OPERATOR_FUSE_DECISION_FORESTS_H_
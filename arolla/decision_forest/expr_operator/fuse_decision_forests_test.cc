@@ -0,0 +1,212 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/decision_forest/expr_operator/fuse_decision_forests.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
+#include "arolla/decision_forest/split_conditions/interval_split_condition.h"
+#include "arolla/decision_forest/split_conditions/set_of_values_split_condition.h"
+#include "arolla/expr/eval/dynamic_compiled_expr.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/eval/invoke.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/expr_operator_signature.h"
+#include "arolla/expr/expr_visitor.h"
+#include "arolla/expr/lambda_expr_operator.h"
+#include "arolla/expr/tuple_expr_operator.h"
+#include "arolla/memory/frame.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/qtype/typed_slot.h"
+#include "arolla/qtype/typed_value.h"
+#include "arolla/serving/expr_compiler.h"
+#include "arolla/util/class_info.h"
+
+namespace arolla {
+namespace {
+
+using ::arolla::expr::CallOp;
+using ::arolla::expr::ExprNodePtr;
+using ::arolla::expr::Leaf;
+using ::arolla::expr::Placeholder;
+
+constexpr float inf = std::numeric_limits<float>::infinity();
+constexpr auto S = DecisionTreeNodeId::SplitNodeId;
+constexpr auto A = DecisionTreeNodeId::AdjustmentId;
+
+absl::StatusOr<DecisionForestPtr> CreateForest(float threshold,
+                                               float adjustment) {
+  std::vector<DecisionTree> trees(2);
+  trees[0].adjustments = {0.5, 1.5, 2.5, adjustment};
+  trees[0].tag.submodel_id = 0;
+  trees[0].split_nodes = {
+      {S(1), S(2), IntervalSplit(0, threshold, inf)},
+      {A(0), A(1), SetOfValuesSplit<int64_t>(1, {5}, false)},
+      {A(2), A(3), IntervalSplit(0, -inf, 10)}};
+  trees[1].adjustments = {adjustment};
+  trees[1].tag.submodel_id = 1;
+  return DecisionForest::FromTrees(std::move(trees));
+}
+
+int CountForestOps(const ExprNodePtr& expr) {
+  int count = 0;
+  for (const auto& node : expr::VisitorOrder(expr)) {
+    if (node->is_op() &&
+        FastDowncast<DecisionForestOperator>(node->op().get()) != nullptr) {
+      count++;
+    }
+  }
+  return count;
+}
+
+TEST(FuseDecisionForestOperatorsTest, Fuse) {
+  ASSERT_OK_AND_ASSIGN(auto forest1, CreateForest(1.5, 3.5));
+  ASSERT_OK_AND_ASSIGN(auto forest2, CreateForest(2.5, 7.0));
+  auto op1 = std::make_shared<DecisionForestOperator>(
+      forest1, std::vector<TreeFilter>{{.submodels = {0}}, {}});
+  auto op2 = std::make_shared<DecisionForestOperator>(
+      forest2, std::vector<TreeFilter>{
+                   {.submodels = {1}}, {.submodels = {0}}, {.submodels = {7}}});
+  auto op3 = std::make_shared<DecisionForestOperator>(
+      forest2, std::vector<TreeFilter>{{}});
+  std::vector<ExprNodePtr> inputs = {Leaf("x"), Leaf("y")};
+  ASSERT_OK_AND_ASSIGN(auto node1, expr::MakeOpNode(op1, inputs));
+  ASSERT_OK_AND_ASSIGN(auto node2, expr::MakeOpNode(op2, inputs));
+  // Different inputs, so can not be fused with the other nodes.
+  ASSERT_OK_AND_ASSIGN(auto node3,
+                       expr::MakeOpNode(op3, {Leaf("z"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto expr, expr::MakeOpNode(expr::MakeTupleOperator::Make(),
+                                  {node1, node2, node3}));
+  ASSERT_OK_AND_ASSIGN(auto fused_expr, FuseDecisionForestOperators(expr));
+  EXPECT_EQ(CountForestOps(expr), 3);
+  EXPECT_EQ(CountForestOps(fused_expr), 2);
+
+  for (float x : {0.0f, 2.0f, 3.0f, 11.0f}) {
+    for (int64_t y : {1, 5}) {
+      absl::flat_hash_map<std::string, TypedValue> leaf_values = {
+          {"x", TypedValue::FromValue(OptionalValue<float>(x))},
+          {"y", TypedValue::FromValue(OptionalValue<int64_t>(y))},
+          {"z", TypedValue::FromValue(OptionalValue<float>(x + 1))}};
+      ASSERT_OK_AND_ASSIGN(auto expected, expr::Invoke(expr, leaf_values));
+      ASSERT_OK_AND_ASSIGN(auto actual, expr::Invoke(fused_expr, leaf_values));
+      ASSERT_EQ(actual.GetType(), expected.GetType());
+      for (int64_t i = 0; i < expected.GetFieldCount(); ++i) {
+        for (int64_t j = 0; j < expected.GetField(i).GetFieldCount(); ++j) {
+          EXPECT_FLOAT_EQ(actual.GetField(i).GetField(j).UnsafeAs<float>(),
+                          expected.GetField(i).GetField(j).UnsafeAs<float>())
+              << "x=" << x << ", y=" << y << ", output=(" << i << ", " << j
+              << ")";
+        }
+      }
+    }
+  }
+}
+
+TEST(FuseDecisionForestOperatorsTest, NothingToFuse) {
+  ASSERT_OK_AND_ASSIGN(auto forest, CreateForest(1.5, 3.5));
+  auto op = std::make_shared<DecisionForestOperator>(
+      forest, std::vector<TreeFilter>{{}});
+  ASSERT_OK_AND_ASSIGN(auto expr,
+                       expr::MakeOpNode(op, {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto fused_expr, FuseDecisionForestOperators(expr));
+  EXPECT_EQ(fused_expr->fingerprint(), expr->fingerprint());
+}
+
+TEST(FuseDecisionForestOperatorsTest, Compile) {
+  ASSERT_OK_AND_ASSIGN(auto forest1, CreateForest(1.5, 3.5));
+  ASSERT_OK_AND_ASSIGN(auto forest2, CreateForest(2.5, 7.0));
+  auto op1 = std::make_shared<DecisionForestOperator>(
+      forest1, std::vector<TreeFilter>{{.submodels = {0}}, {}});
+  auto op2 = std::make_shared<DecisionForestOperator>(
+      forest2, std::vector<TreeFilter>{{.submodels = {1}}});
+  std::vector<ExprNodePtr> inputs = {Placeholder("x"), Placeholder("y")};
+  ASSERT_OK_AND_ASSIGN(auto node1, expr::MakeOpNode(op1, inputs));
+  ASSERT_OK_AND_ASSIGN(auto node2, expr::MakeOpNode(op2, inputs));
+  // The forests are in different branches of the expression, so they are
+  // fused only by the global optimizer.
+  ASSERT_OK_AND_ASSIGN(
+      auto model_op,
+      expr::MakeLambdaOperator(
+          expr::ExprOperatorSignature::Make("x, y"),
+          CallOp("math.add",
+                 {CallOp("math.multiply",
+                         {CallOp(expr::GetNthOperator::Make(0), {node1}),
+                          CallOp(expr::GetNthOperator::Make(1), {node1})}),
+                  CallOp(expr::GetNthOperator::Make(0), {node2})})));
+
+  // Check that the compiled expression evaluates one forest.
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp(model_op, {Leaf("x"), Leaf("y")}));
+  for (bool fuse : {false, true}) {
+    expr::DynamicEvaluationEngineOptions options{
+        .collect_op_descriptions = true};
+    if (fuse) {
+      options.global_optimizer = FuseDecisionForestOperators;
+    }
+    FrameLayout::Builder layout_builder;
+    auto x_slot = layout_builder.AddSlot<OptionalValue<float>>();
+    auto y_slot = layout_builder.AddSlot<OptionalValue<int64_t>>();
+    ASSERT_OK_AND_ASSIGN(auto bound_expr,
+                         expr::CompileAndBindForDynamicEvaluation(
+                             options, &layout_builder, expr,
+                             {{"x", TypedSlot::FromSlot(x_slot)},
+                              {"y", TypedSlot::FromSlot(y_slot)}}));
+    const auto* dynamic_bound_expr =
+        dynamic_cast<const expr::eval_internal::DynamicBoundExpr*>(
+            bound_expr.get());
+    ASSERT_NE(dynamic_bound_expr, nullptr);
+    int forest_op_count = 0;
+    for (const auto& description :
+         dynamic_bound_expr->eval_op_descriptions()) {
+      forest_op_count +=
+          description.find("decision_forest") != std::string::npos;
+    }
+    EXPECT_EQ(forest_op_count, fuse ? 1 : 2) << "fuse=" << fuse;
+  }
+
+  // Check the results through ExprCompiler.
+  using Input = std::tuple<OptionalValue<float>, OptionalValue<int64_t>>;
+  ASSERT_OK_AND_ASSIGN(
+      auto model, (ExprCompiler<Input, float>()).CompileOperator(model_op));
+  ASSERT_OK_AND_ASSIGN(
+      auto fused_model,
+      (ExprCompiler<Input, float>())
+          .SetExprGlobalOptimizer(FuseDecisionForestOperators,
+                                  FuseDecisionForestOperatorsFingerprint())
+          .CompileOperator(model_op));
+  for (float x : {0.0f, 2.0f, 3.0f, 11.0f}) {
+    for (int64_t y : {1, 5}) {
+      ASSERT_OK_AND_ASSIGN(float expected, model(Input(x, y)));
+      ASSERT_OK_AND_ASSIGN(float actual, fused_model(Input(x, y)));
+      EXPECT_FLOAT_EQ(actual, expected) << "x=" << x << ", y=" << y;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace arolla
@@ -22,6 +22,7 @@
 
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 
@@ -40,6 +41,12 @@ class BitmaskEval {
   // to corresponding slots in output_ctx.
   virtual void IncrementalEval(ConstFramePtr input_ctx,
                                FramePtr output_ctx) const = 0;
+
+  // The same as IncrementalEval(frame, frame) for each of the frames, but
+  // evaluates several rows at once, keeping one tree mask per row in adjacent
+  // SIMD lanes.
+  virtual void IncrementalEvalBatch(
+      absl::Span<const FramePtr> frames) const = 0;
 };
 
 template <typename TreeMask>
@@ -47,11 +54,18 @@ class BitmaskEvalImpl : public BitmaskEval {
  public:
   static constexpr size_t kMaxRegionsForBitmask = sizeof(TreeMask) * 8;
 
+  // Number of rows processed together by IncrementalEvalBatch. Masks of
+  // a single tree for all the rows take 64 bytes (one AVX-512 register or two
+  // AVX2 registers).
+  static constexpr size_t kBatchLanes = 64 / sizeof(TreeMask);
+
   // Evaluates trees separately for each group and adds the result
   // to corresponding slots in output_ctx.
   void IncrementalEval(ConstFramePtr input_ctx,
                        FramePtr output_ctx) const final;
 
+  void IncrementalEvalBatch(absl::Span<const FramePtr> frames) const final;
+
  private:
   BitmaskEvalImpl() = default;
   friend class BitmaskBuilder;
@@ -166,19 +180,42 @@ class BitmaskEvalImpl : public BitmaskEval {
 
   absl::FixedArray<TreeMask> FindTreeMasks(ConstFramePtr ctx) const;
 
-  void ProcessLeftSplits(const LeftOrRightSplits& splits, ConstFramePtr ctx,
-                         absl::FixedArray<TreeMask>& tree_masks) const;
-  void ProcessRightSplits(const LeftOrRightSplits& splits, ConstFramePtr ctx,
-                          absl::FixedArray<TreeMask>& tree_masks) const;
-  void ProcessEqSplits(const EqSplits& eq_splits, ConstFramePtr ctx,
-                       absl::FixedArray<TreeMask>& tree_masks) const;
-  void ProcessRangeSplits(const RangeSplits& splits, ConstFramePtr ctx,
-                          absl::FixedArray<TreeMask>& tree_masks) const;
-
-  template <typename T>
-  void ProcessSetOfValuesSplits(const std::vector<SetOfValuesSplits<T>>& splits,
-                                ConstFramePtr ctx,
-                                absl::FixedArray<TreeMask>& tree_masks) const;
+  // Computes tree masks for up to kBatchLanes rows. The mask of the tree
+  // `tree_id` for the row `lane` is stored to
+  // `lane_masks[tree_id * kBatchLanes + lane]`.
+  void FindTreeMasksBatch(absl::Span<const FramePtr> frames,
+                          absl::Span<TreeMask> lane_masks) const;
+
+  // Applies all the splits to `rows` (at most kLanes of them). Tree masks of
+  // the rows are interleaved: the mask of the tree `tree_id` for `rows[i]` is
+  // `tree_masks[tree_id * kLanes + i]`. FindTreeMasks uses kLanes = 1.
+  template <size_t kLanes, typename Frame>
+  void FindTreeMasksForRows(absl::Span<const Frame> rows,
+                            TreeMask* tree_masks) const;
+
+  // Sums adjustments of the leaves selected by the tree masks for trees in
+  // `range`. `mask_fn(tree_id)` returns the mask of the tree.
+  template <typename MaskFn, typename LeafIdFn>
+  double SumAdjustments(MaskFn mask_fn, std::pair<int, int> range,
+                        LeafIdFn leaf_id_fn) const;
+
+  // Process*Splits functions apply the splits of one input to `rows`; the
+  // layout of `tree_masks` is the same as in FindTreeMasksForRows.
+  template <size_t kLanes, typename Frame, typename Compare>
+  void ProcessLeftOrRightSplits(const LeftOrRightSplits& splits,
+                                absl::Span<const Frame> rows, Compare compare,
+                                TreeMask* tree_masks) const;
+  template <size_t kLanes, typename Frame>
+  void ProcessEqSplits(const EqSplits& eq_splits, absl::Span<const Frame> rows,
+                       TreeMask* tree_masks) const;
+  template <size_t kLanes, typename Frame>
+  void ProcessRangeSplits(const RangeSplits& splits,
+                          absl::Span<const Frame> rows,
+                          TreeMask* tree_masks) const;
+  template <size_t kLanes, typename Frame, typename T>
+  void ProcessSetOfValuesSplits(const SetOfValuesSplits<T>& splits,
+                                absl::Span<const Frame> rows,
+                                TreeMask* tree_masks) const;
 
   template <typename ProcessFn>
   void InternalEval(ConstFramePtr input_ctx, FramePtr output_ctx,
@@ -266,4 +266,19 @@ void ForestEvaluator::Eval(const ConstFramePtr input_ctx,
   single_input_predictor_.IncrementalEval(input_ctx, output_ctx);
 }
 
+void ForestEvaluator::EvalBatch(absl::Span<const FramePtr> frames) const {
+  for (FramePtr frame : frames) {
+    for (size_t i = 0; i < output_slots_.size(); ++i) {
+      *frame.GetMutable(output_slots_[i]) =
+          regular_predictors_[i].Predict(frame);
+    }
+  }
+  if (bitmask_predictor_) {
+    bitmask_predictor_->IncrementalEvalBatch(frames);
+  }
+  for (FramePtr frame : frames) {
+    single_input_predictor_.IncrementalEval(frame, frame);
+  }
+}
+
 }  // namespace arolla
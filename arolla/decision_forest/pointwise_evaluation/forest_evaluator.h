@@ -65,6 +65,11 @@ class ForestEvaluator {
   // Evaluates the whole forest.
   void Eval(ConstFramePtr input_ctx, FramePtr output_ctx) const;
 
+  // The same as Eval(frame, frame) for each of the frames. Bitmask-based
+  // evaluation processes several rows at once, which is faster than calling
+  // Eval row by row.
+  void EvalBatch(absl::Span<const FramePtr> frames) const;
+
  private:
   template <class T>
   using Predictor = BoostedPredictor<float, T, std::plus<double>, int>;
@@ -185,19 +185,26 @@ void RandomTestAgainstReferenceImplementation(
     evaluators.push_back(std::move(evaluator));
   }
 
-  MemoryAllocation alloc(&layout);
-  FramePtr frame = alloc.frame();
-  for (int item_id = 0; item_id < 15; ++item_id) {
+  constexpr int kItemCount = 37;
+  std::vector<MemoryAllocation> allocs;
+  std::vector<FramePtr> frames;
+  std::vector<float> reference_res0, reference_res1;
+  for (int item_id = 0; item_id < kItemCount; ++item_id) {
+    FramePtr frame = allocs.emplace_back(&layout).frame();
+    frames.push_back(frame);
     for (auto slot : input_slots) {
       ASSERT_OK(FillWithRandomValue(slot, frame, rnd,
                                     /*missed_prob=*/0.25));
     }
-    float reference_implementation_res0 =
-        DecisionForestNaiveEvaluation(*forest, frame, input_slots, group0);
-    float reference_implementation_res1 =
-        DecisionForestNaiveEvaluation(*forest, frame, input_slots, group1);
-    for (int eval_id = 0; eval_id < evaluators.size(); ++eval_id) {
-      const ForestEvaluator& evaluator = evaluators[eval_id];
+    reference_res0.push_back(
+        DecisionForestNaiveEvaluation(*forest, frame, input_slots, group0));
+    reference_res1.push_back(
+        DecisionForestNaiveEvaluation(*forest, frame, input_slots, group1));
+  }
+  for (int eval_id = 0; eval_id < evaluators.size(); ++eval_id) {
+    const ForestEvaluator& evaluator = evaluators[eval_id];
+    for (int item_id = 0; item_id < kItemCount; ++item_id) {
+      FramePtr frame = frames[item_id];
 
       // Clear previous evaluator results
       frame.Set(outputs[0].slot, 0.0f);
@@ -205,12 +212,28 @@ void RandomTestAgainstReferenceImplementation(
 
       // Test Eval(frame, output_span)
       evaluator.Eval(frame, frame);
-      EXPECT_FLOAT_EQ(reference_implementation_res0, frame.Get(outputs[0].slot))
+      EXPECT_FLOAT_EQ(reference_res0[item_id], frame.Get(outputs[0].slot))
           << ErrFormat(loc, params[eval_id], "Incorrect output #0 in Eval",
                        item_id);
-      EXPECT_FLOAT_EQ(reference_implementation_res1, frame.Get(outputs[1].slot))
+      EXPECT_FLOAT_EQ(reference_res1[item_id], frame.Get(outputs[1].slot))
           << ErrFormat(loc, params[eval_id], "Incorrect output #1 in Eval",
                        item_id);
+
+      frame.Set(outputs[0].slot, 0.0f);
+      frame.Set(outputs[1].slot, 0.0f);
+    }
+
+    // Test EvalBatch(frames)
+    evaluator.EvalBatch(frames);
+    for (int item_id = 0; item_id < kItemCount; ++item_id) {
+      EXPECT_FLOAT_EQ(reference_res0[item_id],
+                      frames[item_id].Get(outputs[0].slot))
+          << ErrFormat(loc, params[eval_id], "Incorrect output #0 in EvalBatch",
+                       item_id);
+      EXPECT_FLOAT_EQ(reference_res1[item_id],
+                      frames[item_id].Get(outputs[1].slot))
+          << ErrFormat(loc, params[eval_id], "Incorrect output #1 in EvalBatch",
+                       item_id);
     }
   }
 }
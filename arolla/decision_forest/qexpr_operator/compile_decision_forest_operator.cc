@@ -16,7 +16,9 @@
 
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
 #include "arolla/decision_forest/qexpr_operator/batched_operator.h"
 #include "arolla/decision_forest/qexpr_operator/pointwise_operator.h"
@@ -34,21 +36,15 @@ namespace arolla {
 namespace {
 
 using ::arolla::expr::eval_internal::CompileOperatorFnArgs;
+using ::arolla::expr::eval_internal::PrecompileOperatorFnArgs;
 
-std::optional<absl::Status> CompileDecisionForestOperator(
-    const CompileOperatorFnArgs& args) {
-  auto* forest_op = FastDowncast<DecisionForestOperator>(args.decayed_op.get());
-  if (forest_op == nullptr) {
-    return std::nullopt;
-  }
-
-  auto input_types = SlotsToTypes(args.input_slots);
-  auto output_type = args.output_slot.GetType();
+absl::StatusOr<OperatorPtr> CreateDecisionForestOperator(
+    const DecisionForestOperator& forest_op,
+    absl::Span<const QTypePtr> input_types, QTypePtr output_type) {
   auto forest_op_signature =
       QExprOperatorSignature::Get(input_types, output_type);
 
-  if (!IsTupleQType(args.output_slot.GetType()) ||
-      output_type->type_fields().empty()) {
+  if (!IsTupleQType(output_type) || output_type->type_fields().empty()) {
     return absl::InternalError(
         absl::StrFormat("incorrectly deduced DecisionForest output type: %s",
                         output_type->name()));
@@ -56,19 +52,47 @@ std::optional<absl::Status> CompileDecisionForestOperator(
   bool is_pointwise =
       !IsArrayLikeQType(output_type->type_fields()[0].GetType());
 
-  OperatorPtr op;
   if (is_pointwise) {
-    ASSIGN_OR_RETURN(op, CreatePointwiseDecisionForestOperator(
-                             forest_op->forest(), forest_op_signature,
-                             forest_op->tree_filters()));
+    return CreatePointwiseDecisionForestOperator(forest_op.forest(),
+                                                 forest_op_signature,
+                                                 forest_op.tree_filters());
   } else {
-    ASSIGN_OR_RETURN(op, CreateBatchedDecisionForestOperator(
-                             forest_op->forest(), forest_op_signature,
-                             forest_op->tree_filters()));
+    return CreateBatchedDecisionForestOperator(forest_op.forest(),
+                                               forest_op_signature,
+                                               forest_op.tree_filters());
+  }
+}
+
+// Compiling a forest can take a while, so it is done ahead of binding if the
+// compiler is allowed to use threads.
+std::optional<absl::StatusOr<OperatorPtr>> PrecompileDecisionForestOperator(
+    const PrecompileOperatorFnArgs& args) {
+  auto* forest_op = FastDowncast<DecisionForestOperator>(args.decayed_op.get());
+  if (forest_op == nullptr) {
+    return std::nullopt;
+  }
+  return CreateDecisionForestOperator(*forest_op, args.input_types,
+                                      args.output_type);
+}
+
+std::optional<absl::Status> CompileDecisionForestOperator(
+    const CompileOperatorFnArgs& args) {
+  auto* forest_op = FastDowncast<DecisionForestOperator>(args.decayed_op.get());
+  if (forest_op == nullptr) {
+    return std::nullopt;
+  }
+
+  OperatorPtr op;
+  if (args.precompiled_op == nullptr) {
+    ASSIGN_OR_RETURN(op, CreateDecisionForestOperator(
+                             *forest_op, SlotsToTypes(args.input_slots),
+                             args.output_slot.GetType()));
   }
+  const QExprOperator& qexpr_op =
+      args.precompiled_op != nullptr ? *args.precompiled_op : *op;
 
   return args.executable_builder
-      ->BindEvalOp(*op, args.input_slots, args.output_slot,
+      ->BindEvalOp(qexpr_op, args.input_slots, args.output_slot,
                    "anonymous.decision_forest_operator", args.node)
       .status();
 }
@@ -80,8 +104,11 @@ AROLLA_INITIALIZER(
                 ::arolla::initializer_dep::kQExprOperators,
             },
         .init_fn = [] {
-          arolla::expr::eval_internal::CompilerExtensionRegistry::GetInstance()
-              .RegisterCompileOperatorFn(CompileDecisionForestOperator);
+          auto& registry = arolla::expr::eval_internal::
+              CompilerExtensionRegistry::GetInstance();
+          registry.RegisterPrecompileOperatorFn(
+              PrecompileDecisionForestOperator);
+          registry.RegisterCompileOperatorFn(CompileDecisionForestOperator);
         })
 
 }  // namespace
@@ -16,6 +16,7 @@
 #define AROLLA_DENSE_ARRAY_BITMAP_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -287,15 +288,16 @@ class Builder {
 
     int bit_offset = current_bit_ & (kWordBitCount - 1);
     int64_t offset = 0;
+    bool all_present = all_present_;
 
     if (bit_offset == 0) {
       Word* data =
           bldr_.GetMutableSpan().begin() + (current_bit_ / kWordBitCount);
       for (; offset + kWordBitCount <= count; offset += kWordBitCount) {
-        *(data++) = Group(kWordBitCount, init_group_fn(offset));
+        *(data++) = Group(kWordBitCount, init_group_fn(offset), all_present);
       }
       if (offset < count) {
-        *data = Group(count - offset, init_group_fn(offset));
+        *data = Group(count - offset, init_group_fn(offset), all_present);
       }
     } else {
       RawSpan<Word> data = bldr_.GetMutableSpan();
@@ -307,15 +309,52 @@ class Builder {
         }
       };
       for (; offset + kWordBitCount <= count; offset += kWordBitCount) {
-        add_word_fn(Group(kWordBitCount, init_group_fn(offset)));
+        add_word_fn(Group(kWordBitCount, init_group_fn(offset), all_present));
       }
       if (offset < count) {
-        add_word_fn(Group(count - offset, init_group_fn(offset)));
+        add_word_fn(Group(count - offset, init_group_fn(offset), all_present));
       }
     }
+    all_present_ = all_present;
     current_bit_ += count;
   }
 
+  // Same as AddByGroups, but sets the bits [first_bit, first_bit + count)
+  // instead of appending them. Several threads can call it concurrently if
+  // their ranges don't share words, i.e. start at a multiple of kWordBitCount
+  // and end at a multiple of kWordBitCount or at the end of the bitmap.
+  // A range that starts in the middle of a word must be set after the range
+  // that ends there. Must not be mixed with AddByGroups.
+  template <typename Fn>
+  void SetByGroups(int64_t first_bit, int64_t count, Fn&& init_group_fn) {
+    DCHECK_GE(first_bit, 0);
+    DCHECK_LE(first_bit + count,
+              bldr_.GetMutableSpan().size() * kWordBitCount);
+    RawSpan<Word> data = bldr_.GetMutableSpan();
+    int bit_offset = first_bit & (kWordBitCount - 1);
+    bool all_present = true;
+    for (int64_t offset = 0; offset < count; offset += kWordBitCount) {
+      int group_size = std::min<int64_t>(kWordBitCount, count - offset);
+      Word w = Group(group_size, init_group_fn(offset), all_present);
+      size_t word_id = (first_bit + offset) / kWordBitCount;
+      if (bit_offset == 0) {
+        data[word_id] = w;
+      } else {
+        // Unlike AddByGroups, the next word is written only if the group
+        // spills into it, because it can belong to another range.
+        data[word_id] |= w << bit_offset;
+        if (bit_offset + group_size > kWordBitCount) {
+          data[word_id + 1] = w >> (kWordBitCount - bit_offset);
+        }
+      }
+    }
+    if (!all_present) {
+      // The flag is only ever reset, so concurrent calls don't conflict.
+      std::atomic_ref<bool>(all_present_)
+          .store(false, std::memory_order_relaxed);
+    }
+  }
+
   // Adds `std::size(c)` elements to the Bitmap.
   // For each `value` in the container `fn(value) -> bool` is called and boolean
   // result is used to generate bits.
@@ -335,6 +374,16 @@ class Builder {
     });
   }
 
+  // Sets `std::size(c)` bits starting from `first_bit`. See SetByGroups for
+  // the thread-safety requirements.
+  template <typename Container, typename Fn>
+  void SetForEach(int64_t first_bit, const Container& c, Fn&& fn) {
+    SetByGroups(first_bit, std::size(c), [&](int64_t offset) {
+      auto g = std::begin(c) + offset;
+      return [&fn, g](int i) { return fn(g[i]); };
+    });
+  }
+
   Bitmap Build() && {
     if (all_present_) return Bitmap();
     return std::move(bldr_).Build();
@@ -342,13 +391,13 @@ class Builder {
 
  private:
   template <typename Fn>
-  Word Group(int count, Fn&& fn) {
+  static Word Group(int count, Fn&& fn, bool& all_present) {
     Word res = 0;
     for (int i = 0; i < count; ++i) {
       if (fn(i)) {
         res |= (1 << i);
       } else {
-        all_present_ = false;
+        all_present = false;
       }
     }
     return res;
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -300,6 +301,48 @@ TEST(BuilderTest, AddForEachMany) {
   TEST_BITS(std::move(b).Build(), is_5_divisible, kMaxN);
 }
 
+TEST(BuilderTest, SetForEachConcurrently) {
+  constexpr int kN = 4027;
+  constexpr int kThreadCount = 3;
+  constexpr int kBlockSize = 2 * kWordBitCount;
+  std::vector<int> v(kN);
+  for (int n = 0; n < kN; ++n) {
+    v[n] = n;
+  }
+  auto is_5_divisible = [](int x) { return x % 5 == 0; };
+  for (int chunk_size : {1, 7, kWordBitCount, kBlockSize}) {
+    Builder b(kN);
+    // Every thread sets its own blocks of bits, in unaligned chunks.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+      threads.emplace_back([&, t] {
+        for (int block = t * kBlockSize; block < kN;
+             block += kThreadCount * kBlockSize) {
+          int block_end = std::min(kN, block + kBlockSize);
+          for (int beg = block; beg < block_end; beg += chunk_size) {
+            b.SetForEach(beg,
+                         absl::MakeConstSpan(
+                             v.data() + beg,
+                             std::min(chunk_size, block_end - beg)),
+                         is_5_divisible);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    TEST_BITS(std::move(b).Build(), is_5_divisible, kN);
+  }
+}
+
+TEST(BuilderTest, SetForEachFull) {
+  Builder builder(100);
+  builder.SetForEach(64, std::vector<int>(36), [](int) { return true; });
+  builder.SetForEach(0, std::vector<int>(64), [](int) { return true; });
+  EXPECT_TRUE(std::move(builder).Build().empty());
+}
+
 TEST(BuilderTest, Full) {
   Builder builder(10);
   builder.AddForEach(std::vector<int>(10), [](int) { return true; });
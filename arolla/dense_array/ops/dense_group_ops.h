@@ -15,28 +15,88 @@
 #ifndef AROLLA_DENSE_ARRAY_OPS_DENSE_GROUP_OPS_H_
 #define AROLLA_DENSE_ARRAY_OPS_DENSE_GROUP_OPS_H_
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/log/check.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/ops/util.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/memory/simple_buffer.h"
+#include "arolla/util/algorithms.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/threading.h"
+#include "arolla/util/unit.h"
 #include "arolla/util/view_types.h"
 
 namespace arolla {
 
+// Options of DenseGroupOps.
+struct DenseGroupOpsOptions {
+  // If set, independent parts of the computation may run on threads started
+  // by `threading`. In this case every thread uses its own copy of the
+  // accumulator (made by the copy constructor), so the copies must not share
+  // mutable state, e.g. via pointers or shared_ptr members. Accumulators that
+  // do are only safe with `threading` unset.
+  ThreadingInterface* absl_nullable threading = nullptr;
+
+  // Max number of threads to use. 0 means
+  // threading->GetRecommendedThreadCount().
+  int thread_count = 0;
+
+  // Group operations over SPLIT_POINTS edges are split into shards with
+  // disjoint ranges of parents and processed in parallel. Each shard covers at
+  // least this number of rows (parent and child rows together).
+  int64_t min_rows_per_shard = 1 << 16;
+
+  // With `threading` set, aggregations over MAPPING edges with so many groups
+  // that the accumulators take more than `mapping_partitioning_min_bytes`
+  // (i.e. do not fit into the last level cache) first partition the child
+  // rows by parent, so that the accumulators of a single partition take at
+  // most `mapping_partition_bytes` (i.e. fit into L2 cache), and then process
+  // the partitions in parallel. Partitioning also requires at least as many
+  // child rows as groups, so that it pays off the additional passes over the
+  // child rows. It is not used without `threading`: in a single thread the
+  // additional passes cost about as much as the cache misses they save.
+  int64_t mapping_partitioning_min_bytes = int64_t{64} << 20;
+  int64_t mapping_partition_bytes = int64_t{1} << 20;
+};
+
 namespace dense_ops_internal {
 
+// True if Accumulator defines AddRange and AddMaskedRange for the only child
+// argument (see "Range additions" in qexpr/aggregation_ops_interface.h).
+template <class Accumulator, class ChildTypes>
+constexpr bool kSupportsRangeAdd = false;
+
+template <class Accumulator, class ChildT>
+constexpr bool kSupportsRangeAdd<Accumulator, meta::type_list<ChildT>> =
+    (std::is_same_v<Buffer<ChildT>, SimpleBuffer<ChildT>> ||
+     std::is_same_v<ChildT, Unit>) &&
+    requires(Accumulator& accumulator, absl::Span<const ChildT> values,
+             bitmap::Word mask) {
+      accumulator.AddRange(values);
+      accumulator.AddMaskedRange(values, mask);
+    };
+
 template <class Accumulator, class ParentTypes, class ChildTypes,
           bool ForwardId = false>
 class DenseGroupOpsImpl;
@@ -52,6 +112,12 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   static constexpr bool kIsAggregator = Accumulator::IsAggregator();
   static constexpr bool kIsPartial = Accumulator::IsPartial();
   static constexpr bool kIsFull = Accumulator::IsFull();
+  // Contiguous ranges of child rows are added by AddRange/AddMaskedRange.
+  static constexpr bool kUseRangeAdd =
+      kIsAggregator && !ForwardId &&
+      kSupportsRangeAdd<Accumulator, meta::type_list<ChildTs...>>;
+  // Scattering child rows into more partitions thrashes the TLB.
+  static constexpr int64_t kMaxMappingPartitionCount = 1024;
 
  public:
   // DenseGroupOps constructor.
@@ -61,10 +127,13 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
   //  `empty_accumulator` is an Accumulator instance used as a prototype for
   //      creating new accumulators. Note that a given accumulator may be used
   //      for multiple groups within a single operation.
+  //  `options` are threading and tuning options.
   explicit DenseGroupOpsImpl(RawBufferFactory* buffer_factory,
-                             Accumulator empty_accumulator = Accumulator())
+                             Accumulator empty_accumulator = Accumulator(),
+                             DenseGroupOpsOptions options = {})
       : buffer_factory_(buffer_factory),
-        empty_accumulator_(std::move(empty_accumulator)) {}
+        empty_accumulator_(std::move(empty_accumulator)),
+        options_(options) {}
 
   // Applies this group operator.
   //
@@ -109,7 +178,12 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     Accumulator accumulator = empty_accumulator_;
     accumulator.Reset(p_args...);
 
-    if constexpr (kIsAggregator) {
+    if constexpr (kUseRangeAdd) {
+      AddRangeOfRows(accumulator, 0, edge.child_size(), c_args...);
+      auto res = accumulator.GetResult();
+      RETURN_IF_ERROR(accumulator.GetStatus());
+      return typename Accumulator::result_type(std::move(res));
+    } else if constexpr (kIsAggregator) {
       auto fn = [&](int64_t child_id, bool child_row_valid,
                     view_type_t<ChildTs>... args) {
         if (child_row_valid) {
@@ -201,8 +275,12 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
         builder.Set(child_id, accumulator.GetResult());
       }
     };
-    MappingAndChildUtil::Iterate(process_child_row_fn, 0, child_row_count,
-                                 mapping, c_values...);
+    if (UseMappingPartitions(parent_row_count, child_row_count)) {
+      AddByMappingPartitions(mapping, valid_groups, accumulators, c_values...);
+    } else {
+      MappingAndChildUtil::Iterate(process_child_row_fn, 0, child_row_count,
+                                   mapping, c_values...);
+    }
 
     // full accumulator output.
     if constexpr (kIsFull) {
@@ -235,6 +313,116 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     return std::move(builder).Build();
   }
 
+  bool UseMappingPartitions(int64_t parent_row_count,
+                            int64_t child_row_count) const {
+    // Partitioning changes the order in which different groups get their child
+    // rows, so it is only used when the order is not observable.
+    if constexpr (kIsAggregator && !ForwardId) {
+      return options_.threading != nullptr &&
+             parent_row_count * sizeof(Accumulator) >
+                 options_.mapping_partitioning_min_bytes &&
+             child_row_count >= parent_row_count &&
+             child_row_count <= std::numeric_limits<int32_t>::max();
+    } else {
+      return false;
+    }
+  }
+
+  // Adds the child rows to `accumulators` partition by partition, where
+  // a partition covers a range of parents with accumulators that fit into the
+  // cache. Only the 32-bit ids of the child rows are partitioned, in
+  // increasing order within a partition, so that processing of a partition
+  // reads the child values in a single forward pass. The partitioning is
+  // stable, so every accumulator gets its rows in the original order.
+  void AddByMappingPartitions(const DenseArray<int64_t>& mapping,
+                              const std::vector<bool>& valid_groups,
+                              std::vector<Accumulator>& accumulators,
+                              const AsDenseArray<ChildTs>&... c_values) const {
+    using MappingAndChildUtil =
+        DenseOpsUtil<meta::type_list<int64_t, ChildTs...>>;
+    const int64_t parent_row_count = accumulators.size();
+    const int64_t child_row_count = mapping.size();
+
+    // Partition of a parent is `parent_id >> shift`.
+    int shift = absl::bit_width(static_cast<uint64_t>(std::max<int64_t>(
+                    options_.mapping_partition_bytes / sizeof(Accumulator),
+                    1))) -
+                1;
+    while (((parent_row_count - 1) >> shift) >= kMaxMappingPartitionCount) {
+      ++shift;
+    }
+    const int64_t partition_count = ((parent_row_count - 1) >> shift) + 1;
+
+    // Counting sort of the ids of the child rows to add by partition.
+    std::vector<int64_t> partition_offsets(partition_count + 1, 0);
+    MappingAndChildUtil::Iterate(
+        [&](int64_t child_id, bool valid, int64_t parent_id,
+            view_type_t<ChildTs>... args) {
+          if (valid && valid_groups[parent_id]) {
+            ++partition_offsets[(parent_id >> shift) + 1];
+          }
+        },
+        0, child_row_count, mapping, c_values...);
+    std::partial_sum(partition_offsets.begin(), partition_offsets.end(),
+                     partition_offsets.begin());
+    std::vector<int32_t> child_ids(partition_offsets.back());
+    {
+      std::vector<int64_t> positions(partition_offsets.begin(),
+                                     partition_offsets.end() - 1);
+      MappingAndChildUtil::Iterate(
+          [&](int64_t child_id, bool valid, int64_t parent_id,
+              view_type_t<ChildTs>... args) {
+            if (valid && valid_groups[parent_id]) {
+              child_ids[positions[parent_id >> shift]++] = child_id;
+            }
+          },
+          0, child_row_count, mapping, c_values...);
+    }
+
+    // Partitions use disjoint ranges of `accumulators`, so can be processed
+    // concurrently.
+    auto process_partition_fn = [&](int64_t partition) {
+      for (int64_t i = partition_offsets[partition];
+           i < partition_offsets[partition + 1]; ++i) {
+        const int64_t child_id = child_ids[i];
+        // Child ids are not forwarded in this mode.
+        Add(accumulators[mapping.values[child_id]], /*child_id=*/-1,
+            GetChildValue<ChildTs>(c_values, child_id)...);
+      }
+    };
+    if (partition_count == 1) {
+      process_partition_fn(0);
+      return;
+    }
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(partition_count);
+    for (int64_t partition = 0; partition < partition_count; ++partition) {
+      tasks.push_back([&process_partition_fn, partition] {
+        process_partition_fn(partition);
+      });
+    }
+    ExecuteTasksInParallel(*options_.threading, ThreadCount(), tasks);
+  }
+
+  // Returns the `Add` argument for a child row with all required values
+  // present.
+  template <class ChildT>
+  static view_type_t<ChildT> GetChildValue(const AsDenseArray<ChildT>& values,
+                                           int64_t child_id) {
+    if constexpr (meta::is_wrapped_with<OptionalValue, ChildT>::value) {
+      return values[child_id];
+    } else {
+      return values.values[child_id];
+    }
+  }
+
+  int ThreadCount() const {
+    DCHECK_NE(options_.threading, nullptr);
+    return options_.thread_count > 0
+               ? options_.thread_count
+               : options_.threading->GetRecommendedThreadCount();
+  }
+
   // Applies this group operator using a `splits` mapping from parent to child
   // row ids. `splits` is a DenseArray having a row_count which is one greater
   // than the parent index. It defines a mapping wherein parent id P corresponds
@@ -250,30 +438,101 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
       return absl::InvalidArgumentError(
           "splits row count is not compatible with parent row count");
     }
+    int64_t shard_count = 1;
+    if (options_.threading != nullptr) {
+      shard_count = std::min<int64_t>(
+          ThreadCount(), (parent_row_count + child_row_count) /
+                             std::max<int64_t>(options_.min_rows_per_shard, 1));
+    }
+    if (shard_count <= 1) {
+      return ApplyWithSplitPointsToRange(0, parent_row_count, splits,
+                                         buffer_factory_, p_values...,
+                                         c_values...);
+    }
 
-    const int64_t result_row_count =
-        kIsAggregator ? parent_row_count : child_row_count;
-    DenseArrayBuilder<ResT> builder(result_row_count, buffer_factory_);
+    // Shard boundaries balance the total number of parent and child rows.
+    absl::Span<const int64_t> split_values = splits.values.span();
+    const int64_t total_row_count = parent_row_count + child_row_count;
+    std::vector<int64_t> shard_parents(shard_count + 1, 0);
+    shard_parents.back() = parent_row_count;
+    for (int64_t shard = 1; shard < shard_count; ++shard) {
+      const int64_t target = total_row_count / shard_count * shard;
+      int64_t lo = shard_parents[shard - 1];
+      int64_t hi = parent_row_count;
+      while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (mid + split_values[mid] < target) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      shard_parents[shard] = lo;
+    }
+
+    std::vector<absl::StatusOr<DenseArray<ResT>>> shard_results(shard_count);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(shard_count);
+    for (int64_t shard = 0; shard < shard_count; ++shard) {
+      tasks.push_back([&, shard] {
+        // `buffer_factory_` is not necessarily thread-safe, so the shards use
+        // the heap, and the results are copied by ConcatShards.
+        shard_results[shard] = ApplyWithSplitPointsToRange(
+            shard_parents[shard], shard_parents[shard + 1], splits,
+            GetHeapBufferFactory(), p_values..., c_values...);
+      });
+    }
+    ExecuteTasksInParallel(*options_.threading, ThreadCount(), tasks);
+
+    std::vector<DenseArray<ResT>> shards;
+    shards.reserve(shard_count);
+    for (auto& shard_result : shard_results) {
+      // Returns the error of the first failed shard, the same way as
+      // the sequential evaluation stops on the first error.
+      RETURN_IF_ERROR(shard_result.status());
+      shards.push_back(*std::move(shard_result));
+    }
+    return ConcatShards(shards);
+  }
+
+  // Applies this group operator to the parents [parent_from, parent_to) and
+  // their children. The result contains only the rows of this range.
+  absl::StatusOr<DenseArray<ResT>> ApplyWithSplitPointsToRange(
+      int64_t parent_from, int64_t parent_to,
+      const DenseArray<int64_t>& splits, RawBufferFactory* buffer_factory,
+      const AsDenseArray<ParentTs>&... p_values,
+      const AsDenseArray<ChildTs>&... c_values) const {
+    const int64_t result_from =
+        kIsAggregator ? parent_from : splits.values[parent_from];
+    const int64_t result_to =
+        kIsAggregator ? parent_to : splits.values[parent_to];
+    DenseArrayBuilder<ResT> builder(result_to - result_from, buffer_factory);
     std::vector<int64_t> processed_rows;
     Accumulator accumulator = empty_accumulator_;
 
-    ParentUtil::IterateFromZero(
-        [&](int64_t parent_id, bool parent_valid,
-            view_type_t<ParentTs>... args) {
-          if (parent_valid) {
-            accumulator.Reset(args...);
-            ProcessSingleGroupWithSplitPoints(parent_id, splits, c_values...,
-                                              processed_rows, accumulator,
-                                              builder);
-          }
-        },
-        parent_row_count, p_values...);
+    auto fn = [&](int64_t parent_id, bool parent_valid,
+                  view_type_t<ParentTs>... args) {
+      if (parent_valid) {
+        accumulator.Reset(args...);
+        ProcessSingleGroupWithSplitPoints(parent_id, result_from, splits,
+                                          c_values..., processed_rows,
+                                          accumulator, builder);
+      }
+    };
+    if (parent_from == 0) {
+      ParentUtil::IterateFromZero(fn, parent_to, p_values...);
+    } else {
+      ParentUtil::Iterate(fn, parent_from, parent_to, p_values...);
+    }
     RETURN_IF_ERROR(accumulator.GetStatus());
     return std::move(builder).Build();
   }
 
+  // Processes a single group. The builder contains the results starting from
+  // row `result_offset`.
   void ProcessSingleGroupWithSplitPoints(
-      int64_t parent_id, const DenseArray<int64_t>& splits,
+      int64_t parent_id, int64_t result_offset,
+      const DenseArray<int64_t>& splits,
       const AsDenseArray<ChildTs>&... c_values,
       std::vector<int64_t>& processed_rows, Accumulator& accumulator,
       DenseArrayBuilder<ResT>& builder) const {
@@ -282,12 +541,18 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     int64_t child_from = splits.values[parent_id];
     int64_t child_to = splits.values[parent_id + 1];
 
+    if constexpr (kUseRangeAdd) {
+      AddRangeOfRows(accumulator, child_from, child_to, c_values...);
+      builder.Set(parent_id - result_offset, accumulator.GetResult());
+      return;
+    }
+
     auto fn = [&](int64_t child_id, bool child_row_valid,
                   view_type_t<ChildTs>... args) {
       if (child_row_valid) {
         Add(accumulator, child_id, args...);
         if constexpr (kIsPartial) {
-          builder.Set(child_id, accumulator.GetResult());
+          builder.Set(child_id - result_offset, accumulator.GetResult());
         } else if constexpr (kIsFull) {
           // push back the child row id for post-processing
           processed_rows.push_back(child_id);
@@ -297,16 +562,91 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
     ChildUtil::Iterate(fn, child_from, child_to, c_values...);
 
     if constexpr (kIsAggregator) {
-      builder.Set(parent_id, accumulator.GetResult());
+      builder.Set(parent_id - result_offset, accumulator.GetResult());
     } else if constexpr (kIsFull) {
       accumulator.FinalizeFullGroup();
       for (int64_t row_id : processed_rows) {
-        builder.Set(row_id, accumulator.GetResult());
+        builder.Set(row_id - result_offset, accumulator.GetResult());
       }
       processed_rows.clear();
     }
   }
 
+  // Concatenates the results of the shards into a single array allocated by
+  // `buffer_factory_`.
+  DenseArray<ResT> ConcatShards(
+      absl::Span<const DenseArray<ResT>> shards) const {
+    int64_t size = 0;
+    bool has_bitmap = false;
+    for (const auto& shard : shards) {
+      size += shard.size();
+      has_bitmap = has_bitmap || !shard.bitmap.empty();
+    }
+    typename Buffer<ResT>::Builder values_bldr(size, buffer_factory_);
+    auto values_inserter = values_bldr.GetInserter();
+    for (const auto& shard : shards) {
+      for (const auto& v : shard.values) values_inserter.Add(v);
+    }
+    if (!has_bitmap) {
+      return {std::move(values_bldr).Build()};
+    }
+    bitmap::Bitmap::Builder bitmap_bldr(bitmap::BitmapSize(size),
+                                        buffer_factory_);
+    absl::Span<bitmap::Word> bitmap = bitmap_bldr.GetMutableSpan();
+    std::fill(bitmap.begin(), bitmap.end(), bitmap::kFullWord);
+    int64_t offset = 0;
+    for (const auto& shard : shards) {
+      if (!shard.bitmap.empty()) {
+        CopyBits<bitmap::Word>(shard.size(), shard.bitmap.begin(),
+                               shard.bitmap_bit_offset,
+                               bitmap.begin() + offset / bitmap::kWordBitCount,
+                               offset % bitmap::kWordBitCount);
+      }
+      offset += shard.size();
+    }
+    return {std::move(values_bldr).Build(), std::move(bitmap_bldr).Build()};
+  }
+
+  // Adds the present values of the rows [from, to) of `values`: full ranges
+  // by AddRange, and ranges with a bitmap by AddMaskedRange for every bitmap
+  // word.
+  template <class T>
+  static void AddRangeOfRows(Accumulator& accumulator, int64_t from, int64_t to,
+                             const DenseArray<T>& values) {
+    if constexpr (!std::is_same_v<T, Unit>) {
+      if (values.bitmap.empty()) {
+        accumulator.AddRange(values.values.span().subspan(from, to - from));
+        return;
+      }
+    }
+    while (from < to) {
+      int64_t word_id = from / bitmap::kWordBitCount;
+      int64_t word_start = word_id * bitmap::kWordBitCount;
+      int local_from = from - word_start;
+      int count = std::min<int64_t>(to - word_start, bitmap::kWordBitCount) -
+                  local_from;
+      bitmap::Word mask = GetMask(values, word_id) >> local_from;
+      if (count < bitmap::kWordBitCount) {
+        mask &= (bitmap::Word{1} << count) - 1;
+      }
+      accumulator.AddMaskedRange(ValuesRange(values, from, count), mask);
+      from += count;
+    }
+  }
+
+  template <class T>
+  static absl::Span<const T> ValuesRange(const DenseArray<T>& values,
+                                         int64_t from, int64_t count) {
+    if constexpr (std::is_same_v<T, Unit>) {
+      // VoidBuffer has no storage, so Unit values are taken from a constant.
+      static constexpr std::array<Unit, bitmap::kWordBitCount> kUnits{};
+      DCHECK_LE(count, kUnits.size());
+      return absl::MakeConstSpan(kUnits).subspan(0, count);
+    } else {
+      return values.values.span().subspan(from, count);
+    }
+  }
+
   void Add(Accumulator& accumulator, int64_t child_id,
            view_type_t<ChildTs>... args) const {
     if constexpr (ForwardId) {
@@ -319,6 +659,7 @@ class DenseGroupOpsImpl<Accumulator, meta::type_list<ParentTs...>,
 
   RawBufferFactory* buffer_factory_;
   const Accumulator empty_accumulator_;
+  const DenseGroupOpsOptions options_;
 };
 
 }  // namespace dense_ops_internal
@@ -14,6 +14,7 @@
 //
 #include "arolla/dense_array/ops/dense_group_ops.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <optional>
@@ -23,13 +24,16 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/testing/util.h"
+#include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
 #include "arolla/qexpr/operators/testing/accumulators.h"
 #include "arolla/util/text.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 namespace {
@@ -38,6 +42,7 @@ using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
 using ::arolla::testing::CreateDenseArrayFromIdValues;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 using ::testing::Test;
 
@@ -116,6 +121,176 @@ TEST(DenseGroupOps, AggregationToScalar) {
   EXPECT_EQ(*agg.Apply(edge, values), 22.0f);
 }
 
+TEST(DenseGroupOps, RangeAdditions) {
+  std::vector<OptionalValue<int64_t>> values_data;
+  for (int64_t i = 0; i < 200; ++i) {
+    values_data.push_back(i % 7 == 3 ? OptionalValue<int64_t>()
+                                     : OptionalValue<int64_t>(i * i));
+  }
+  // Slicing tests a non-zero bitmap offset.
+  DenseArray<int64_t> values =
+      CreateDenseArray<int64_t>(values_data).Slice(5, 190);
+  DenseArray<int64_t> dense_values = CreateConstDenseArray<int64_t>(190, 3);
+  auto splits =
+      CreateDenseArray<int64_t>({0, 0, 1, 31, 32, 33, 64, 100, 101, 190});
+  ASSERT_OK_AND_ASSIGN(DenseArrayEdge edge,
+                       DenseArrayEdge::FromSplitPoints(splits));
+
+  int64_t single_add_count = 0;
+  DenseGroupOps<testing::AggSumRangeAccumulator<int64_t>> range_agg(
+      GetHeapBufferFactory(),
+      testing::AggSumRangeAccumulator<int64_t>(&single_add_count));
+  DenseGroupOps<testing::AggSumAccumulator<int64_t>> agg(
+      GetHeapBufferFactory());
+  for (const auto& v : {values, dense_values}) {
+    ASSERT_OK_AND_ASSIGN(auto expected, agg.Apply(edge, v));
+    ASSERT_OK_AND_ASSIGN(auto actual, range_agg.Apply(edge, v));
+    EXPECT_THAT(actual, ElementsAreArray(expected));
+    ASSERT_OK_AND_ASSIGN(auto expected_scalar,
+                         agg.Apply(DenseArrayGroupScalarEdge(v.size()), v));
+    EXPECT_THAT(range_agg.Apply(DenseArrayGroupScalarEdge(v.size()), v),
+                IsOkAndHolds(expected_scalar));
+  }
+  EXPECT_EQ(single_add_count, 0);
+}
+
+TEST(DenseGroupOps, MappingPartitions) {
+  constexpr int64_t kParentCount = 300;
+  constexpr int64_t kChildCount = 2000;
+  std::vector<OptionalValue<Text>> prefixes_data(kParentCount);
+  for (int64_t i = 0; i < kParentCount; ++i) {
+    if (i % 13 != 5) prefixes_data[i] = Text(absl::StrCat("group", i, ":"));
+  }
+  std::vector<OptionalValue<int64_t>> mapping_data(kChildCount);
+  std::vector<OptionalValue<Text>> values_data(kChildCount);
+  std::vector<OptionalValue<Text>> comments_data(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    if (i % 11 != 7) mapping_data[i] = (i * 7919) % kParentCount;
+    if (i % 5 != 2) values_data[i] = Text(absl::StrCat("w", i));
+    if (i % 3 == 0) comments_data[i] = Text(absl::StrCat("c", i));
+  }
+  auto prefixes = CreateDenseArray<Text>(prefixes_data);
+  auto values = CreateDenseArray<Text>(values_data);
+  auto comments = CreateDenseArray<Text>(comments_data);
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge edge,
+      DenseArrayEdge::FromMapping(CreateDenseArray<int64_t>(mapping_data),
+                                  kParentCount));
+
+  DenseGroupOps<testing::AggTextAccumulator> agg(GetHeapBufferFactory());
+  ASSERT_OK_AND_ASSIGN(DenseArray<Text> expected,
+                       agg.Apply(edge, prefixes, values, comments));
+
+  StdThreading threading(4);
+  for (DenseGroupOpsOptions options : {
+           // Not partitioned without threading.
+           DenseGroupOpsOptions{.mapping_partitioning_min_bytes = 0,
+                                .mapping_partition_bytes = 1},
+           DenseGroupOpsOptions{.threading = &threading,
+                                .mapping_partitioning_min_bytes = 0,
+                                .mapping_partition_bytes = 1},
+           DenseGroupOpsOptions{.threading = &threading,
+                                .thread_count = 1,
+                                .mapping_partitioning_min_bytes = 0,
+                                .mapping_partition_bytes = 256},
+           DenseGroupOpsOptions{.threading = &threading,
+                                .mapping_partitioning_min_bytes = 0,
+                                .mapping_partition_bytes = 256},
+       }) {
+    DenseGroupOps<testing::AggTextAccumulator> partitioned_agg(
+        GetHeapBufferFactory(), {}, options);
+    ASSERT_OK_AND_ASSIGN(
+        DenseArray<Text> res,
+        partitioned_agg.Apply(edge, prefixes, values, comments));
+    EXPECT_THAT(res, ElementsAreArray(expected));
+  }
+}
+
+TEST(DenseGroupOps, ParallelSplitPoints) {
+  constexpr int64_t kParentCount = 300;
+  constexpr int64_t kChildCount = 2000;
+  std::vector<OptionalValue<Text>> prefixes_data(kParentCount);
+  std::vector<OptionalValue<float>> weights_data(kParentCount);
+  for (int64_t i = 0; i < kParentCount; ++i) {
+    if (i % 13 != 5) prefixes_data[i] = Text(absl::StrCat("group", i, ":"));
+    if (i % 17 != 3) weights_data[i] = 0.5f * (i % 7);
+  }
+  std::vector<int64_t> splits_data(kParentCount + 1);
+  for (int64_t i = 0; i < kParentCount; ++i) {
+    // Variable group sizes, including empty groups.
+    splits_data[i] = (i * i) % 97 == 0 ? kChildCount * i / kParentCount
+                                       : kChildCount * (i + 1) / kParentCount;
+  }
+  splits_data[0] = 0;
+  splits_data[kParentCount] = kChildCount;
+  std::vector<OptionalValue<Text>> values_data(kChildCount);
+  std::vector<OptionalValue<float>> floats_data(kChildCount);
+  for (int64_t i = 0; i < kChildCount; ++i) {
+    if (i % 5 != 2) values_data[i] = Text(absl::StrCat("w", i));
+    if (i % 11 != 7) floats_data[i] = 0.25f * ((i * 7919) % 101);
+  }
+  auto prefixes = CreateDenseArray<Text>(prefixes_data);
+  auto weights = CreateDenseArray<float>(weights_data);
+  auto values = CreateDenseArray<Text>(values_data);
+  auto floats = CreateDenseArray<float>(floats_data);
+  auto empty_comments = CreateEmptyDenseArray<Text>(kChildCount);
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge edge,
+      DenseArrayEdge::FromSplitPoints(CreateFullDenseArray(splits_data)));
+
+  DenseGroupOps<testing::AggTextAccumulator> agg(GetHeapBufferFactory());
+  ASSERT_OK_AND_ASSIGN(DenseArray<Text> expected_agg,
+                       agg.Apply(edge, prefixes, values, empty_comments));
+  DenseGroupOps<testing::RankValuesAccumulator<float>> rank(
+      GetHeapBufferFactory());
+  ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> expected_rank,
+                       rank.Apply(edge, floats));
+  DenseGroupOps<testing::WeightedSumAccumulator> weighted_sum(
+      GetHeapBufferFactory());
+  ASSERT_OK_AND_ASSIGN(DenseArray<float> expected_weighted_sum,
+                       weighted_sum.Apply(edge, weights, weights, weights,
+                                          floats, floats, floats));
+
+  StdThreading threading(4);
+  for (int64_t min_rows_per_shard : {1, 100, 1000}) {
+    DenseGroupOpsOptions options{.threading = &threading,
+                                 .min_rows_per_shard = min_rows_per_shard};
+    DenseGroupOps<testing::AggTextAccumulator> parallel_agg(
+        GetHeapBufferFactory(), {}, options);
+    EXPECT_THAT(parallel_agg.Apply(edge, prefixes, values, empty_comments),
+                IsOkAndHolds(ElementsAreArray(expected_agg)));
+    DenseGroupOps<testing::RankValuesAccumulator<float>> parallel_rank(
+        GetHeapBufferFactory(), {}, options);
+    EXPECT_THAT(parallel_rank.Apply(edge, floats),
+                IsOkAndHolds(ElementsAreArray(expected_rank)));
+    DenseGroupOps<testing::WeightedSumAccumulator> parallel_weighted_sum(
+        GetHeapBufferFactory(), {}, options);
+    EXPECT_THAT(parallel_weighted_sum.Apply(edge, weights, weights, weights,
+                                            floats, floats, floats),
+                IsOkAndHolds(ElementsAreArray(expected_weighted_sum)));
+  }
+}
+
+TEST(DenseGroupOps, ParallelSplitPointsWithErrorStatus) {
+  constexpr int64_t kParentCount = 100;
+  std::vector<int64_t> splits_data(kParentCount + 1);
+  for (int64_t i = 0; i <= kParentCount; ++i) {
+    // The last group is empty.
+    splits_data[i] = std::min(i, kParentCount - 1) * 10;
+  }
+  ASSERT_OK_AND_ASSIGN(
+      DenseArrayEdge edge,
+      DenseArrayEdge::FromSplitPoints(CreateFullDenseArray(splits_data)));
+
+  StdThreading threading(4);
+  DenseGroupOps<testing::AverageAccumulator> agg(
+      GetHeapBufferFactory(), {},
+      {.threading = &threading, .min_rows_per_shard = 10});
+  EXPECT_THAT(
+      agg.Apply(edge, CreateConstDenseArray<float>(edge.child_size(), 1.0f)),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("empty group")));
+}
+
 TEST(DenseGroupOps, RankValues) {
   auto values =
       CreateDenseArray<float>({3.0f, 5.0f, std::nanf(""), 1.0f, 3.1f, 7.0f});
@@ -0,0 +1,275 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_DENSE_ARRAY_OPS_INTEGER_GROUP_BY_H_
+#define AROLLA_DENSE_ARRAY_OPS_INTEGER_GROUP_BY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/bitmap.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/dense_array/ops/util.h"
+#include "arolla/memory/buffer.h"
+#include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/util/meta.h"
+#include "arolla/util/status.h"
+
+namespace arolla {
+
+// True if T is supported by the group-by and unique functions below.
+template <typename T>
+constexpr bool kIsIntegerGroupByKey =
+    std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+namespace dense_ops_internal {
+
+// Open addressing hash table (with linear probing) that assigns consecutive
+// ids to the distinct keys in the order of insertion. If kWithGroups is true,
+// the keys are (group, value) pairs. The slots are stored in a single flat
+// buffer allocated by the given buffer factory.
+template <typename T, bool kWithGroups>
+class IntegerKeyIndex {
+  static_assert(kIsIntegerGroupByKey<T>);
+
+ public:
+  // `size_hint` is an upper bound for the number of distinct keys. The table
+  // is pre-sized for min(size_hint, kMaxPresizedKeys) keys and grows if
+  // needed. The limit avoids clearing a huge table when large inputs have
+  // only a few distinct keys.
+  static constexpr int64_t kMaxPresizedKeys = int64_t{1} << 14;
+
+  IntegerKeyIndex(int64_t size_hint, RawBufferFactory* buffer_factory)
+      : buffer_factory_(buffer_factory) {
+    Allocate(absl::bit_ceil(static_cast<uint64_t>(
+        2 * std::clamp<int64_t>(size_hint, 8, kMaxPresizedKeys))));
+  }
+
+  IntegerKeyIndex(const IntegerKeyIndex&) = delete;
+  IntegerKeyIndex& operator=(const IntegerKeyIndex&) = delete;
+
+  // Returns the id of the key and true if the key was inserted.
+  std::pair<int64_t, bool> Insert(int64_t group, T value) {
+    if (ABSL_PREDICT_FALSE(size_ >= growth_limit_)) {
+      Grow();
+    }
+    for (uint64_t i = Hash(group, value) & mask_;; i = (i + 1) & mask_) {
+      Slot& slot = slots_[i];
+      if (slot.id < 0) {
+        slot.value = value;
+        if constexpr (kWithGroups) {
+          slot.group = group;
+        }
+        slot.id = size_;
+        return {size_++, true};
+      }
+      if (slot.value == value) {
+        if constexpr (kWithGroups) {
+          if (slot.group != group) continue;
+        }
+        return {slot.id, false};
+      }
+    }
+  }
+
+  // Number of distinct keys.
+  int64_t size() const { return size_; }
+
+ private:
+  struct SlotWithGroup {
+    int64_t id;
+    int64_t group;
+    T value;
+  };
+  struct SlotWithoutGroup {
+    int64_t id;
+    T value;
+  };
+  using Slot =
+      std::conditional_t<kWithGroups, SlotWithGroup, SlotWithoutGroup>;
+
+  // murmur3 finalizer; the group is mixed in with a multiplicative hash.
+  static uint64_t Hash(int64_t group, T value) {
+    uint64_t x = static_cast<uint64_t>(value);
+    if constexpr (kWithGroups) {
+      x ^= static_cast<uint64_t>(group) * 0x9e3779b97f4a7c15;
+    }
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+    return x;
+  }
+
+  void Allocate(uint64_t capacity) {
+    auto [buffer, data] = buffer_factory_->CreateRawBuffer(capacity *
+                                                           sizeof(Slot));
+    // All bits set means id == -1, i.e. an empty slot.
+    std::memset(data, 0xff, capacity * sizeof(Slot));
+    buffer_ = std::move(buffer);
+    slots_ = static_cast<Slot*>(data);
+    mask_ = capacity - 1;
+    growth_limit_ = capacity / 2;
+  }
+
+  void Grow() {
+    RawBufferPtr old_buffer = std::move(buffer_);
+    const Slot* old_slots = slots_;
+    const uint64_t old_capacity = mask_ + 1;
+    Allocate(2 * old_capacity);
+    for (uint64_t j = 0; j < old_capacity; ++j) {
+      const Slot& old_slot = old_slots[j];
+      if (old_slot.id < 0) continue;
+      int64_t group = 0;
+      if constexpr (kWithGroups) {
+        group = old_slot.group;
+      }
+      uint64_t i = Hash(group, old_slot.value) & mask_;
+      while (slots_[i].id >= 0) {
+        i = (i + 1) & mask_;
+      }
+      slots_[i] = old_slot;
+    }
+  }
+
+  RawBufferFactory* buffer_factory_;
+  RawBufferPtr buffer_;
+  Slot* slots_ = nullptr;
+  uint64_t mask_ = 0;
+  int64_t growth_limit_ = 0;
+  int64_t size_ = 0;
+};
+
+// Returns a DenseArray with the given values where the rows are present iff
+// they are present both in `a` and `b` (`a` and `b` must have the same size).
+template <typename A, typename B>
+DenseArray<int64_t> WithIntersectedPresence(Buffer<int64_t> values,
+                                            const DenseArray<A>& a,
+                                            const DenseArray<B>& b,
+                                            RawBufferFactory* buffer_factory) {
+  if (b.bitmap.empty()) {
+    return {std::move(values), a.bitmap, a.bitmap_bit_offset};
+  }
+  if (a.bitmap.empty()) {
+    return {std::move(values), b.bitmap, b.bitmap_bit_offset};
+  }
+  bitmap::Bitmap::Builder bitmap_bldr(
+      std::min(a.bitmap.size(), b.bitmap.size()), buffer_factory);
+  bitmap::Intersect(a.bitmap, b.bitmap, a.bitmap_bit_offset,
+                    b.bitmap_bit_offset, bitmap_bldr.GetMutableSpan());
+  return {std::move(values), std::move(bitmap_bldr).Build(),
+          std::min(a.bitmap_bit_offset, b.bitmap_bit_offset)};
+}
+
+}  // namespace dense_ops_internal
+
+// Assigns the same id to the present rows of `values` that have equal values
+// and belong to the same parent of `edge`. The ids are assigned in the order
+// of the first occurrence. Returns the mapping from rows to ids; the number of
+// ids is stored to `group_count`.
+//
+// It is equivalent to DenseGroupOps<GroupByAccumulator<T>>, but uses a flat
+// hash table specialized for integers and does not build the result row by
+// row.
+template <typename T>
+absl::StatusOr<DenseArray<int64_t>> IntegerGroupBy(
+    const DenseArray<T>& values, const DenseArrayEdge& edge,
+    int64_t& group_count, RawBufferFactory* buffer_factory) {
+  if (values.size() != edge.child_size()) {
+    return SizeMismatchError({edge.child_size(), values.size()});
+  }
+  dense_ops_internal::IntegerKeyIndex<T, /*kWithGroups=*/true> index(
+      values.size(), buffer_factory);
+  Buffer<int64_t>::Builder ids_bldr(values.size(), buffer_factory);
+  absl::Span<int64_t> ids = ids_bldr.GetMutableSpan();
+  const DenseArray<int64_t>& edge_values = edge.edge_values();
+  switch (edge.edge_type()) {
+    case DenseArrayEdge::SPLIT_POINTS: {
+      absl::Span<const int64_t> splits = edge_values.values.span();
+      int64_t parent_id = 0;
+      values.ForEach([&](int64_t child_id, bool present, T value) {
+        while (splits[parent_id + 1] <= child_id) ++parent_id;
+        ids[child_id] = present ? index.Insert(parent_id, value).first : 0;
+      });
+      group_count = index.size();
+      // All split points are present, so the presence is defined by values.
+      return DenseArray<int64_t>{std::move(ids_bldr).Build(), values.bitmap,
+                                 values.bitmap_bit_offset};
+    }
+    case DenseArrayEdge::MAPPING: {
+      dense_ops_internal::DenseOpsUtil<meta::type_list<int64_t, T>>::
+          IterateFromZero(
+              [&](int64_t child_id, bool valid, int64_t parent_id, T value) {
+                ids[child_id] =
+                    valid ? index.Insert(parent_id, value).first : 0;
+              },
+              values.size(), edge_values, values);
+      group_count = index.size();
+      return dense_ops_internal::WithIntersectedPresence(
+          std::move(ids_bldr).Build(), values, edge_values, buffer_factory);
+    }
+    default:
+      return absl::InvalidArgumentError("unsupported edge type");
+  }
+}
+
+// Same as above, but all rows belong to a single parent.
+template <typename T>
+absl::StatusOr<DenseArray<int64_t>> IntegerGroupBy(
+    const DenseArray<T>& values, const DenseArrayGroupScalarEdge& edge,
+    int64_t& group_count, RawBufferFactory* buffer_factory) {
+  if (values.size() != edge.child_size()) {
+    return SizeMismatchError({edge.child_size(), values.size()});
+  }
+  dense_ops_internal::IntegerKeyIndex<T, /*kWithGroups=*/false> index(
+      values.size(), buffer_factory);
+  Buffer<int64_t>::Builder ids_bldr(values.size(), buffer_factory);
+  absl::Span<int64_t> ids = ids_bldr.GetMutableSpan();
+  values.ForEach([&](int64_t id, bool present, T value) {
+    ids[id] = present ? index.Insert(0, value).first : 0;
+  });
+  group_count = index.size();
+  return DenseArray<int64_t>{std::move(ids_bldr).Build(), values.bitmap,
+                             values.bitmap_bit_offset};
+}
+
+// Returns the distinct present values in the order of the first occurrence.
+template <typename T>
+DenseArray<T> IntegerUnique(const DenseArray<T>& values,
+                            RawBufferFactory* buffer_factory) {
+  dense_ops_internal::IntegerKeyIndex<T, /*kWithGroups=*/false> index(
+      values.size(), buffer_factory);
+  typename Buffer<T>::Builder bldr(values.size(), buffer_factory);
+  auto inserter = bldr.GetInserter();
+  values.ForEachPresent([&](int64_t /*id*/, T value) {
+    if (index.Insert(0, value).second) {
+      inserter.Add(value);
+    }
+  });
+  return DenseArray<T>{std::move(bldr).Build(index.size())};
+}
+
+}  // namespace arolla
+
+#endif  // AROLLA_DENSE_ARRAY_OPS_INTEGER_GROUP_BY_H_
@@ -0,0 +1,137 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/dense_array/ops/integer_group_by.h"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "arolla/dense_array/dense_array.h"
+#include "arolla/dense_array/edge.h"
+#include "arolla/memory/optional_value.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+TEST(IntegerGroupByTest, ScalarEdge) {
+  auto values = CreateDenseArray<int32_t>({5, std::nullopt, 7, 5, -1, 7});
+  int64_t group_count = 0;
+  ASSERT_OK_AND_ASSIGN(
+      DenseArray<int64_t> mapping,
+      IntegerGroupBy(values, DenseArrayGroupScalarEdge(6), group_count,
+                     GetHeapBufferFactory()));
+  EXPECT_THAT(mapping, ElementsAre(0, std::nullopt, 1, 0, 2, 1));
+  EXPECT_THAT(group_count, Eq(3));
+
+  EXPECT_THAT(IntegerGroupBy(values, DenseArrayGroupScalarEdge(5),
+                             group_count, GetHeapBufferFactory()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("argument sizes mismatch")));
+}
+
+TEST(IntegerGroupByTest, SplitPoints) {
+  auto values =
+      CreateDenseArray<int64_t>({5, 5, std::nullopt, 7, 5, 7, 7, 5, 1});
+  ASSERT_OK_AND_ASSIGN(
+      auto edge,
+      DenseArrayEdge::FromSplitPoints(CreateDenseArray<int64_t>({0, 3, 3, 9})));
+  int64_t group_count = 0;
+  ASSERT_OK_AND_ASSIGN(
+      DenseArray<int64_t> mapping,
+      IntegerGroupBy(values, edge, group_count, GetHeapBufferFactory()));
+  EXPECT_THAT(mapping, ElementsAre(0, 0, std::nullopt, 1, 2, 1, 1, 2, 3));
+  EXPECT_THAT(group_count, Eq(4));
+}
+
+TEST(IntegerGroupByTest, Mapping) {
+  auto values = CreateDenseArray<uint64_t>({5, 5, std::nullopt, 7, 5, 7, 5});
+  ASSERT_OK_AND_ASSIGN(auto edge, DenseArrayEdge::FromMapping(
+                                      CreateDenseArray<int64_t>(
+                                          {1, 0, 1, 1, std::nullopt, 1, 0}),
+                                      /*parent_size=*/2));
+  int64_t group_count = 0;
+  ASSERT_OK_AND_ASSIGN(
+      DenseArray<int64_t> mapping,
+      IntegerGroupBy(values, edge, group_count, GetHeapBufferFactory()));
+  EXPECT_THAT(mapping, ElementsAre(0, 1, std::nullopt, 2, std::nullopt, 2, 1));
+  EXPECT_THAT(group_count, Eq(3));
+
+  // The same mapping, but the values have no missing rows.
+  ASSERT_OK_AND_ASSIGN(
+      mapping,
+      IntegerGroupBy(CreateDenseArray<uint64_t>({5, 5, 5, 7, 5, 7, 5}), edge,
+                     group_count, GetHeapBufferFactory()));
+  EXPECT_THAT(mapping, ElementsAre(0, 1, 0, 2, std::nullopt, 2, 1));
+  EXPECT_THAT(group_count, Eq(3));
+}
+
+TEST(IntegerGroupByTest, Unique) {
+  EXPECT_THAT(IntegerUnique(CreateDenseArray<int64_t>(
+                                {3, std::nullopt, 1, 3, -8, 1, std::nullopt}),
+                            GetHeapBufferFactory()),
+              ElementsAre(3, 1, -8));
+  EXPECT_THAT(IntegerUnique(DenseArray<int32_t>(), GetHeapBufferFactory()),
+              ElementsAre());
+}
+
+TEST(IntegerGroupByTest, ManyDistinctValues) {
+  // Enough distinct keys to grow the hash table several times.
+  constexpr int64_t kSize = 100000;
+  std::vector<OptionalValue<int64_t>> values_data(kSize);
+  std::vector<OptionalValue<int64_t>> mapping_data(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    if (i % 7 != 3) values_data[i] = ((i * 7919) % 30011) << 20;
+    if (i % 11 != 5) mapping_data[i] = i % 3;
+  }
+  auto values = CreateDenseArray<int64_t>(values_data);
+  ASSERT_OK_AND_ASSIGN(
+      auto edge,
+      DenseArrayEdge::FromMapping(CreateDenseArray<int64_t>(mapping_data),
+                                  /*parent_size=*/3));
+
+  std::map<std::pair<int64_t, int64_t>, int64_t> expected_ids;
+  std::vector<OptionalValue<int64_t>> expected_mapping(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    if (values_data[i].present && mapping_data[i].present) {
+      expected_mapping[i] =
+          expected_ids
+              .emplace(std::pair{mapping_data[i].value, values_data[i].value},
+                       expected_ids.size())
+              .first->second;
+    }
+  }
+  int64_t group_count = 0;
+  ASSERT_OK_AND_ASSIGN(
+      DenseArray<int64_t> mapping,
+      IntegerGroupBy(values, edge, group_count, GetHeapBufferFactory()));
+  EXPECT_THAT(mapping, ElementsAreArray(expected_mapping));
+  EXPECT_THAT(group_count, Eq(expected_ids.size()));
+}
+
+}  // namespace
+}  // namespace arolla
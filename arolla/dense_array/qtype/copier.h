@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/memory/simple_buffer.h"
 #include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
@@ -64,8 +66,16 @@ class DenseArray2FramesCopier : public BatchToFramesCopier {
 
   void CopyNextBatch(absl::Span<FramePtr> output_buffers) final {
     if (!IsStarted()) Start();  // Forbid adding new mappings.
+    CopyBatchAt(current_row_id_, output_buffers);
+    current_row_id_ += output_buffers.size();
+  }
+
+  bool SupportsCopyBatchAt() const final { return true; }
+
+  void CopyBatchAt(int64_t row_id,
+                   absl::Span<FramePtr> output_buffers) const final {
     for (const auto& mapping : mappings_) {
-      auto iter = mapping.array.values.begin() + current_row_id_;
+      auto iter = mapping.array.values.begin() + row_id;
       if (std::holds_alternative<FrameLayout::Slot<T>>(mapping.scalar_slot)) {
         // mapping to non-optional scalars
         auto scalar_slot =
@@ -86,7 +96,7 @@ class DenseArray2FramesCopier : public BatchToFramesCopier {
         } else {
           bitmap::IterateByGroups(
               mapping.array.bitmap.begin(),
-              current_row_id_ + mapping.array.bitmap_bit_offset,
+              row_id + mapping.array.bitmap_bit_offset,
               output_buffers.size(), [&](int64_t offset) {
                 FramePtr* frame_group = output_buffers.begin() + offset;
                 auto values = iter + offset;
@@ -98,7 +108,6 @@ class DenseArray2FramesCopier : public BatchToFramesCopier {
         }
       }
     }
-    current_row_id_ += output_buffers.size();
   }
 
  private:
@@ -144,40 +153,23 @@ class Frames2DenseArrayCopier : public BatchFromFramesCopier {
       return absl::FailedPreconditionError(
           "start(row_count) should be called before CopyNextBatch");
     }
-
-    for (Mapping& mapping : mappings_) {
-      DCHECK(mapping.values_builder.has_value());
-      if (std::holds_alternative<FrameLayout::Slot<T>>(mapping.scalar_slot)) {
-        // copy from non-optional scalars into array.
-        auto scalar_slot =
-            *std::get_if<FrameLayout::Slot<T>>(&mapping.scalar_slot);
-        const ConstFramePtr* iter = input_buffers.data();
-        mapping.values_builder->SetN(
-            current_row_id_, input_buffers.size(),
-            [&] { return (iter++)->Get(scalar_slot); });
-      } else {
-        // copy from optional scalars into array.
-        DCHECK(std::holds_alternative<FrameLayout::Slot<OptionalValue<T>>>(
-            mapping.scalar_slot));
-        DCHECK(mapping.bitmap_builder.has_value());
-        auto scalar_slot = *std::get_if<FrameLayout::Slot<OptionalValue<T>>>(
-            &mapping.scalar_slot);
-        auto values_inserter =
-            mapping.values_builder->GetInserter(current_row_id_);
-        auto fn = [&](ConstFramePtr frame) {
-          const OptionalValue<T>& v = frame.Get(scalar_slot);
-          values_inserter.Add(v.value);
-          return v.present;
-        };
-        // Callback `fn` inserts values as a side-effect while setting presence
-        // bits.
-        mapping.bitmap_builder->AddForEach(input_buffers, fn);
-      }
-    }
+    CopyRows</*kConcurrent=*/false>(current_row_id_, input_buffers);
     current_row_id_ += input_buffers.size();
     return absl::OkStatus();
   }
 
+  // Not supported for non-trivial buffers (e.g. strings), because their
+  // builders can't be filled concurrently.
+  bool SupportsCopyBatchAt() const final {
+    return std::is_same_v<Buffer<T>, SimpleBuffer<T>>;
+  }
+
+  void CopyBatchAt(int64_t row_id,
+                   absl::Span<const ConstFramePtr> input_buffers) final {
+    DCHECK(SupportsCopyBatchAt());
+    CopyRows</*kConcurrent=*/true>(row_id, input_buffers);
+  }
+
   absl::Status Finalize(FramePtr arrays_frame) final {
     if (finished_) {
       return absl::FailedPreconditionError("finalize can be called only once");
@@ -208,6 +200,43 @@ class Frames2DenseArrayCopier : public BatchFromFramesCopier {
     std::optional<bitmap::Builder> bitmap_builder;
   };
 
+  template <bool kConcurrent>
+  void CopyRows(int64_t row_id,
+                absl::Span<const ConstFramePtr> input_buffers) {
+    for (Mapping& mapping : mappings_) {
+      DCHECK(mapping.values_builder.has_value());
+      if (std::holds_alternative<FrameLayout::Slot<T>>(mapping.scalar_slot)) {
+        // copy from non-optional scalars into array.
+        auto scalar_slot =
+            *std::get_if<FrameLayout::Slot<T>>(&mapping.scalar_slot);
+        const ConstFramePtr* iter = input_buffers.data();
+        mapping.values_builder->SetN(
+            row_id, input_buffers.size(),
+            [&] { return (iter++)->Get(scalar_slot); });
+      } else {
+        // copy from optional scalars into array.
+        DCHECK(std::holds_alternative<FrameLayout::Slot<OptionalValue<T>>>(
+            mapping.scalar_slot));
+        DCHECK(mapping.bitmap_builder.has_value());
+        auto scalar_slot = *std::get_if<FrameLayout::Slot<OptionalValue<T>>>(
+            &mapping.scalar_slot);
+        auto values_inserter = mapping.values_builder->GetInserter(row_id);
+        auto fn = [&](ConstFramePtr frame) {
+          const OptionalValue<T>& v = frame.Get(scalar_slot);
+          values_inserter.Add(v.value);
+          return v.present;
+        };
+        // Callback `fn` inserts values as a side-effect while setting presence
+        // bits.
+        if constexpr (kConcurrent) {
+          mapping.bitmap_builder->SetForEach(row_id, input_buffers, fn);
+        } else {
+          mapping.bitmap_builder->AddForEach(input_buffers, fn);
+        }
+      }
+    }
+  }
+
   void SetArraySize(int64_t size) final {
     // Initialize builders
     for (auto& mapping : mappings_) {
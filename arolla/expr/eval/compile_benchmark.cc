@@ -14,26 +14,56 @@
 //
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "benchmark/benchmark.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/random.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "arolla/decision_forest/decision_forest.h"
+#include "arolla/decision_forest/expr_operator/decision_forest_operator.h"
+#include "arolla/decision_forest/testing/test_util.h"
+#include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/model_executor.h"
 #include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
 #include "arolla/expr/optimization/default/default_optimizer.h"
 #include "arolla/io/wildcard_input_loader.h"
+#include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_slot.h"
 #include "arolla/util/init_arolla.h"
+#include "arolla/util/threading.h"
 
 namespace {
 
+using ::arolla::AddSlotsMap;
+using ::arolla::CreateRandomFloatForest;
+using ::arolla::DecisionForestOperator;
 using ::arolla::EvaluationOptions;
+using ::arolla::FrameLayout;
+using ::arolla::GetDenseArrayQType;
 using ::arolla::InitArolla;
+using ::arolla::QTypePtr;
+using ::arolla::StdThreading;
+using ::arolla::TreeFilter;
 using ::arolla::WildcardInputLoader;
 using ::arolla::expr::CallOp;
+using ::arolla::expr::CompileForDynamicEvaluation;
 using ::arolla::expr::CompileModelExecutor;
 using ::arolla::expr::DefaultOptimizer;
+using ::arolla::expr::DynamicEvaluationEngineOptions;
+using ::arolla::expr::ExprNodePtr;
 using ::arolla::expr::Leaf;
 using ::arolla::expr::Literal;
 using ::arolla::expr::ModelExecutorOptions;
@@ -71,6 +101,27 @@ void BM_Add_F32_F32_NTimes_WithStacktrace(benchmark::State& state) {
 BENCHMARK(BM_Add_F32_F32_NTimes_WithStacktrace);
 BENCHMARK(BM_Add_F32_F32_NTimes_WithoutStacktrace);
 
+// Measures only the evaluation of a model compiled once; dominated by the
+// dispatch overhead of the tiny `math.add` operators.
+void BM_Add_F32_F32_NTimes_Execute(benchmark::State& state) {
+  InitArolla();
+  auto leaf = Leaf("x");
+  auto expr = Literal<float>(0.0f);
+  for (int i = 0; i < state.range(0); ++i) {
+    expr = *CallOp("math.add", {expr, leaf});
+  }
+  auto accessor = [](float x, absl::string_view) { return x; };
+  auto input_loader = *WildcardInputLoader<float>::Build(accessor);
+  auto model_executor = *CompileModelExecutor<float>(expr, *input_loader);
+  for (auto _ : state) {
+    auto y = *model_executor.Execute(1.0f);
+    benchmark::DoNotOptimize(y);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Add_F32_F32_NTimes_Execute)->Arg(10)->Arg(1000)->Arg(N);
+
 void Add_F64_F32_NTimes(int N, bool enable_expr_stack_trace,
                         benchmark::State& state) {
   InitArolla();
@@ -129,4 +180,56 @@ void BM_Fib(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_Fib, 10);
 BENCHMARK_TEMPLATE(BM_Fib, 100);
 
+// Compiles and binds a model with many independent decision forests.
+// state.range(0) is the number of threads, 0 means no parallel compilation.
+void BM_CompileDecisionForests(benchmark::State& state) {
+  InitArolla();
+  constexpr int kForestCount = 32;
+  constexpr int kFeatureCount = 20;
+  absl::BitGen rnd;
+  absl::flat_hash_map<std::string, QTypePtr> input_types;
+  std::vector<absl::StatusOr<ExprNodePtr>> inputs;
+  for (int i = 0; i < kFeatureCount; ++i) {
+    std::string name = absl::StrCat("f", i);
+    input_types[name] = GetDenseArrayQType<float>();
+    inputs.push_back(Leaf(name));
+  }
+  std::vector<absl::StatusOr<ExprNodePtr>> forests;
+  for (int i = 0; i < kForestCount; ++i) {
+    auto forest = CreateRandomFloatForest(
+        &rnd, kFeatureCount, /*interactions=*/true, /*min_num_splits=*/10,
+        /*max_num_splits=*/63, /*num_trees=*/300);
+    forests.push_back(
+        CallOp(std::make_shared<DecisionForestOperator>(
+                   std::move(forest), std::vector<TreeFilter>{TreeFilter()}),
+               inputs));
+  }
+  ExprNodePtr expr = *CallOp("core.make_tuple", forests);
+
+  std::optional<StdThreading> threading;
+  DynamicEvaluationEngineOptions options;
+  if (state.range(0) > 0) {
+    threading.emplace(state.range(0));
+    options.threading = &*threading;
+  }
+  for (auto _ : state) {
+    auto compiled_expr =
+        *CompileForDynamicEvaluation(options, expr, input_types);
+    FrameLayout::Builder layout_builder;
+    auto input_slots = AddSlotsMap(input_types, &layout_builder);
+    auto bound_expr =
+        *compiled_expr->Bind(&layout_builder, input_slots, std::nullopt);
+    benchmark::DoNotOptimize(bound_expr);
+  }
+}
+
+BENCHMARK(BM_CompileDecisionForests)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace
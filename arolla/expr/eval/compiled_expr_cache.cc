@@ -0,0 +1,151 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/compiled_expr_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/lru_cache.h"
+
+namespace arolla::expr {
+namespace {
+
+using Cache = LruCache<Fingerprint, std::shared_ptr<const CompiledExpr>>;
+
+struct CacheState {
+  absl::Mutex mutex;
+  std::unique_ptr<Cache> cache ABSL_GUARDED_BY(mutex);  // nullptr if disabled
+  CompiledExprCacheStats stats ABSL_GUARDED_BY(mutex);
+};
+
+CacheState& GetCacheState() {
+  static absl::NoDestructor<CacheState> state;
+  return *state;
+}
+
+template <typename T>
+std::vector<std::pair<std::string, T>> SortedItems(
+    const absl::flat_hash_map<std::string, T>& map) {
+  std::vector<std::pair<std::string, T>> items(map.begin(), map.end());
+  std::sort(items.begin(), items.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  return items;
+}
+
+Fingerprint CacheKey(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs) {
+  FingerprintHasher hasher("::arolla::expr::CompiledExprCache");
+  hasher.Combine(expr->fingerprint(), input_types.size());
+  // QTypes are singletons, so their addresses identify them.
+  for (const auto& [name, qtype] : SortedItems(input_types)) {
+    hasher.Combine(name, reinterpret_cast<uintptr_t>(qtype));
+  }
+  hasher.Combine(side_outputs.size());
+  for (const auto& [name, side_output] : SortedItems(side_outputs)) {
+    hasher.Combine(name, side_output->fingerprint());
+  }
+  hasher.Combine(options.enabled_preparation_stages,
+                 options.collect_op_descriptions,
+                 options.optimizer.has_value(),
+                 options.global_optimizer.has_value(),
+                 options.optimizer_fingerprint.value_or(Fingerprint{}),
+                 options.allow_overriding_input_slots,
+                 reinterpret_cast<uintptr_t>(options.operator_directory),
+                 options.enable_expr_stack_trace);
+  return std::move(hasher).Finish();
+}
+
+}  // namespace
+
+void SetCompiledExprCacheCapacity(size_t capacity) {
+  CacheState& state = GetCacheState();
+  absl::MutexLock lock(state.mutex);
+  state.cache = capacity > 0 ? std::make_unique<Cache>(capacity) : nullptr;
+  state.stats.size = 0;
+}
+
+CompiledExprCacheStats GetCompiledExprCacheStats() {
+  CacheState& state = GetCacheState();
+  absl::MutexLock lock(state.mutex);
+  return state.stats;
+}
+
+void ClearCompiledExprCache() {
+  CacheState& state = GetCacheState();
+  absl::MutexLock lock(state.mutex);
+  if (state.cache != nullptr) {
+    state.cache->Clear();
+  }
+  state.stats = CompiledExprCacheStats{};
+}
+
+absl::StatusOr<std::shared_ptr<const CompiledExpr>>
+CompileForDynamicEvaluationWithCache(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types,
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs) {
+  if ((options.optimizer.has_value() || options.global_optimizer.has_value()) &&
+      !options.optimizer_fingerprint.has_value()) {
+    return CompileForDynamicEvaluation(options, expr, input_types,
+                                       side_outputs);
+  }
+  CacheState& state = GetCacheState();
+  const Fingerprint key = CacheKey(options, expr, input_types, side_outputs);
+  {
+    absl::MutexLock lock(state.mutex);
+    if (state.cache == nullptr) {
+      // Compile without the cache (below).
+    } else if (const auto* cached = state.cache->LookupOrNull(key);
+               cached != nullptr) {
+      state.stats.hits++;
+      return *cached;
+    } else {
+      state.stats.misses++;
+    }
+  }
+  // Compile without holding the lock, so concurrent compilations of different
+  // expressions don't block each other. If the same expression is compiled
+  // concurrently, the last result stays in the cache.
+  ASSIGN_OR_RETURN(std::shared_ptr<const CompiledExpr> compiled_expr,
+                   CompileForDynamicEvaluation(options, expr, input_types,
+                                               side_outputs));
+  absl::MutexLock lock(state.mutex);
+  if (state.cache != nullptr) {
+    state.cache->Put(key, compiled_expr);
+    state.stats.size = state.cache->size();
+  }
+  return compiled_expr;
+}
+
+}  // namespace arolla::expr
@@ -0,0 +1,72 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_EXPR_EVAL_COMPILED_EXPR_CACHE_H_
+#define AROLLA_EXPR_EVAL_COMPILED_EXPR_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qtype/qtype.h"
+
+namespace arolla::expr {
+
+// A process-wide, size-bounded (LRU) cache of compiled expressions, used by
+// CompileForDynamicEvaluationWithCache. The cache is keyed by the expression
+// fingerprint, input types, side outputs and DynamicEvaluationEngineOptions.
+// It is disabled by default.
+//
+// NOTE: Optimizers (DynamicEvaluationEngineOptions::optimizer and
+// global_optimizer) can not be fingerprinted, so the cache relies on
+// DynamicEvaluationEngineOptions::optimizer_fingerprint instead. Expressions
+// compiled with an optimizer but without optimizer_fingerprint bypass the
+// cache (they are neither hits nor misses).
+
+// Statistics of the compiled expressions cache.
+struct CompiledExprCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  // The number of expressions currently stored in the cache.
+  int64_t size = 0;
+};
+
+// Sets the max number of compiled expressions stored in the cache. 0 disables
+// the cache and removes all the stored expressions.
+void SetCompiledExprCacheCapacity(size_t capacity);
+
+// Returns statistics of the cache.
+CompiledExprCacheStats GetCompiledExprCacheStats();
+
+// Removes all the stored expressions and resets statistics.
+void ClearCompiledExprCache();
+
+// The same as CompileForDynamicEvaluation, but returns a compiled expression
+// from the process-wide cache if it is enabled. The result is immutable and
+// can be shared by several callers (including ones in other threads).
+absl::StatusOr<std::shared_ptr<const CompiledExpr>>
+CompileForDynamicEvaluationWithCache(
+    const DynamicEvaluationEngineOptions& options, const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, QTypePtr>& input_types = {},
+    const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs = {});
+
+}  // namespace arolla::expr
+
+#endif  // AROLLA_EXPR_EVAL_COMPILED_EXPR_CACHE_H_
@@ -0,0 +1,175 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/expr/eval/compiled_expr_cache.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status_matchers.h"
+#include "arolla/expr/eval/eval.h"
+#include "arolla/expr/expr.h"
+#include "arolla/expr/expr_node.h"
+#include "arolla/expr/optimization/optimizer.h"
+#include "arolla/qtype/base_types.h"
+#include "arolla/qtype/qtype.h"
+#include "arolla/qtype/qtype_traits.h"
+#include "arolla/util/fingerprint.h"
+
+namespace arolla::expr {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::testing::AllOf;
+using ::testing::Field;
+
+auto StatsAre(int64_t hits, int64_t misses, int64_t size) {
+  return AllOf(Field("hits", &CompiledExprCacheStats::hits, hits),
+               Field("misses", &CompiledExprCacheStats::misses, misses),
+               Field("size", &CompiledExprCacheStats::size, size));
+}
+
+class CompiledExprCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SetCompiledExprCacheCapacity(2);
+    ClearCompiledExprCache();
+  }
+  void TearDown() override { SetCompiledExprCacheCapacity(0); }
+};
+
+TEST_F(CompiledExprCacheTest, HitsAndMisses) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  DynamicEvaluationEngineOptions options;
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_float,
+      CompileForDynamicEvaluationWithCache(
+          options, expr, {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_EQ(compiled_float->output_type(), GetQType<float>());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 1, 1));
+
+  // The same expression is compiled only once.
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_float_again,
+      CompileForDynamicEvaluationWithCache(
+          options, expr, {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_EQ(compiled_float_again, compiled_float);
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(1, 1, 1));
+
+  // An equivalent expression with the same fingerprint hits the cache.
+  ASSERT_OK_AND_ASSIGN(auto expr_copy,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      compiled_float_again,
+      CompileForDynamicEvaluationWithCache(
+          options, expr_copy,
+          {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_EQ(compiled_float_again, compiled_float);
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(2, 1, 1));
+
+  // Different input types, options or side outputs cause a miss.
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_int,
+      CompileForDynamicEvaluationWithCache(
+          options, expr, {{"x", GetQType<int>()}, {"y", GetQType<int>()}}));
+  EXPECT_EQ(compiled_int->output_type(), GetQType<int>());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(2, 2, 2));
+  options.collect_op_descriptions = true;
+  EXPECT_THAT(
+      CompileForDynamicEvaluationWithCache(
+          options, expr, {{"x", GetQType<int>()}, {"y", GetQType<int>()}}),
+      IsOk());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(2, 3, 2));
+  EXPECT_THAT(CompileForDynamicEvaluationWithCache(
+                  options, expr,
+                  {{"x", GetQType<int>()}, {"y", GetQType<int>()}},
+                  {{"side", Leaf("x")}}),
+              IsOk());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(2, 4, 2));
+
+  // The first compiled expression was evicted, but the result obtained
+  // earlier stays valid.
+  options.collect_op_descriptions = false;
+  ASSERT_OK_AND_ASSIGN(
+      compiled_float_again,
+      CompileForDynamicEvaluationWithCache(
+          options, expr, {{"x", GetQType<float>()}, {"y", GetQType<float>()}}));
+  EXPECT_NE(compiled_float_again, compiled_float);
+  EXPECT_EQ(compiled_float->output_type(), GetQType<float>());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(2, 5, 2));
+
+  ClearCompiledExprCache();
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 0, 0));
+}
+
+TEST_F(CompiledExprCacheTest, Optimizers) {
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  absl::flat_hash_map<std::string, QTypePtr> input_types = {
+      {"x", GetQType<int>()}, {"y", GetQType<int>()}};
+  // The cache can not look into the optimizers, so they may do nothing.
+  Optimizer optimizer_1 = [](ExprNodePtr node) { return node; };
+  Optimizer optimizer_2 = [](ExprNodePtr node) { return node; };
+
+  // Without the fingerprint the cache can not tell the optimizers apart, so
+  // it is bypassed.
+  DynamicEvaluationEngineOptions options{.optimizer = optimizer_1};
+  EXPECT_THAT(CompileForDynamicEvaluationWithCache(options, expr, input_types),
+              IsOk());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 0, 0));
+  options = DynamicEvaluationEngineOptions{.global_optimizer = optimizer_1};
+  EXPECT_THAT(CompileForDynamicEvaluationWithCache(options, expr, input_types),
+              IsOk());
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 0, 0));
+
+  // The same expression with two different optimizers causes two misses.
+  options = DynamicEvaluationEngineOptions{
+      .optimizer = optimizer_1,
+      .optimizer_fingerprint = FingerprintHasher("optimizer_1").Finish()};
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_1,
+      CompileForDynamicEvaluationWithCache(options, expr, input_types));
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 1, 1));
+  options = DynamicEvaluationEngineOptions{
+      .optimizer = optimizer_2,
+      .optimizer_fingerprint = FingerprintHasher("optimizer_2").Finish()};
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_2,
+      CompileForDynamicEvaluationWithCache(options, expr, input_types));
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 2, 2));
+  EXPECT_NE(compiled_1, compiled_2);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto compiled_2_again,
+      CompileForDynamicEvaluationWithCache(options, expr, input_types));
+  EXPECT_EQ(compiled_2_again, compiled_2);
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(1, 2, 2));
+}
+
+TEST_F(CompiledExprCacheTest, Disabled) {
+  SetCompiledExprCacheCapacity(0);
+  ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(CompileForDynamicEvaluationWithCache(
+                    DynamicEvaluationEngineOptions(), expr,
+                    {{"x", GetQType<float>()}, {"y", GetQType<float>()}}),
+                IsOk());
+  }
+  EXPECT_THAT(GetCompiledExprCacheStats(), StatsAre(0, 0, 0));
+}
+
+}  // namespace
+}  // namespace arolla::expr
@@ -14,6 +14,8 @@
 //
 #include "arolla/expr/eval/dynamic_compiled_expr.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -65,6 +67,7 @@
 #include "arolla/util/demangle.h"
 #include "arolla/util/fingerprint.h"
 #include "arolla/util/status.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr::eval_internal {
 namespace {
@@ -104,6 +107,8 @@ class EvalVisitor {
               const std::vector<std::string>& side_output_names
                   ABSL_ATTRIBUTE_LIFETIME_BOUND,
               absl::flat_hash_map<Fingerprint, QTypePtr> node_types,
+              const absl::flat_hash_map<Fingerprint, OperatorPtr>&
+                  precompiled_operators ABSL_ATTRIBUTE_LIFETIME_BOUND,
               eval_internal::SlotAllocator& slot_allocator
                   ABSL_ATTRIBUTE_LIFETIME_BOUND)
       : options_(std::move(options)),
@@ -113,6 +118,7 @@ class EvalVisitor {
         executable_builder_(executable_builder),
         side_output_names_(side_output_names),
         node_types_(std::move(node_types)),
+        precompiled_operators_(precompiled_operators),
         slot_allocator_(slot_allocator),
         compiler_extensions_(CompilerExtensionRegistry::GetInstance()
                                  .GetCompilerExtensionSet()) {}
@@ -251,6 +257,13 @@ class EvalVisitor {
         }
 
         auto output_slot = maybe_add_output_slot();
+        const QExprOperator* precompiled_op = nullptr;
+        if (!precompiled_operators_.empty()) {
+          if (auto it = precompiled_operators_.find(node->fingerprint());
+              it != precompiled_operators_.end()) {
+            precompiled_op = it->second.get();
+          }
+        }
         if (auto result =
                 compiler_extensions_.compile_operator_fn(CompileOperatorFnArgs{
                     .options = options_,
@@ -258,7 +271,8 @@ class EvalVisitor {
                     .node = node,
                     .input_slots = input_slots,
                     .output_slot = output_slot,
-                    .executable_builder = executable_builder_});
+                    .executable_builder = executable_builder_,
+                    .precompiled_op = precompiled_op});
             result.has_value()) {
           RETURN_IF_ERROR(*result);
           return output_slot;
@@ -393,6 +407,7 @@ class EvalVisitor {
   ExecutableBuilder* executable_builder_;
   const std::vector<std::string>& side_output_names_;
   absl::flat_hash_map<Fingerprint, QTypePtr> node_types_;
+  const absl::flat_hash_map<Fingerprint, OperatorPtr>& precompiled_operators_;
   eval_internal::SlotAllocator& slot_allocator_;
   CompilerExtensionSet compiler_extensions_;
 };
@@ -406,14 +421,16 @@ DynamicCompiledExpr::DynamicCompiledExpr(
     absl::flat_hash_map<std::string, QTypePtr> named_output_types,
     ExprNodePtr prepared_expr, std::vector<std::string> side_output_names,
     absl::flat_hash_map<Fingerprint, QTypePtr> types,
-    BoundExprStackTraceFactory stack_trace_factory)
+    BoundExprStackTraceFactory stack_trace_factory,
+    absl::flat_hash_map<Fingerprint, OperatorPtr> precompiled_operators)
     : CompiledExpr(std::move(input_types), output_type,
                    std::move(named_output_types)),
       options_(std::move(options)),
       prepared_expr_(std::move(prepared_expr)),
       side_output_names_(std::move(side_output_names)),
       types_(std::move(types)),
-      stack_trace_factory_(std::move(stack_trace_factory)) {}
+      stack_trace_factory_(std::move(stack_trace_factory)),
+      precompiled_operators_(std::move(precompiled_operators)) {}
 
 absl::StatusOr<std::unique_ptr<BoundExpr>> DynamicCompiledExpr::Bind(
     FrameLayout::Builder* layout_builder,
@@ -454,7 +471,8 @@ absl::Status DynamicCompiledExpr::BindToExecutableBuilder(
       /*allow_reusing_leaves=*/options_.allow_overriding_input_slots);
   EvalVisitor visitor(
       options_, post_order, input_slots, {std::move(output_expr), output_slot},
-      &executable_builder, side_output_names_, types_, slot_allocator);
+      &executable_builder, side_output_names_, types_, precompiled_operators_,
+      slot_allocator);
 
   std::vector<TypedSlot> results;
   results.reserve(post_order.nodes_size());
@@ -476,4 +494,88 @@ absl::Status DynamicCompiledExpr::BindToExecutableBuilder(
   return absl::OkStatus();
 }
 
+absl::StatusOr<absl::flat_hash_map<Fingerprint, OperatorPtr>>
+PrecompileOperators(const DynamicEvaluationEngineOptions& options,
+                    const ExprNodePtr& prepared_expr,
+                    const absl::flat_hash_map<Fingerprint, QTypePtr>& types) {
+  struct Task {
+    ExprNodePtr node;
+    ExprOperatorPtr decayed_op;
+    std::vector<QTypePtr> input_types;
+    QTypePtr output_type;
+    std::optional<absl::StatusOr<OperatorPtr>> result;
+  };
+  std::vector<Task> tasks;
+  for (const auto& node : VisitorOrder(prepared_expr)) {
+    if (!node->is_op()) {
+      continue;
+    }
+    ASSIGN_OR_RETURN(auto op, DecayRegisteredOperator(node->op()));
+    // Backend operators are looked up in the operator directory.
+    if (HasBackendExprOperatorTag(op)) {
+      continue;
+    }
+    Task task{.node = node, .decayed_op = std::move(op)};
+    ASSIGN_OR_RETURN(task.output_type, LookupQType(node, types));
+    bool has_all_types = task.output_type != nullptr;
+    task.input_types.reserve(node->node_deps().size());
+    for (const auto& dep : node->node_deps()) {
+      ASSIGN_OR_RETURN(QTypePtr dep_type, LookupQType(dep, types));
+      has_all_types = has_all_types && dep_type != nullptr;
+      task.input_types.push_back(dep_type);
+    }
+    // Missing types are reported during binding.
+    if (has_all_types) {
+      tasks.push_back(std::move(task));
+    }
+  }
+  if (tasks.empty()) {
+    return absl::flat_hash_map<Fingerprint, OperatorPtr>{};
+  }
+
+  const PrecompileOperatorFn precompile_operator_fn =
+      CompilerExtensionRegistry::GetInstance()
+          .GetCompilerExtensionSet()
+          .precompile_operator_fn;
+  std::atomic<size_t> next_task = 0;
+  auto worker = [&] {
+    for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+      Task& task = tasks[i];
+      task.result = precompile_operator_fn(PrecompileOperatorFnArgs{
+          .options = options,
+          .decayed_op = task.decayed_op,
+          .input_types = task.input_types,
+          .output_type = task.output_type});
+    }
+  };
+  if (options.threading == nullptr) {
+    worker();
+  } else {
+    ThreadingInterface& threading = *options.threading;
+    const int thread_count = static_cast<int>(std::min<size_t>(
+        std::max(threading.GetRecommendedThreadCount(), 1), tasks.size()));
+    threading.WithThreading([&] {
+      std::vector<ThreadingInterface::JoinFn> join_fns;
+      join_fns.reserve(thread_count - 1);
+      for (int i = 1; i < thread_count; ++i) {
+        join_fns.push_back(threading.StartThread(worker));
+      }
+      worker();
+      for (auto& join : join_fns) join();
+    });
+  }
+
+  absl::flat_hash_map<Fingerprint, OperatorPtr> result;
+  for (Task& task : tasks) {
+    if (!task.result.has_value()) {
+      continue;
+    }
+    ASSIGN_OR_RETURN(OperatorPtr op, *std::move(task.result),
+                     WithNote(_, absl::StrCat("While compiling node ",
+                                              GetDebugSnippet(task.node))));
+    result.emplace(task.node->fingerprint(), std::move(op));
+  }
+  return result;
+}
+
 }  // namespace arolla::expr::eval_internal
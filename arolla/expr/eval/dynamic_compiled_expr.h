@@ -30,6 +30,7 @@
 #include "arolla/expr/expr_node.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qexpr/operators.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/fingerprint.h"
@@ -58,7 +59,8 @@ class DynamicCompiledExpr : public CompiledExpr {
   // PrepareExpression(). If the expression contains side outputs, its root must
   // be InternalRootOperator and all its arguments except the first one must
   // correspond to side_output_names. `types` must contain deduced types for
-  // each node in `prepared_expr`.
+  // each node in `prepared_expr`. `precompiled_operators` must be created by
+  // PrecompileOperators for `prepared_expr`.
   //
   DynamicCompiledExpr(
       DynamicEvaluationEngineOptions options,
@@ -67,7 +69,8 @@ class DynamicCompiledExpr : public CompiledExpr {
       absl::flat_hash_map<std::string, QTypePtr> named_output_types,
       ExprNodePtr prepared_expr, std::vector<std::string> side_output_names,
       absl::flat_hash_map<Fingerprint, QTypePtr> types,
-      BoundExprStackTraceFactory stack_trace_factory = nullptr);
+      BoundExprStackTraceFactory stack_trace_factory = nullptr,
+      absl::flat_hash_map<Fingerprint, OperatorPtr> precompiled_operators = {});
 
   absl::StatusOr<std::unique_ptr<BoundExpr>> Bind(
       FrameLayout::Builder* layout_builder,
@@ -86,8 +89,18 @@ class DynamicCompiledExpr : public CompiledExpr {
   std::vector<std::string> side_output_names_;
   absl::flat_hash_map<Fingerprint, QTypePtr> types_;
   BoundExprStackTraceFactory stack_trace_factory_;  // Can be nullptr.
+  absl::flat_hash_map<Fingerprint, OperatorPtr> precompiled_operators_;
 };
 
+// Creates QExpr operators for the nodes of `prepared_expr` supported by the
+// registered PrecompileOperatorFns, using `options.threading` to run them in
+// parallel. `types` must contain deduced types for each node in
+// `prepared_expr`. Returns a map from node fingerprints to the operators.
+absl::StatusOr<absl::flat_hash_map<Fingerprint, OperatorPtr>>
+PrecompileOperators(const DynamicEvaluationEngineOptions& options,
+                    const ExprNodePtr& prepared_expr,
+                    const absl::flat_hash_map<Fingerprint, QTypePtr>& types);
+
 }  // namespace arolla::expr::eval_internal
 
 #endif  // AROLLA_EXPR_EVAL_DYNAMIC_COMPILED_EXPR_H_
@@ -40,6 +40,7 @@
 #include "arolla/expr/expr_visitor.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/evaluation_engine.h"
+#include "arolla/qexpr/operators.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/fingerprint.h"
@@ -120,11 +121,17 @@ absl::StatusOr<std::unique_ptr<CompiledExpr>> CompileForDynamicEvaluation(
         absl::StrFormat("unable to deduce output type in the expression %s",
                         GetDebugSnippet(prepared_expr)));
   }
+  absl::flat_hash_map<Fingerprint, OperatorPtr> precompiled_operators;
+  if (options.threading != nullptr) {
+    ASSIGN_OR_RETURN(precompiled_operators,
+                     eval_internal::PrecompileOperators(options, prepared_expr,
+                                                        node_types));
+  }
   return std::unique_ptr<CompiledExpr>(new eval_internal::DynamicCompiledExpr(
       options, std::move(used_input_types), output_type,
       std::move(named_output_types), std::move(prepared_expr),
       std::move(side_output_names), std::move(node_types),
-      stack_trace->StartBinding()));
+      stack_trace->StartBinding(), std::move(precompiled_operators)));
 }
 
 absl::StatusOr<std::unique_ptr<BoundExpr>> CompileAndBindForDynamicEvaluation(
@@ -31,6 +31,8 @@
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qexpr/operators.h"
 #include "arolla/qtype/qtype.h"
+#include "arolla/util/fingerprint.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr {
 
@@ -66,6 +68,19 @@ struct DynamicEvaluationEngineOptions {
   // If missing, no optimizations will be applied.
   std::optional<Optimizer> optimizer = std::nullopt;
 
+  // A function to apply once to the whole expression, after `optimizer` and
+  // the other per-node preparation stages. Unlike `optimizer` it sees all the
+  // nodes at once, so it can rewrite nodes that are far from each other (e.g.
+  // FuseDecisionForestOperators). The result must contain only backend
+  // operators. Applied only if kOptimization stage is enabled.
+  std::optional<Optimizer> global_optimizer = std::nullopt;
+
+  // Identifies `optimizer` and `global_optimizer` for the compiled expressions
+  // cache (see compiled_expr_cache.h); must be different for different
+  // optimizers. Optimizers are arbitrary functions, so if any of them is set
+  // without the fingerprint, the expression is compiled bypassing the cache.
+  std::optional<Fingerprint> optimizer_fingerprint = std::nullopt;
+
   // If true, the compiled expression can override the input slots once it does
   // not need them anymore. Use this option only when the compiled expression is
   // the only (or last) reader of the input slots.
@@ -80,6 +95,13 @@ struct DynamicEvaluationEngineOptions {
   // during expression compilation, map them to BoundOperators during binding,
   // and output the detailed trace if an error is thrown during evaluation.
   bool enable_expr_stack_trace = false;
+
+  // If set, QExpr operators that are expensive to create (e.g. for decision
+  // forests) are created in parallel during the compilation, instead of
+  // sequentially during the binding. The created operators are stored in the
+  // CompiledExpr and reused by all its Bind calls. Must remain valid until
+  // objects generated by DynamicEvaluationEngine are bound.
+  ThreadingInterface* absl_nullable threading = nullptr;
 };
 
 // Compiles the given expression for dynamic evaluation. The expression must not
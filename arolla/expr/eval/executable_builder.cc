@@ -67,6 +67,7 @@ class DynamicBoundExprImpl : public DynamicBoundExpr {
                          std::move(named_output_slots)),
         init_ops_(std::move(init_ops)),
         eval_ops_(std::move(eval_ops)),
+        direct_eval_ops_(eval_ops_),
         init_op_descriptions_(std::move(init_op_descriptions)),
         eval_op_descriptions_(std::move(eval_op_descriptions)),
         annotate_error_(std::move(annotate_error)) {}
@@ -76,7 +77,7 @@ class DynamicBoundExprImpl : public DynamicBoundExpr {
   }
 
   void Execute(EvaluationContext* ctx, FramePtr frame) const final {
-    int64_t last_ip = RunBoundOperators(eval_ops_, ctx, frame);
+    int64_t last_ip = direct_eval_ops_.Run(ctx, frame);
     if (!ctx->status().ok()) {
       if (annotate_error_ != nullptr) {
         // TODO: Consider adding ctx->mutable_status() to avoid
@@ -96,6 +97,8 @@ class DynamicBoundExprImpl : public DynamicBoundExpr {
  private:
   std::vector<std::unique_ptr<BoundOperator>> init_ops_;
   std::vector<std::unique_ptr<BoundOperator>> eval_ops_;
+  // The same as eval_ops_, prepared to run without virtual calls.
+  DirectThreadedOperators direct_eval_ops_;
   std::vector<std::string> init_op_descriptions_;
   std::vector<std::string> eval_op_descriptions_;
   // Using DenseArray<Text> instead of std::vector<std::string> to reduce
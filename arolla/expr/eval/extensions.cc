@@ -27,6 +27,7 @@
 #include "arolla/expr/eval/prepare_expression.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
+#include "arolla/qexpr/operators.h"
 
 namespace arolla::expr::eval_internal {
 
@@ -65,6 +66,18 @@ CompilerExtensionSet CompilerExtensionRegistry::GetCompilerExtensionSet()
           }
         }
         return std::nullopt;
+      },
+      .precompile_operator_fn =
+          [precompile_operator_fns = precompile_operator_fns_](
+              const PrecompileOperatorFnArgs& args)
+          -> std::optional<absl::StatusOr<OperatorPtr>> {
+        for (const auto& fn : precompile_operator_fns) {
+          std::optional<absl::StatusOr<OperatorPtr>> result = fn(args);
+          if (result.has_value()) {
+            return result;
+          }
+        }
+        return std::nullopt;
       }};
 }
 
@@ -80,4 +93,10 @@ void CompilerExtensionRegistry::RegisterCompileOperatorFn(
   compile_operator_fns_.push_back(fn);
 }
 
+void CompilerExtensionRegistry::RegisterPrecompileOperatorFn(
+    PrecompileOperatorFn fn) {
+  absl::MutexLock lock(mutex_);
+  precompile_operator_fns_.push_back(fn);
+}
+
 }  // namespace arolla::expr::eval_internal
@@ -19,8 +19,10 @@
 #include <optional>
 #include <vector>
 
+#include "absl/base/nullability.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/eval.h"
@@ -28,6 +30,8 @@
 #include "arolla/expr/eval/prepare_expression.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_operator.h"
+#include "arolla/qexpr/operators.h"
+#include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_slot.h"
 
 namespace arolla::expr::eval_internal {
@@ -40,6 +44,8 @@ struct CompileOperatorFnArgs {
   absl::Span<const TypedSlot> input_slots;
   TypedSlot output_slot;
   ExecutableBuilder* executable_builder;
+  // The operator created by PrecompileOperatorFn for the node, if any.
+  const QExprOperator* absl_nullable precompiled_op = nullptr;
 };
 
 // Callback to compile an operator into executable builder. The function must
@@ -52,6 +58,26 @@ struct CompileOperatorFnArgs {
 using CompileOperatorFn = std::function<std::optional<absl::Status>(
     const CompileOperatorFnArgs& args)>;
 
+// Arguments to PrecompileOperatorFn.
+struct PrecompileOperatorFnArgs {
+  const DynamicEvaluationEngineOptions& options;
+  const ExprOperatorPtr& decayed_op;
+  absl::Span<const QTypePtr> input_types;
+  QTypePtr output_type;
+};
+
+// Callback to create a QExpr operator for an expression node before binding.
+// Used only if DynamicEvaluationEngineOptions::threading is set; the calls for
+// different nodes may run in parallel, so the function must be thread-safe.
+// The created operator is passed to CompileOperatorFn as `precompiled_op`.
+// The function must return one of:
+//   - std::nullopt - if the given operator is not supported. In this case the
+//     node will be compiled by CompileOperatorFn without `precompiled_op`.
+//   - the created operator or an error.
+using PrecompileOperatorFn =
+    std::function<std::optional<absl::StatusOr<OperatorPtr>>(
+        const PrecompileOperatorFnArgs& args)>;
+
 // A set of compiler extensions.
 struct CompilerExtensionSet {
   // Function to transform the expression during the preparation stage, combines
@@ -60,6 +86,9 @@ struct CompilerExtensionSet {
   // Function to compile operators into an ExecutableExpr, combines all the
   // registered CompileOperatorFns.
   CompileOperatorFn compile_operator_fn;
+  // Function to create QExpr operators ahead of binding, combines all the
+  // registered PrecompileOperatorFns.
+  PrecompileOperatorFn precompile_operator_fn;
 };
 
 // Global registry of NodeTransformationFn's and CompileOperatorFn's, that will
@@ -83,11 +112,17 @@ class CompilerExtensionRegistry {
   // CompileOperatorFn doc.
   void RegisterCompileOperatorFn(CompileOperatorFn fn);
 
+  // Register a callback to create QExpr operators ahead of binding. See
+  // PrecompileOperatorFn doc.
+  void RegisterPrecompileOperatorFn(PrecompileOperatorFn fn);
+
  private:
   mutable absl::Mutex mutex_;
   std::vector<NodeTransformationFn> node_transformation_fns_
       ABSL_GUARDED_BY(mutex_);
   std::vector<CompileOperatorFn> compile_operator_fns_ ABSL_GUARDED_BY(mutex_);
+  std::vector<PrecompileOperatorFn> precompile_operator_fns_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace arolla::expr::eval_internal
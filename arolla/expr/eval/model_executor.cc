@@ -15,6 +15,8 @@
 #include "arolla/expr/eval/model_executor.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <set>
@@ -24,6 +26,7 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/statusor.h"
@@ -31,19 +34,24 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "arolla/dense_array/qtype/types.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/expr.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/operators/bootstrap_operators.h"
 #include "arolla/io/slot_listener.h"
 #include "arolla/memory/frame.h"
+#include "arolla/memory/memory_allocation.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qexpr/simple_executable.h"
+#include "arolla/qtype/array_like/array_like_qtype.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
+#include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/util/status.h"
 #include "arolla/util/string.h"
@@ -305,6 +313,17 @@ std::unique_ptr<CompiledExpr> CastOutputsIfNeeded(
                                                side_output_types, options);
 }
 
+bool IsRowSpecificError(const absl::Status& status) {
+  switch (status.code()) {
+    case absl::StatusCode::kCancelled:
+    case absl::StatusCode::kDeadlineExceeded:
+    case absl::StatusCode::kResourceExhausted:
+      return false;
+    default:
+      return true;
+  }
+}
+
 absl::Status VerifyAllNamedOutputsAreListened(
     const absl::flat_hash_map<std::string, QTypePtr>&
         available_named_output_types,
@@ -329,4 +348,152 @@ absl::Status VerifyAllNamedOutputsAreListened(
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::unique_ptr<FramePool>> FramePool::Create(
+    size_t size, const FrameLayout& layout,
+    absl::Span<const BoundExpr* const> evaluators) {
+  MemoryAllocation alloc(&layout);
+  void* data = alloc.frame().GetRawPointer(0);
+  const std::string initial_bytes(static_cast<const char*>(data),
+                                  layout.AllocSize());
+  EvaluationContext ctx;
+  for (const BoundExpr* evaluator : evaluators) {
+    evaluator->InitializeLiterals(&ctx, alloc.frame());
+    RETURN_IF_ERROR(ctx.status());
+  }
+  return std::unique_ptr<FramePool>(
+      new FramePool(size, layout.FieldsUnchangedSince(data, initial_bytes)));
+}
+
+FramePool::~FramePool() {
+  for (auto& slot : slots_) {
+    delete slot.load(std::memory_order_relaxed);
+  }
+}
+
+std::unique_ptr<MemoryAllocation> FramePool::Pop() {
+  for (auto& slot : slots_) {
+    if (slot.load(std::memory_order_relaxed) != nullptr) {
+      if (MemoryAllocation* alloc =
+              slot.exchange(nullptr, std::memory_order_acquire)) {
+        return std::unique_ptr<MemoryAllocation>(alloc);
+      }
+    }
+  }
+  return nullptr;
+}
+
+void FramePool::Push(std::unique_ptr<MemoryAllocation> alloc) {
+  non_literal_fields_.Reset(alloc->frame().GetRawPointer(0));
+  for (auto& slot : slots_) {
+    MemoryAllocation* expected = nullptr;
+    if (slot.load(std::memory_order_relaxed) == nullptr &&
+        slot.compare_exchange_strong(expected, alloc.get(),
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+      alloc.release();
+      return;
+    }
+  }
+}
+
+absl::StatusOr<std::unique_ptr<LiftedModel>> LiftedModel::Compile(
+    const ExprNodePtr& expr,
+    const absl::flat_hash_map<std::string, TypedSlot>& scalar_input_slots,
+    TypedSlot scalar_output_slot, const ModelExecutorOptions& options) {
+  absl::flat_hash_map<std::string, QTypePtr> array_input_types;
+  array_input_types.reserve(scalar_input_slots.size());
+  for (const auto& [name, slot] : scalar_input_slots) {
+    ASSIGN_OR_RETURN(
+        array_input_types[name],
+        GetDenseArrayQTypeByValueQType(DecayOptionalQType(slot.GetType())));
+  }
+  ASSIGN_OR_RETURN(QTypePtr array_output_type,
+                   GetDenseArrayQTypeByValueQType(
+                       DecayOptionalQType(scalar_output_slot.GetType())));
+  ASSIGN_OR_RETURN(auto compiled_expr,
+                   CompileForDynamicEvaluation(options.eval_options, expr,
+                                               array_input_types));
+  // E.g. an expression that doesn't depend on the inputs stays scalar.
+  if (!IsDenseArrayQType(compiled_expr->output_type())) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("lifted model returns %s instead of an array",
+                        compiled_expr->output_type()->name()));
+  }
+  auto compiled_expr_with_casts = CastOutputsIfNeeded(
+      *compiled_expr, array_output_type, /*slot_listener=*/nullptr, options);
+  FrameLayout::Builder layout_builder;
+  auto array_input_slots = AddSlotsMap(array_input_types, &layout_builder);
+  ASSIGN_OR_RETURN(
+      auto evaluator,
+      compiled_expr_with_casts->Bind(&layout_builder, array_input_slots,
+                                     /*output_slot=*/std::nullopt));
+  std::vector<std::pair<TypedSlot, TypedSlot>> input_slots;
+  input_slots.reserve(scalar_input_slots.size());
+  for (const auto& [name, slot] : scalar_input_slots) {
+    input_slots.emplace_back(slot, array_input_slots.at(name));
+  }
+  return std::unique_ptr<LiftedModel>(new LiftedModel(
+      std::move(layout_builder).Build(), std::move(evaluator),
+      std::move(input_slots), scalar_output_slot));
+}
+
+absl::Status LiftedModel::Execute(EvaluationContext& ctx, int64_t row_count,
+                                  absl::Span<FramePtr> frames,
+                                  FramesFn load_fn, FramesFn store_fn) const {
+  DCHECK(!frames.empty() || row_count == 0);
+  MemoryAllocation alloc(&layout_);
+  FramePtr arrays_frame = alloc.frame();
+  evaluator_->InitializeLiterals(&ctx, arrays_frame);
+  RETURN_IF_ERROR(ctx.status());
+
+  absl::flat_hash_map<QTypePtr, std::unique_ptr<BatchFromFramesCopier>>
+      input_copiers;
+  for (const auto& [scalar_slot, array_slot] : input_slots_) {
+    auto& copier = input_copiers[array_slot.GetType()];
+    if (copier == nullptr) {
+      ASSIGN_OR_RETURN(copier,
+                       CreateBatchFromFramesCopier(array_slot.GetType(),
+                                                   &ctx.buffer_factory()));
+    }
+    RETURN_IF_ERROR(copier->AddMapping(scalar_slot, array_slot));
+  }
+  for (auto& [_, copier] : input_copiers) {
+    copier->Start(row_count);
+  }
+  std::vector<ConstFramePtr> const_frames(frames.begin(), frames.end());
+  for (int64_t offset = 0; offset < row_count; offset += frames.size()) {
+    int64_t count = std::min<int64_t>(frames.size(), row_count - offset);
+    RETURN_IF_ERROR(load_fn(offset, frames.subspan(0, count)));
+    for (auto& [_, copier] : input_copiers) {
+      RETURN_IF_ERROR(copier->CopyNextBatch(
+          absl::MakeConstSpan(const_frames).subspan(0, count)));
+    }
+  }
+  for (auto& [_, copier] : input_copiers) {
+    RETURN_IF_ERROR(copier->Finalize(arrays_frame));
+  }
+
+  evaluator_->Execute(&ctx, arrays_frame);
+  RETURN_IF_ERROR(ctx.status());
+
+  TypedRef output = TypedRef::FromSlot(evaluator_->output_slot(), arrays_frame);
+  ASSIGN_OR_RETURN(int64_t output_size, GetArraySize(output));
+  if (output_size != row_count) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "lifted model returned an array of size %d for %d rows; is the model "
+        "pointwise?",
+        output_size, row_count));
+  }
+  ASSIGN_OR_RETURN(auto output_copier,
+                   CreateBatchToFramesCopier(output.GetType()));
+  RETURN_IF_ERROR(output_copier->AddMapping(output, scalar_output_slot_));
+  output_copier->Start();
+  for (int64_t offset = 0; offset < row_count; offset += frames.size()) {
+    int64_t count = std::min<int64_t>(frames.size(), row_count - offset);
+    output_copier->CopyNextBatch(frames.subspan(0, count));
+    RETURN_IF_ERROR(store_fn(offset, frames.subspan(0, count)));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace arolla::expr::model_executor_impl
@@ -15,6 +15,8 @@
 #ifndef AROLLA_EXPR_EVAL_MODEL_EXECUTOR_H_
 #define AROLLA_EXPR_EVAL_MODEL_EXECUTOR_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -28,19 +30,23 @@
 #include "absl/base/nullability.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/compiled_expr_cache.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/side_output.h"
 #include "arolla/expr/expr_node.h"
 #include "arolla/expr/expr_visitor.h"
 #include "arolla/io/input_loader.h"
 #include "arolla/io/slot_listener.h"
+#include "arolla/memory/arena_pool.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/memory_allocation.h"
 #include "arolla/memory/optional_value.h"
@@ -48,6 +54,7 @@
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qtype/base_types.h"
+#include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/qtype_traits.h"
 #include "arolla/qtype/typed_slot.h"
@@ -78,13 +85,54 @@ struct ModelExecutorOptions {
   bool allow_side_outputs_casting = false;
 
   // Using arena can improve performance for evaluation in batches with types
-  // using RawBufferFactory (e.g., DenseArray or Array).
+  // using RawBufferFactory (e.g., DenseArray or Array). ExecuteOnHeap and
+  // ExecuteOnStack borrow the arenas from a thread-local pool (see
+  // PooledArena and SetArenaPoolOptions for the limits of the pool).
   int64_t arena_page_size = 0;  // 0 means that no arena should be used.
 
   // If the provided SlotListener does not accept a named output — the default
   // implementation will raise an error. Set this option to true to silently
   // ignore such named outputs instead.
   bool ignore_not_listened_named_outputs = false;
+
+  // Number of frames with initialized literals that ExecuteOnHeap keeps for
+  // reuse, so that the literals (e.g. large arrays or dicts) are not copied on
+  // every call. When a frame is returned to the pool, all its non-trivial
+  // fields except the literals are reset, so the pool doesn't keep the inputs
+  // and intermediate results of the previous evaluation alive. 0 disables the
+  // pool.
+  size_t frame_pool_size = 0;
+
+  // Reuse compiled expressions from the process-wide cache, see
+  // compiled_expr_cache.h. Has no effect unless the cache capacity is set
+  // with SetCompiledExprCacheCapacity, or if eval_options has an optimizer
+  // but no optimizer_fingerprint. ExprCompiler::SetUseCompiledExprCache sets
+  // this option, and ExprCompiler sets optimizer_fingerprint for the default
+  // optimizer.
+  bool use_compiled_expr_cache = false;
+
+  // Also compile a version of the model lifted to DenseArrays, so that
+  // ExecuteBatch evaluates all the rows in a single pass. Must be used only
+  // with pointwise models, i.e. when the result for each row depends only on
+  // the inputs of the same row. If the model can not be lifted (e.g. some
+  // operator has no DenseArray implementation), ExecuteBatch evaluates the
+  // rows one by one.
+  //
+  // The lifted model is not equivalent to the scalar one in general:
+  //  - It evaluates every operator on all the rows. E.g. both branches of a
+  //    short-circuit `core.where` are computed, so a row can fail in a branch
+  //    that the scalar model would skip.
+  //  - A failure in any row (including input loading) fails the whole pass.
+  //  - Operators whose result depends on the shape of the input (e.g.
+  //    aggregations, or literals that become arrays) behave differently.
+  // To keep the results of ExecuteBatch the same as of Execute for pointwise
+  // models, ExecuteBatch reevaluates the rows one by one if the lifted pass
+  // fails, so an error is returned only if some row fails on its own. Errors
+  // that are not specific to the rows (cancellation, deadline, resource
+  // exhaustion) are returned without reevaluation. It is the caller's
+  // responsibility to not enable the option for models with non-pointwise
+  // operators.
+  bool enable_batch_lifting = false;
 };
 
 namespace model_executor_impl {
@@ -99,6 +147,12 @@ std::unique_ptr<CompiledExpr> CastOutputsIfNeeded(
 template <typename T>
 struct OutputTraits;
 
+// Returns true if a failure of the lifted model with `status` may be caused by
+// some of the rows, so the rows need to be reevaluated one by one to find out
+// which of them fail. False for errors that would affect any evaluation, like
+// cancellation, deadline or resource exhaustion.
+bool IsRowSpecificError(const absl::Status& status);
+
 absl::Status VerifyAllInputsAreAvailable(
     const ExprNodePtr& expr,
     const absl::flat_hash_map<std::string, QTypePtr>& input_types);
@@ -108,6 +162,80 @@ absl::Status VerifyAllNamedOutputsAreListened(
         available_named_output_types,
     const SlotListenerBase& slot_listener);
 
+// A thread-safe pool of frames with initialized literals. The frames are
+// stored in a fixed number of atomic slots, so no locking is needed.
+class FramePool {
+ public:
+  // Creates a pool of `size` frames of the given layout. The fields that are
+  // not initialized by InitializeLiterals of `evaluators` are reset when a
+  // frame is returned to the pool.
+  static absl::StatusOr<std::unique_ptr<FramePool>> Create(
+      size_t size, const FrameLayout& layout,
+      absl::Span<const BoundExpr* const> evaluators);
+
+  ~FramePool();
+
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  // Takes a frame from the pool, or returns nullptr if the pool is empty.
+  std::unique_ptr<MemoryAllocation> Pop();
+
+  // Resets the non-literal fields of the frame and returns it to the pool, or
+  // destroys it if the pool is full.
+  void Push(std::unique_ptr<MemoryAllocation> alloc);
+
+ private:
+  FramePool(size_t size, FrameLayout::FieldSubset non_literal_fields)
+      : slots_(size), non_literal_fields_(std::move(non_literal_fields)) {}
+
+  std::vector<std::atomic<MemoryAllocation*>> slots_;
+  FrameLayout::FieldSubset non_literal_fields_;
+};
+
+// A model lifted to DenseArrays. Evaluates a batch of rows by gathering the
+// scalar inputs from a sequence of frames into arrays, evaluating the lifted
+// model once and scattering the resulting array back into the scalar output
+// slot of the frames.
+class LiftedModel {
+ public:
+  using FramesFn =
+      absl::FunctionRef<absl::Status(int64_t offset,
+                                     absl::Span<const FramePtr> frames)>;
+
+  // Compiles `expr` with the types of `scalar_input_slots` replaced by the
+  // corresponding DenseArray types. Returns an error if the expression can not
+  // be lifted or if its output can not be stored into `scalar_output_slot`.
+  static absl::StatusOr<std::unique_ptr<LiftedModel>> Compile(
+      const ExprNodePtr& expr,
+      const absl::flat_hash_map<std::string, TypedSlot>& scalar_input_slots,
+      TypedSlot scalar_output_slot, const ModelExecutorOptions& options);
+
+  // Evaluates the model on `row_count` rows, using `frames` as a buffer.
+  // `load_fn(offset, frames)` must populate the scalar inputs of the rows
+  // [offset, offset + frames.size()). `store_fn(offset, frames)` is called
+  // when the scalar output slot of the frames contains the results for the
+  // same rows.
+  absl::Status Execute(EvaluationContext& ctx, int64_t row_count,
+                       absl::Span<FramePtr> frames, FramesFn load_fn,
+                       FramesFn store_fn) const;
+
+ private:
+  LiftedModel(FrameLayout layout, std::unique_ptr<BoundExpr> evaluator,
+              std::vector<std::pair<TypedSlot, TypedSlot>> input_slots,
+              TypedSlot scalar_output_slot)
+      : layout_(std::move(layout)),
+        evaluator_(std::move(evaluator)),
+        input_slots_(std::move(input_slots)),
+        scalar_output_slot_(scalar_output_slot) {}
+
+  FrameLayout layout_;
+  std::unique_ptr<BoundExpr> evaluator_;
+  // Pairs of (scalar slot, array slot) for each input.
+  std::vector<std::pair<TypedSlot, TypedSlot>> input_slots_;
+  TypedSlot scalar_output_slot_;
+};
+
 }  // namespace model_executor_impl
 
 // A higher-level end to end wrapper to evaluate a Arolla model, reading inputs
@@ -170,26 +298,49 @@ class ModelExecutor {
     // reuse them for its own needs.
     DynamicEvaluationEngineOptions eval_options = options.eval_options;
     eval_options.allow_overriding_input_slots = true;
-    ASSIGN_OR_RETURN(
-        auto compiled_expr,
-        CompileForDynamicEvaluation(eval_options, stripped_expr, input_types,
-                                    /*side_outputs=*/{}),
-        WithNote(_, "While compiling the expression."));
-    std::unique_ptr<CompiledExpr> compiled_expr_with_side_output;
+    // Bind doesn't keep references to the compiled expressions, so they can
+    // be shared with the cache.
+    auto compile =
+        [&](const absl::flat_hash_map<std::string, ExprNodePtr>& side_outputs)
+        -> absl::StatusOr<std::shared_ptr<const CompiledExpr>> {
+      if (options.use_compiled_expr_cache) {
+        return CompileForDynamicEvaluationWithCache(
+            eval_options, stripped_expr, input_types, side_outputs);
+      }
+      return CompileForDynamicEvaluation(eval_options, stripped_expr,
+                                         input_types, side_outputs);
+    };
+    ASSIGN_OR_RETURN(auto compiled_expr, compile(/*side_outputs=*/{}),
+                     WithNote(_, "While compiling the expression."));
+    std::shared_ptr<const CompiledExpr> compiled_expr_with_side_output;
     if (slot_listener != nullptr) {
       ASSIGN_OR_RETURN(
           side_outputs,
           PrepareSideOutputsForListener(side_outputs, *slot_listener),
           WithNote(_, "While preparing side outputs."));
       ASSIGN_OR_RETURN(
-          compiled_expr_with_side_output,
-          CompileForDynamicEvaluation(eval_options, stripped_expr, input_types,
-                                      side_outputs),
+          compiled_expr_with_side_output, compile(side_outputs),
           WithNote(_, "While compiling the expression with side outputs."));
     }
-    return ModelExecutor::Bind(*compiled_expr, input_loader,
-                               compiled_expr_with_side_output.get(),
-                               slot_listener, options);
+    ASSIGN_OR_RETURN(auto executor,
+                     ModelExecutor::Bind(*compiled_expr, input_loader,
+                                         compiled_expr_with_side_output.get(),
+                                         slot_listener, options));
+    if (options.enable_batch_lifting) {
+      const BoundExpr& evaluator = *executor.shared_data_->evaluator;
+      // The lifted model can't check presence of each row separately, so
+      // models with `force_non_optional_output` applied are not lifted.
+      if (!IsOptionalQType(compiled_expr->output_type()) ||
+          IsOptionalQType(evaluator.output_slot().GetType())) {
+        auto lifted_model = model_executor_impl::LiftedModel::Compile(
+            stripped_expr, evaluator.input_slots(), evaluator.output_slot(),
+            options);
+        if (lifted_model.ok()) {
+          executor.lifted_model_ = *std::move(lifted_model);
+        }
+      }
+    }
+    return executor;
   }
 
   // Binds compiled expression to the given input_loader and creates
@@ -231,13 +382,13 @@ class ModelExecutor {
                                  SideOutput* side_output = nullptr) {
     DCHECK(IsValid());
     if (arena_ != nullptr) {
-      EvaluationContext ctx({.buffer_factory = arena_.get()});
+      EvaluationContext ctx(WithBufferFactory(eval_options, arena_.get()));
       absl::StatusOr<Output> res = ExecuteOnFrame</*kInitLiterals=*/false>(
           ctx, alloc_.frame(), input, side_output);
       arena_->Reset();  // reusing arena memory
       return res;
     } else {
-      EvaluationContext ctx({.buffer_factory = eval_options.buffer_factory});
+      EvaluationContext ctx(eval_options);
       return ExecuteOnFrame</*kInitLiterals=*/false>(ctx, alloc_.frame(), input,
                                                      side_output);
     }
@@ -247,17 +398,72 @@ class ModelExecutor {
     return Execute({}, input, side_output);
   }
 
+  // Executes the expression on each of the given inputs. If the executor was
+  // compiled with `enable_batch_lifting` and the model could be lifted (see
+  // IsBatchLifted()), all the rows are evaluated in a single pass of the
+  // lifted model, falling back to evaluating the rows one by one if the pass
+  // fails with an error that may be specific to some rows (see
+  // `enable_batch_lifting`). Otherwise it is equivalent to calling Execute for
+  // each of the inputs.
+  //
+  // The function is not thread safe.
+  absl::StatusOr<std::vector<Output>> ExecuteBatch(
+      const EvaluationOptions& eval_options, absl::Span<const Input> inputs) {
+    return ExecuteBatchImpl(
+        eval_options, inputs.size(),
+        [inputs](int64_t i) -> const Input& { return inputs[i]; });
+  }
+  absl::StatusOr<std::vector<Output>> ExecuteBatch(
+      absl::Span<const Input> inputs) {
+    return ExecuteBatch({}, inputs);
+  }
+
+  // Same as above, but the inputs are passed by pointers, so the caller does
+  // not need to store them contiguously.
+  absl::StatusOr<std::vector<Output>> ExecuteBatch(
+      const EvaluationOptions& eval_options,
+      absl::Span<const Input* const> inputs) {
+    return ExecuteBatchImpl(
+        eval_options, inputs.size(),
+        [inputs](int64_t i) -> const Input& { return *inputs[i]; });
+  }
+
+  // Same as ExecuteBatch, but returns a separate result for every row, so that
+  // an error in one row does not affect the results of the other rows. An
+  // error that is not specific to the rows (see `enable_batch_lifting`) is
+  // returned for all of them.
+  //
+  // The function is not thread safe.
+  std::vector<absl::StatusOr<Output>> ExecuteBatchPerRow(
+      const EvaluationOptions& eval_options, absl::Span<const Input> inputs) {
+    return ExecuteBatchPerRowImpl(
+        eval_options, inputs.size(),
+        [inputs](int64_t i) -> const Input& { return inputs[i]; });
+  }
+  std::vector<absl::StatusOr<Output>> ExecuteBatchPerRow(
+      const EvaluationOptions& eval_options,
+      absl::Span<const Input* const> inputs) {
+    return ExecuteBatchPerRowImpl(
+        eval_options, inputs.size(),
+        [inputs](int64_t i) -> const Input& { return *inputs[i]; });
+  }
+
+  // Returns true if ExecuteBatch uses the model lifted to DenseArrays.
+  bool IsBatchLifted() const { return lifted_model_ != nullptr; }
+
   // Executes the expression on the given input allocating on heap.
   // Function is thread safe, but has the following overhead
   // 0. Heap allocation
   // 1. Context initialization
   // 2. Expression literals initialization
+  // The last two are skipped if ModelExecutorOptions::frame_pool_size is set
+  // and a frame from the pool can be reused.
   absl::StatusOr<Output> ExecuteOnHeap(
       const EvaluationOptions& eval_options, const Input& input,
       SideOutput* side_output = nullptr) const {
     if (arena_ != nullptr) {
-      UnsafeArenaBufferFactory arena(shared_data_->arena_page_size);
-      EvaluationContext ctx({.buffer_factory = &arena});
+      PooledArena arena(shared_data_->arena_page_size);
+      EvaluationContext ctx(WithBufferFactory(eval_options, arena.get()));
       return ExecuteOnHeapWithContext(ctx, input, side_output);
     } else {
       EvaluationContext ctx(eval_options);
@@ -290,8 +496,8 @@ class ModelExecutor {
         << " non standard alignment required <=" << alignof(size_t)
         << " actual:" << shared_data_->layout.AllocAlignment();
     if (arena_ != nullptr) {
-      UnsafeArenaBufferFactory arena(shared_data_->arena_page_size);
-      EvaluationContext ctx({.buffer_factory = &arena});
+      PooledArena arena(shared_data_->arena_page_size);
+      EvaluationContext ctx(WithBufferFactory(eval_options, arena.get()));
       return ExecuteOnStackWithContext<kStackSize>(ctx, input, side_output);
     } else {
       EvaluationContext ctx(eval_options);
@@ -304,7 +510,11 @@ class ModelExecutor {
   // It is cheaper then constructing it from scratch using Compile() function,
   // because no Expr compilation is required. However it is not free due to
   // literals initialization.
-  absl::StatusOr<ModelExecutor> Clone() const { return Create(shared_data_); }
+  absl::StatusOr<ModelExecutor> Clone() const {
+    ASSIGN_OR_RETURN(ModelExecutor clone, Create(shared_data_));
+    clone.lifted_model_ = lifted_model_;
+    return clone;
+  }
 
   // Returns false if the ModelExecutor is invalid. This can happen only in case
   // of use-after-move.
@@ -319,6 +529,8 @@ class ModelExecutor {
     typename OutputTraits::OutputSlot output_slot;
     BoundSlotListener<SideOutput> bound_listener = nullptr;
     int64_t arena_page_size;  // 0 means no arena should be used
+    // nullptr if ModelExecutorOptions::frame_pool_size is 0.
+    std::unique_ptr<model_executor_impl::FramePool> frame_pool = nullptr;
   };
 
   explicit ModelExecutor(std::shared_ptr<const SharedData> shared_data,
@@ -328,9 +540,30 @@ class ModelExecutor {
         arena_(std::move(arena)),
         alloc_(std::move(alloc)) {}
 
+  // Returns `eval_options` with the buffer factory replaced, keeping the other
+  // options (e.g. threading).
+  static EvaluationOptions WithBufferFactory(
+      EvaluationOptions eval_options, RawBufferFactory* buffer_factory) {
+    eval_options.buffer_factory = buffer_factory;
+    return eval_options;
+  }
+
   absl::StatusOr<Output> ExecuteOnHeapWithContext(
       EvaluationContext& ctx, const Input& input,
       SideOutput* side_output) const {
+    if (shared_data_->frame_pool != nullptr) {
+      std::unique_ptr<MemoryAllocation> alloc =
+          shared_data_->frame_pool->Pop();
+      if (alloc == nullptr) {
+        ASSIGN_OR_RETURN(MemoryAllocation new_alloc,
+                         AllocateFrameWithLiterals(*shared_data_));
+        alloc = std::make_unique<MemoryAllocation>(std::move(new_alloc));
+      }
+      absl::StatusOr<Output> result = ExecuteOnFrame</*kInitLiterals=*/false>(
+          ctx, alloc->frame(), input, side_output);
+      shared_data_->frame_pool->Push(std::move(alloc));
+      return result;
+    }
     MemoryAllocation alloc(&shared_data_->layout);
     return ExecuteOnFrame</*kInitLiterals=*/true>(ctx, alloc.frame(), input,
                                                   side_output);
@@ -351,6 +584,126 @@ class ModelExecutor {
         ctx, FramePtr(&memory, &shared_data_->layout), input, side_output);
   }
 
+  // `get_input(i)` must return the i-th of the `row_count` inputs.
+  template <typename GetInputFn>
+  absl::StatusOr<std::vector<Output>> ExecuteBatchImpl(
+      const EvaluationOptions& eval_options, int64_t row_count,
+      const GetInputFn& get_input) {
+    DCHECK(IsValid());
+    if (lifted_model_ == nullptr) {
+      return ExecuteBatchRowByRow(eval_options, row_count, get_input);
+    }
+    absl::StatusOr<std::vector<Output>> res =
+        ExecuteBatchLifted(eval_options, row_count, get_input);
+    if (!res.ok() && model_executor_impl::IsRowSpecificError(res.status())) {
+      // The lifted model fails if any row fails, including the rows that the
+      // scalar model would process successfully (see `enable_batch_lifting`).
+      // Find out which rows really fail.
+      return ExecuteBatchRowByRow(eval_options, row_count, get_input);
+    }
+    return res;
+  }
+
+  template <typename GetInputFn>
+  std::vector<absl::StatusOr<Output>> ExecuteBatchPerRowImpl(
+      const EvaluationOptions& eval_options, int64_t row_count,
+      const GetInputFn& get_input) {
+    DCHECK(IsValid());
+    std::vector<absl::StatusOr<Output>> results;
+    results.reserve(row_count);
+    if (lifted_model_ != nullptr) {
+      absl::StatusOr<std::vector<Output>> res =
+          ExecuteBatchLifted(eval_options, row_count, get_input);
+      if (res.ok()) {
+        for (Output& output : *res) {
+          results.push_back(std::move(output));
+        }
+        return results;
+      }
+      if (!model_executor_impl::IsRowSpecificError(res.status())) {
+        for (int64_t i = 0; i < row_count; ++i) {
+          results.push_back(res.status());
+        }
+        return results;
+      }
+      // Find out which rows really fail, see ExecuteBatchImpl.
+    }
+    for (int64_t i = 0; i < row_count; ++i) {
+      results.push_back(Execute(eval_options, get_input(i)));
+    }
+    return results;
+  }
+
+  // Evaluates all the rows in a single pass of the lifted model.
+  template <typename GetInputFn>
+  absl::StatusOr<std::vector<Output>> ExecuteBatchLifted(
+      const EvaluationOptions& eval_options, int64_t row_count,
+      const GetInputFn& get_input) {
+    DCHECK(lifted_model_ != nullptr);
+    if (arena_ != nullptr) {
+      EvaluationContext ctx(WithBufferFactory(eval_options, arena_.get()));
+      absl::StatusOr<std::vector<Output>> res =
+          ExecuteBatchWithContext(ctx, row_count, get_input);
+      arena_->Reset();  // reusing arena memory
+      return res;
+    }
+    EvaluationContext ctx(eval_options);
+    return ExecuteBatchWithContext(ctx, row_count, get_input);
+  }
+
+  template <typename GetInputFn>
+  absl::StatusOr<std::vector<Output>> ExecuteBatchRowByRow(
+      const EvaluationOptions& eval_options, int64_t row_count,
+      const GetInputFn& get_input) {
+    std::vector<Output> outputs;
+    outputs.reserve(row_count);
+    for (int64_t i = 0; i < row_count; ++i) {
+      ASSIGN_OR_RETURN(Output output, Execute(eval_options, get_input(i)));
+      outputs.push_back(std::move(output));
+    }
+    return outputs;
+  }
+
+  template <typename GetInputFn>
+  absl::StatusOr<std::vector<Output>> ExecuteBatchWithContext(
+      EvaluationContext& ctx, int64_t row_count,
+      const GetInputFn& get_input) const {
+    // The number of scalar frames to load the inputs into before copying them
+    // to the arrays.
+    constexpr int64_t kMaxFrameCount = 64;
+    std::vector<Output> outputs;
+    outputs.reserve(row_count);
+    const int64_t frame_count = std::min<int64_t>(kMaxFrameCount, row_count);
+    std::vector<MemoryAllocation> allocs;
+    std::vector<FramePtr> frames;
+    allocs.reserve(frame_count);
+    frames.reserve(frame_count);
+    for (int64_t i = 0; i < frame_count; ++i) {
+      frames.push_back(allocs.emplace_back(&shared_data_->layout).frame());
+    }
+    auto load_fn = [&](int64_t offset,
+                       absl::Span<const FramePtr> batch) -> absl::Status {
+      for (size_t i = 0; i < batch.size(); ++i) {
+        RETURN_IF_ERROR(shared_data_->bound_loader(
+            get_input(offset + i), batch[i], &ctx.buffer_factory()));
+      }
+      return absl::OkStatus();
+    };
+    auto store_fn = [&](int64_t /*offset*/,
+                        absl::Span<const FramePtr> batch) -> absl::Status {
+      for (FramePtr frame : batch) {
+        absl::StatusOr<Output> output =
+            OutputTraits::ExtractOutput(shared_data_->output_slot, frame);
+        RETURN_IF_ERROR(output.status());
+        outputs.push_back(*std::move(output));
+      }
+      return absl::OkStatus();
+    };
+    RETURN_IF_ERROR(lifted_model_->Execute(
+        ctx, row_count, absl::MakeSpan(frames), load_fn, store_fn));
+    return outputs;
+  }
+
   template <bool kInitLiterals>
   absl::StatusOr<Output> ExecuteOnFrame(
       EvaluationContext& ctx, FramePtr frame, const Input& input,
@@ -448,17 +801,25 @@ class ModelExecutor {
       // EvaluationContext invalid.
       arena = std::make_unique<UnsafeArenaBufferFactory>(page_size);
     }
+    ASSIGN_OR_RETURN(MemoryAllocation alloc,
+                     AllocateFrameWithLiterals(*shared_data));
+    return ModelExecutor(std::move(shared_data), std::move(arena),
+                         std::move(alloc));
+  }
+
+  // Allocates a frame and initializes the literals of the evaluators in it.
+  static absl::StatusOr<MemoryAllocation> AllocateFrameWithLiterals(
+      const SharedData& shared_data) {
     EvaluationContext ctx;
-    MemoryAllocation alloc(&shared_data->layout);
-    shared_data->evaluator->InitializeLiterals(&ctx, alloc.frame());
+    MemoryAllocation alloc(&shared_data.layout);
+    shared_data.evaluator->InitializeLiterals(&ctx, alloc.frame());
     RETURN_IF_ERROR(ctx.status());
-    if (shared_data->evaluator_with_side_output != nullptr) {
-      shared_data->evaluator_with_side_output->InitializeLiterals(
+    if (shared_data.evaluator_with_side_output != nullptr) {
+      shared_data.evaluator_with_side_output->InitializeLiterals(
           &ctx, alloc.frame());
       RETURN_IF_ERROR(ctx.status());
     }
-    return ModelExecutor(std::move(shared_data), std::move(arena),
-                         std::move(alloc));
+    return alloc;
   }
 
   static absl::StatusOr<ModelExecutor> BindToSlots(
@@ -537,6 +898,17 @@ class ModelExecutor {
                    .output_slot = output_slot,
                    .bound_listener = std::move(bound_listener),
                    .arena_page_size = options.arena_page_size});
+    if (options.frame_pool_size != 0) {
+      std::vector<const BoundExpr*> evaluators = {
+          shared_data->evaluator.get()};
+      if (shared_data->evaluator_with_side_output != nullptr) {
+        evaluators.push_back(shared_data->evaluator_with_side_output.get());
+      }
+      ASSIGN_OR_RETURN(shared_data->frame_pool,
+                       model_executor_impl::FramePool::Create(
+                           options.frame_pool_size, shared_data->layout,
+                           evaluators));
+    }
 
     return Create(shared_data);
   }
@@ -545,6 +917,8 @@ class ModelExecutor {
   std::unique_ptr<UnsafeArenaBufferFactory> arena_;
   MemoryAllocation alloc_;
   RawBufferFactory* buffer_factory_ = nullptr;  // Not owned.
+  // Only set if the model was compiled with `enable_batch_lifting`.
+  std::shared_ptr<const model_executor_impl::LiftedModel> lifted_model_;
 };
 
 // Syntax helper to deduce input type from InputLoader.
@@ -17,6 +17,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -38,6 +39,7 @@
 #include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/expr/eval/compiled_expr_cache.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/side_output.h"
 #include "arolla/expr/expr.h"
@@ -47,6 +49,8 @@
 #include "arolla/io/accessors_input_loader.h"
 #include "arolla/io/input_loader.h"
 #include "arolla/io/slot_listener.h"
+#include "arolla/memory/arena_pool.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/memory/frame.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/memory/raw_buffer_factory.h"
@@ -60,6 +64,8 @@
 #include "arolla/qtype/typed_value.h"
 #include "arolla/qtype/unspecified_qtype.h"
 #include "arolla/util/bytes.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/threading.h"
 
 namespace arolla::expr {
 namespace {
@@ -76,6 +82,7 @@ using ::testing::AtLeast;
 using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
 using ::testing::IsFalse;
 using ::testing::IsTrue;
 
@@ -123,6 +130,271 @@ TEST(ModelExecutorTest, Move) {
   ASSERT_THAT(other_executor.IsValid(), IsFalse());
 }
 
+TEST(ModelExecutorTest, CompiledExprCache) {
+  ASSERT_OK_AND_ASSIGN(auto x_plus_y,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  SetCompiledExprCacheCapacity(10);
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        auto executor,
+        (ModelExecutor<TestInputs, int64_t>::Compile(
+            x_plus_y, *input_loader, /*slot_listener=*/nullptr,
+            {.use_compiled_expr_cache = true})));
+    EXPECT_THAT(executor.Execute(TestInputs{50, 7}), IsOkAndHolds(57));
+  }
+  EXPECT_EQ(GetCompiledExprCacheStats().hits, 1);
+  EXPECT_EQ(GetCompiledExprCacheStats().misses, 1);
+  SetCompiledExprCacheCapacity(0);
+}
+
+TEST(ModelExecutorTest, FramePool) {
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {CallOp("math.multiply", {Leaf("x"), Literal(int64_t{10})}),
+              Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (ModelExecutor<TestInputs, int64_t>::Compile(
+                           expr, *input_loader, /*slot_listener=*/nullptr,
+                           {.frame_pool_size = 2})));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{i, 7}),
+                IsOkAndHolds(10 * i + 7));
+  }
+  // Clones share the pool.
+  ASSERT_OK_AND_ASSIGN(auto clone, executor.Clone());
+  EXPECT_THAT(clone.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(57));
+  EXPECT_THAT(executor.Execute(TestInputs{5, 8}), IsOkAndHolds(58));
+}
+
+TEST(ModelExecutorTest, FramePoolReleasesInputs) {
+  auto values = std::make_shared<std::vector<int64_t>>(
+      std::vector<int64_t>{1, 2, 3});
+  DenseArray<int64_t> input{Buffer<int64_t>(values, *values)};
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.add",
+             {Leaf("x"), Literal(CreateDenseArray<int64_t>({10, 20, 30}))}));
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<DenseArray<int64_t>>(
+          "x", [](const DenseArray<int64_t>& x) { return x; }));
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (ModelExecutor<DenseArray<int64_t>, DenseArray<int64_t>>::Compile(
+          expr, *input_loader, /*slot_listener=*/nullptr,
+          {.frame_pool_size = 1})));
+  const int64_t use_count = values.use_count();
+  for (int i = 0; i < 2; ++i) {
+    // The second call reuses the pooled frame with the literal.
+    ASSERT_OK_AND_ASSIGN(DenseArray<int64_t> result,
+                         executor.ExecuteOnHeap({}, input));
+    EXPECT_THAT(result, ElementsAre(11, 22, 33));
+    // The pooled frame doesn't refer to the input anymore.
+    EXPECT_EQ(values.use_count(), use_count);
+  }
+}
+
+TEST(ModelExecutorTest, ExecuteBatch) {
+  ASSERT_OK_AND_ASSIGN(auto x_plus_y,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  // More rows than the frame buffer used by ExecuteBatch.
+  std::vector<TestInputs> inputs;
+  for (int64_t i = 0; i < 150; ++i) {
+    inputs.push_back({.x = i, .y = 2 * i});
+  }
+  for (bool enable_batch_lifting : {false, true}) {
+    ModelExecutorOptions options;
+    options.enable_batch_lifting = enable_batch_lifting;
+    ASSERT_OK_AND_ASSIGN(
+        auto executor,
+        (ModelExecutor<TestInputs, int64_t>::Compile(
+            x_plus_y, *input_loader, /*slot_listener=*/nullptr, options)));
+    EXPECT_EQ(executor.IsBatchLifted(), enable_batch_lifting);
+    ASSERT_OK_AND_ASSIGN(std::vector<int64_t> outputs,
+                         executor.ExecuteBatch(inputs));
+    ASSERT_EQ(outputs.size(), inputs.size());
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      EXPECT_EQ(outputs[i], 3 * inputs[i].x);
+    }
+    EXPECT_THAT(executor.ExecuteBatch({}), IsOkAndHolds(IsEmpty()));
+
+    ASSERT_OK_AND_ASSIGN(auto clone, executor.Clone());
+    EXPECT_EQ(clone.IsBatchLifted(), enable_batch_lifting);
+    EXPECT_THAT(clone.ExecuteBatch(absl::MakeSpan(inputs).subspan(1, 2)),
+                IsOkAndHolds(ElementsAre(3, 6)));
+    std::vector<const TestInputs*> input_ptrs = {&inputs[2], &inputs[1]};
+    EXPECT_THAT(clone.ExecuteBatch({}, input_ptrs),
+                IsOkAndHolds(ElementsAre(6, 3)));
+  }
+}
+
+TEST(ModelExecutorTest, ExecuteBatchOptional) {
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<TestInputs>(
+          "x", [](const TestInputs& in) { return in.x; },  //
+          "z",
+          [](const TestInputs& in) {
+            return OptionalValue<int64_t>(in.optional_z);
+          }));
+  ASSERT_OK_AND_ASSIGN(auto x_mul_z,
+                       CallOp("math.multiply", {Leaf("x"), Leaf("z")}));
+  std::vector<TestInputs> inputs = {{.x = 1, .optional_z = 2},
+                                    {.x = 3, .optional_z = std::nullopt},
+                                    {.x = 5, .optional_z = 6}};
+
+  ModelExecutorOptions options;
+  options.enable_batch_lifting = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CompileModelExecutor<std::optional<int64_t>>(x_mul_z, *input_loader,
+                                                   options));
+  EXPECT_TRUE(executor.IsBatchLifted());
+  EXPECT_THAT(executor.ExecuteBatch(inputs),
+              IsOkAndHolds(ElementsAre(2, std::nullopt, 30)));
+
+  // The missing values must be reported, so the model is not lifted.
+  options.force_non_optional_output = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto non_optional_executor,
+      CompileModelExecutor<int64_t>(x_mul_z, *input_loader, options));
+  EXPECT_FALSE(non_optional_executor.IsBatchLifted());
+  EXPECT_THAT(non_optional_executor.ExecuteBatch(inputs),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       "expects a present value, got missing"));
+  EXPECT_THAT(non_optional_executor.ExecuteBatch(
+                  absl::MakeSpan(inputs).subspan(2, 1)),
+              IsOkAndHolds(ElementsAre(30)));
+}
+
+TEST(ModelExecutorTest, ExecuteBatchFallsBackToRows) {
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  // The scalar model skips the division if y == 0, but the lifted model
+  // divides all the rows.
+  ASSERT_OK_AND_ASSIGN(
+      auto safe_x_div_y,
+      CallOp("core.where",
+             {CallOp("core.not_equal", {Leaf("y"), Literal(int64_t{0})}),
+              CallOp("math.floordiv", {Leaf("x"), Leaf("y")}),
+              Literal(int64_t{-1})}));
+  ModelExecutorOptions options;
+  options.enable_batch_lifting = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CompileModelExecutor<int64_t>(safe_x_div_y, *input_loader, options));
+  EXPECT_TRUE(executor.IsBatchLifted());
+  EXPECT_THAT(executor.ExecuteBatch({TestInputs{6, 3}, TestInputs{5, 0},
+                                     TestInputs{8, 2}}),
+              IsOkAndHolds(ElementsAre(2, -1, 4)));
+
+  // An error in a single row is still reported.
+  ASSERT_OK_AND_ASSIGN(auto x_div_y,
+                       CallOp("math.floordiv", {Leaf("x"), Leaf("y")}));
+  ASSERT_OK_AND_ASSIGN(
+      auto failing_executor,
+      CompileModelExecutor<int64_t>(x_div_y, *input_loader, options));
+  EXPECT_TRUE(failing_executor.IsBatchLifted());
+  EXPECT_THAT(failing_executor.ExecuteBatch(
+                  {TestInputs{6, 3}, TestInputs{5, 0}, TestInputs{8, 2}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("division by zero")));
+}
+
+TEST(ModelExecutorTest, ExecuteBatchPerRow) {
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  ASSERT_OK_AND_ASSIGN(auto x_div_y,
+                       CallOp("math.floordiv", {Leaf("x"), Leaf("y")}));
+  std::vector<TestInputs> inputs = {{6, 3}, {5, 0}, {8, 2}};
+  for (bool enable_batch_lifting : {false, true}) {
+    ModelExecutorOptions options;
+    options.enable_batch_lifting = enable_batch_lifting;
+    ASSERT_OK_AND_ASSIGN(
+        auto executor,
+        CompileModelExecutor<int64_t>(x_div_y, *input_loader, options));
+    EXPECT_EQ(executor.IsBatchLifted(), enable_batch_lifting);
+    EXPECT_THAT(
+        executor.ExecuteBatchPerRow({}, inputs),
+        ElementsAre(IsOkAndHolds(2),
+                    StatusIs(absl::StatusCode::kInvalidArgument,
+                             HasSubstr("division by zero")),
+                    IsOkAndHolds(4)));
+    std::vector<const TestInputs*> input_ptrs = {&inputs[2], &inputs[0]};
+    EXPECT_THAT(executor.ExecuteBatchPerRow({}, input_ptrs),
+                ElementsAre(IsOkAndHolds(4), IsOkAndHolds(2)));
+    EXPECT_THAT(
+        executor.ExecuteBatchPerRow({}, absl::Span<const TestInputs>()),
+        IsEmpty());
+  }
+}
+
+TEST(ModelExecutorTest, ExecuteBatchDoesNotRetryBatchErrors) {
+  int64_t load_count = 0;
+  absl::Status batch_error;
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<TestInputs>(
+          "x",
+          [&](const TestInputs& in) {
+            ++load_count;
+            if (in.x < 0) {
+              CancellationContext::ScopeGuard::current_cancellation_context()
+                  ->Cancel(batch_error);
+            }
+            return in.x;
+          },
+          "y", [](const TestInputs& in) { return in.y; }));
+  ASSERT_OK_AND_ASSIGN(auto x_plus_y,
+                       CallOp("math.add", {Leaf("x"), Leaf("y")}));
+  ModelExecutorOptions options;
+  options.enable_batch_lifting = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CompileModelExecutor<int64_t>(x_plus_y, *input_loader, options));
+  ASSERT_TRUE(executor.IsBatchLifted());
+  for (absl::Status status : {absl::CancelledError("cancelled"),
+                              absl::DeadlineExceededError("too late"),
+                              absl::ResourceExhaustedError("out of memory")}) {
+    CancellationContext::ScopeGuard cancellation_scope;
+    batch_error = status;
+    load_count = 0;
+    EXPECT_THAT(executor.ExecuteBatch({TestInputs{1, 2}, TestInputs{-1, 4},
+                                       TestInputs{5, 6}}),
+                StatusIs(status.code(), status.message()));
+    // Only the lifted pass loaded the inputs, the rows were not reevaluated.
+    EXPECT_EQ(load_count, 3);
+  }
+  for (absl::Status status : {absl::CancelledError("cancelled"),
+                              absl::ResourceExhaustedError("out of memory")}) {
+    CancellationContext::ScopeGuard cancellation_scope;
+    batch_error = status;
+    load_count = 0;
+    EXPECT_THAT(executor.ExecuteBatchPerRow(
+                    {}, {TestInputs{1, 2}, TestInputs{-1, 4}}),
+                ElementsAre(StatusIs(status.code(), status.message()),
+                            StatusIs(status.code(), status.message())));
+    EXPECT_EQ(load_count, 2);
+  }
+}
+
+TEST(ModelExecutorTest, ExecuteBatchNotLiftable) {
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputLoader());
+  // The output doesn't depend on the inputs, so the lifted model would return
+  // a scalar.
+  ModelExecutorOptions options;
+  options.enable_batch_lifting = true;
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      CompileModelExecutor<int64_t>(Literal(int64_t{57}), *input_loader,
+                                    options));
+  EXPECT_FALSE(executor.IsBatchLifted());
+  EXPECT_THAT(executor.ExecuteBatch({TestInputs{1, 2}, TestInputs{3, 4}}),
+              IsOkAndHolds(ElementsAre(57, 57)));
+}
+
 TEST(ModelExecutorTest, MissingInputs) {
   ASSERT_OK_AND_ASSIGN(auto x_plus_y, CallOp("math.add", {Leaf("unknown_x"),
                                                           Leaf("unknown_y")}));
@@ -358,6 +630,62 @@ TEST(ModelExecutorTest, ExternalBufferFactory) {
   EXPECT_TRUE(res.is_owned());
 }
 
+// Counts the threads started by the evaluation.
+class CountingThreading final : public ThreadingInterface {
+ public:
+  int GetRecommendedThreadCount() const final { return 2; }
+
+  JoinFn StartThread(TaskFn fn) final {
+    started_threads_.fetch_add(1);
+    return threading_.StartThread(std::move(fn));
+  }
+
+  int started_threads() const { return started_threads_.load(); }
+
+ private:
+  StdThreading threading_{2};
+  std::atomic<int> started_threads_ = 0;
+};
+
+TEST(ModelExecutorTest, EvaluationOptionsThreading) {
+  // Big enough for DenseGroupOps to split the parent rows between threads.
+  constexpr int64_t kGroupSize = 1 << 17;
+  ASSERT_OK_AND_ASSIGN(
+      auto expr,
+      CallOp("math.sum",
+             {Leaf("x"),
+              CallOp("edge.from_sizes",
+                     {Literal(CreateDenseArray<int64_t>(
+                         {kGroupSize, kGroupSize}))})}));
+  ASSERT_OK_AND_ASSIGN(
+      auto input_loader,
+      CreateAccessorsInputLoader<DenseArray<int64_t>>(
+          "x", [](const DenseArray<int64_t>& x) { return x; }));
+  DenseArray<int64_t> input =
+      CreateConstDenseArray<int64_t>(2 * kGroupSize, 1);
+  for (int64_t arena_page_size : {0, 64 << 10}) {
+    ModelExecutorOptions options;
+    options.arena_page_size = arena_page_size;
+    ASSERT_OK_AND_ASSIGN(
+        auto executor,
+        (ModelExecutor<DenseArray<int64_t>, DenseArray<int64_t>>::Compile(
+            expr, *input_loader, /*slot_listener=*/nullptr, options)));
+    CountingThreading threading;
+    int started_threads = 0;
+    EXPECT_THAT(executor.Execute({.threading = &threading}, input),
+                IsOkAndHolds(ElementsAre(kGroupSize, kGroupSize)));
+    EXPECT_GT(threading.started_threads(), started_threads);
+    started_threads = threading.started_threads();
+    EXPECT_THAT(executor.ExecuteOnHeap({.threading = &threading}, input),
+                IsOkAndHolds(ElementsAre(kGroupSize, kGroupSize)));
+    EXPECT_GT(threading.started_threads(), started_threads);
+    started_threads = threading.started_threads();
+    EXPECT_THAT(executor.Execute(input),
+                IsOkAndHolds(ElementsAre(kGroupSize, kGroupSize)));
+    EXPECT_EQ(threading.started_threads(), started_threads);
+  }
+}
+
 TEST(ModelExecutorTest, ReturnsNonOptional) {
   ASSERT_OK_AND_ASSIGN(
       auto input_loader,
@@ -940,6 +1268,17 @@ TEST(ModelExecutorTest, ArenaPropagated) {
     EXPECT_EQ(kLastLoaderUsedFactory, prev_used_loader_factory);
     EXPECT_EQ(kLastLoaderAllocatedBuffer, prev_allocated_loader_buffer);
   }
+
+  // ExecuteOnHeap borrows the arena from the thread-local pool, so the memory
+  // is reused between the calls as well.
+  ArenaPoolStatistics arena_pool_stats = GetArenaPoolStatistics();
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(5));
+  prev_used_op_factory = kLastOpUsedFactory;
+  prev_allocated_op_buffer = kLastOpAllocatedBuffer;
+  EXPECT_THAT(executor.ExecuteOnHeap({}, TestInputs{5, 7}), IsOkAndHolds(5));
+  EXPECT_EQ(kLastOpUsedFactory, prev_used_op_factory);
+  EXPECT_EQ(kLastOpAllocatedBuffer, prev_allocated_op_buffer);
+  EXPECT_GE(GetArenaPoolStatistics().reuses - arena_pool_stats.reuses, 1);
 }
 
 }  // namespace
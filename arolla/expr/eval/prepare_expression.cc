@@ -405,6 +405,12 @@ absl::StatusOr<ExprNodePtr> PrepareExpression(
                    ApplyNodeTransformations(options, std::move(current_expr),
                                             transformations, stack_trace));
 
+  if (options.enabled_preparation_stages & Stage::kOptimization &&
+      options.global_optimizer.has_value()) {
+    ASSIGN_OR_RETURN(current_expr,
+                     (*options.global_optimizer)(std::move(current_expr)));
+  }
+
   if (options.enabled_preparation_stages &
       Stage::kWhereOperatorsTransformation) {
     ASSIGN_OR_RETURN(current_expr,
@@ -15,13 +15,17 @@
 #ifndef AROLLA_EXPR_EVAL_THREAD_SAFE_MODEL_EXECUTOR_H_
 #define AROLLA_EXPR_EVAL_THREAD_SAFE_MODEL_EXECUTOR_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/log/check.h"
 #include "arolla/util/status_macros_backport.h"
@@ -280,6 +284,232 @@ class ThreadSafePoolModelExecutor {
   std::shared_ptr<SharedData> shared_data_;
 };
 
+// Statistics of ThreadSafeShardedPoolModelExecutor.
+struct ModelExecutorPoolStatistics {
+  // Executions that reused an executor from the shard of the current thread.
+  int64_t hits = 0;
+  // Executions that reused an executor from another shard.
+  int64_t steals = 0;
+  // Executions that had to clone the prototype executor.
+  int64_t clones = 0;
+  // Executors destroyed because they stayed idle or the shard was full.
+  int64_t trimmed = 0;
+};
+
+// Options of ThreadSafeShardedPoolModelExecutor.
+struct ShardedPoolModelExecutorOptions {
+  // Number of shards. Zero means std::thread::hardware_concurrency().
+  size_t shard_count = 0;
+  // Number of executions of a shard after which its idle executors are
+  // destroyed.
+  int64_t trim_period = 4096;
+};
+
+namespace thread_safe_model_executor_impl {
+
+// Returns a small number that is unique for the current thread. Threads get
+// consecutive numbers in the order of the first call, so they are spread
+// evenly over the pool shards.
+inline size_t CurrentThreadIndex() {
+  static std::atomic<size_t> next_index = 0;
+  thread_local const size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+}  // namespace thread_safe_model_executor_impl
+
+// An object-pool based wrapper around ModelExecutor that is thread safe and
+// scales to a large number of threads.
+//
+// Unlike ThreadSafePoolModelExecutor, the pool is split into shards with a few
+// lock-free slots each. A thread takes executors from its own shard and steals
+// from the other shards only if its shard is empty. Executors that were not
+// used during `trim_period` executions of their shard are destroyed, so the
+// pool shrinks back after a spike of concurrent executions.
+//
+// DO NOT USE directly, prefer ExprCompiler instead.
+//
+template <typename Input, typename Output, typename SideOutput = void>
+class ThreadSafeShardedPoolModelExecutor {
+  using WrappedModelExecutor = ModelExecutor<Input, Output, SideOutput>;
+
+ public:
+  // Number of executors that a shard can hold.
+  static constexpr size_t kSlotsPerShard = 8;
+
+  explicit ThreadSafeShardedPoolModelExecutor(
+      WrappedModelExecutor&& prototype_executor,
+      ShardedPoolModelExecutorOptions options = {})
+      : shared_data_(std::make_shared<SharedData>(
+            std::move(prototype_executor), options)) {}
+
+  absl::StatusOr<Output> operator()(const EvaluationOptions& eval_options,
+                                    const Input& input,
+                                    SideOutput* side_output) const {
+    return Execute(eval_options, input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const EvaluationOptions& eval_options,
+                                    const Input& input) const {
+    return Execute(eval_options, input);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input,
+                                    SideOutput* side_output) const {
+    return Execute({}, input, side_output);
+  }
+
+  absl::StatusOr<Output> operator()(const Input& input) const {
+    return Execute({}, input);
+  }
+
+  bool IsValid() const {
+    return shared_data_ != nullptr &&
+           shared_data_->prototype_executor.IsValid();
+  }
+
+  // Returns the statistics accumulated since the construction. The counters
+  // are read without synchronization with the running executions.
+  ModelExecutorPoolStatistics GetStatistics() const {
+    DCHECK(IsValid());
+    ModelExecutorPoolStatistics result;
+    for (const Shard& shard : shared_data_->shards) {
+      result.hits += shard.hits.load(std::memory_order_relaxed);
+      result.steals += shard.steals.load(std::memory_order_relaxed);
+      result.clones += shard.clones.load(std::memory_order_relaxed);
+      result.trimmed += shard.trimmed.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+ private:
+  struct PooledExecutor {
+    explicit PooledExecutor(WrappedModelExecutor executor)
+        : executor(std::move(executor)) {}
+
+    WrappedModelExecutor executor;
+    // Value of Shard::executions when the executor was returned to the pool.
+    int64_t last_used = 0;
+  };
+
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    ~Shard() {
+      for (auto& slot : slots) {
+        delete slot.load(std::memory_order_relaxed);
+      }
+    }
+
+    // Takes an executor from the shard, or returns nullptr if it is empty.
+    std::unique_ptr<PooledExecutor> Pop() {
+      for (auto& slot : slots) {
+        if (slot.load(std::memory_order_relaxed) != nullptr) {
+          if (PooledExecutor* executor =
+                  slot.exchange(nullptr, std::memory_order_acquire)) {
+            return std::unique_ptr<PooledExecutor>(executor);
+          }
+        }
+      }
+      return nullptr;
+    }
+
+    // Puts the executor into a free slot. Returns false (and keeps the
+    // ownership to the caller) if the shard is full.
+    bool Push(std::unique_ptr<PooledExecutor>& executor) {
+      for (auto& slot : slots) {
+        PooledExecutor* expected = nullptr;
+        if (slot.load(std::memory_order_relaxed) == nullptr &&
+            slot.compare_exchange_strong(expected, executor.get(),
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+          executor.release();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Destroys executors that were returned to the pool before `min_last_used`.
+    void Trim(int64_t min_last_used) {
+      int64_t trimmed_count = 0;
+      for (auto& slot : slots) {
+        std::unique_ptr<PooledExecutor> executor(
+            slot.exchange(nullptr, std::memory_order_acquire));
+        if (executor != nullptr &&
+            (executor->last_used < min_last_used || !Push(executor))) {
+          ++trimmed_count;
+        }
+      }
+      trimmed.fetch_add(trimmed_count, std::memory_order_relaxed);
+    }
+
+    std::atomic<PooledExecutor*> slots[kSlotsPerShard] = {};
+    std::atomic<int64_t> executions = 0;
+    std::atomic<int64_t> hits = 0;
+    std::atomic<int64_t> steals = 0;
+    std::atomic<int64_t> clones = 0;
+    std::atomic<int64_t> trimmed = 0;
+  };
+
+  absl::StatusOr<Output> Execute(const EvaluationOptions& eval_options,
+                                 const Input& input,
+                                 SideOutput* side_output = nullptr) const {
+    DCHECK(IsValid());
+    SharedData& data = *shared_data_;
+    const size_t shard_count = data.shards.size();
+    const size_t shard_id =
+        thread_safe_model_executor_impl::CurrentThreadIndex() % shard_count;
+    Shard& shard = data.shards[shard_id];
+
+    std::unique_ptr<PooledExecutor> local_executor = shard.Pop();
+    if (local_executor != nullptr) {
+      shard.hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      for (size_t i = 1; i < shard_count && local_executor == nullptr; ++i) {
+        local_executor = data.shards[(shard_id + i) % shard_count].Pop();
+      }
+      if (local_executor != nullptr) {
+        shard.steals.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        ASSIGN_OR_RETURN(auto new_executor, data.prototype_executor.Clone());
+        local_executor =
+            std::make_unique<PooledExecutor>(std::move(new_executor));
+        shard.clones.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    auto result =
+        local_executor->executor.Execute(eval_options, input, side_output);
+
+    const int64_t executions =
+        shard.executions.fetch_add(1, std::memory_order_relaxed) + 1;
+    local_executor->last_used = executions;
+    if (!shard.Push(local_executor)) {
+      shard.trimmed.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (executions % data.trim_period == 0) {
+      shard.Trim(executions - data.trim_period);
+    }
+    return result;
+  }
+
+  struct SharedData {
+    SharedData(WrappedModelExecutor prototype_executor,
+               ShardedPoolModelExecutorOptions options)
+        : prototype_executor(std::move(prototype_executor)),
+          trim_period(std::max<int64_t>(options.trim_period, 1)),
+          shards(std::max<size_t>(options.shard_count != 0
+                                      ? options.shard_count
+                                      : std::thread::hardware_concurrency(),
+                                  1)) {}
+
+    WrappedModelExecutor prototype_executor;
+    int64_t trim_period;
+    std::vector<Shard> shards;
+  };
+
+  std::shared_ptr<SharedData> shared_data_;
+};
+
 // A wrapper around ModelExecutor that is thread-unsafe, but copyable. The
 // original ModelExecutor is not copyable because it may be expensive, and can
 // also return an error. But in case we want to wrap ModelExecutor into a
@@ -361,6 +591,15 @@ template <typename I, typename O, typename S>
 ThreadSafePoolModelExecutor(ModelExecutor<I, O, S>&&, size_t)
     -> ThreadSafePoolModelExecutor<I, O, S>;
 
+template <typename I, typename O, typename S>
+ThreadSafeShardedPoolModelExecutor(ModelExecutor<I, O, S>&&)
+    -> ThreadSafeShardedPoolModelExecutor<I, O, S>;
+
+template <typename I, typename O, typename S>
+ThreadSafeShardedPoolModelExecutor(ModelExecutor<I, O, S>&&,
+                                   ShardedPoolModelExecutorOptions)
+    -> ThreadSafeShardedPoolModelExecutor<I, O, S>;
+
 template <typename I, typename O, typename S>
 CopyableThreadUnsafeModelExecutor(ModelExecutor<I, O, S>&&)
     -> CopyableThreadUnsafeModelExecutor<I, O, S>;
@@ -474,6 +474,94 @@ TEST(ThreadSafePoolModelExecutorTest, ExecuteManyOnDenseArraysWithArena) {
               UnorderedElementsAreArray(Iota(kNumThreads * kNumIterations)));
 }
 
+TEST(ThreadSafeShardedPoolModelExecutorTest, Move) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+
+  ThreadSafeShardedPoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+  ASSERT_THAT(thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  ThreadSafeShardedPoolModelExecutor<TestInput, int64_t>
+      other_thread_safe_executor(std::move(thread_safe_executor));
+  ASSERT_THAT(other_thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(other_thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  // NOLINTNEXTLINE(bugprone-use-after-move)
+  EXPECT_THAT(thread_safe_executor.IsValid(), IsFalse());
+}
+
+TEST(ThreadSafeShardedPoolModelExecutorTest, Copy) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+
+  ThreadSafeShardedPoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor));
+  EXPECT_THAT(thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  ThreadSafeShardedPoolModelExecutor<TestInput, int64_t>
+      other_thread_safe_executor(thread_safe_executor);
+  ASSERT_THAT(other_thread_safe_executor.IsValid(), IsTrue());
+  EXPECT_THAT(other_thread_safe_executor(TestInput{57}), IsOkAndHolds(57));
+  EXPECT_THAT(thread_safe_executor.IsValid(), IsTrue());
+  // The copies share the pool.
+  EXPECT_EQ(thread_safe_executor.GetStatistics().hits, 1);
+}
+
+TEST(ThreadSafeShardedPoolModelExecutorTest, ExecuteMany) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateDenseArrayTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(
+      auto executor,
+      (CompileModelExecutor<DenseArray<int64_t>>(ast, *input_loader)));
+
+  ThreadSafeShardedPoolModelExecutor<TestInput, DenseArray<int64_t>>
+      thread_safe_executor(std::move(executor), {.shard_count = 3});
+  absl::flat_hash_set<int64_t> seen_results;
+  for (auto& result_or : RunMany(thread_safe_executor,
+                                 /*copy_for_each_thread=*/std::false_type{})) {
+    ASSERT_OK_AND_ASSIGN(auto result, result_or);
+    seen_results.insert(result[0].value);
+  }
+  EXPECT_THAT(seen_results,
+              UnorderedElementsAreArray(Iota(kNumThreads * kNumIterations)));
+  ModelExecutorPoolStatistics stats = thread_safe_executor.GetStatistics();
+  EXPECT_EQ(stats.hits + stats.steals + stats.clones,
+            kNumThreads * kNumIterations);
+  EXPECT_GE(stats.clones, 1);
+}
+
+TEST(ThreadSafeShardedPoolModelExecutorTest, Statistics) {
+  auto ast = Leaf("x");
+  ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
+  ASSERT_OK_AND_ASSIGN(auto executor,
+                       (CompileModelExecutor<int64_t>(ast, *input_loader)));
+
+  constexpr int64_t kTrimPeriod = 16;
+  ThreadSafeShardedPoolModelExecutor<TestInput, int64_t> thread_safe_executor(
+      std::move(executor), {.shard_count = 1, .trim_period = kTrimPeriod});
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_THAT(thread_safe_executor(TestInput{i}), IsOkAndHolds(i));
+  }
+  ModelExecutorPoolStatistics stats = thread_safe_executor.GetStatistics();
+  EXPECT_EQ(stats.hits, 9);
+  EXPECT_EQ(stats.steals, 0);
+  EXPECT_EQ(stats.clones, 1);
+  EXPECT_EQ(stats.trimmed, 0);
+
+  // Concurrent executions clone more executors.
+  RunMany(thread_safe_executor, /*copy_for_each_thread=*/std::false_type{});
+  // After two trim periods of sequential executions all the executors except
+  // the one in use are destroyed.
+  for (int i = 0; i < 2 * kTrimPeriod + 1; ++i) {
+    EXPECT_THAT(thread_safe_executor(TestInput{i}), IsOkAndHolds(i));
+  }
+  stats = thread_safe_executor.GetStatistics();
+  EXPECT_EQ(stats.trimmed, stats.clones - 1);
+}
+
 TEST(CopyableThreadUnsafeModelExecutorTest, Move) {
   auto ast = Leaf("x");
   ASSERT_OK_AND_ASSIGN(auto input_loader, CreateTestInputsLoader());
@@ -0,0 +1,215 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/memory/arena_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+namespace {
+
+std::atomic<int64_t> max_retained_bytes_per_thread =
+    ArenaPoolOptions().max_retained_bytes_per_thread;
+std::atomic<int64_t> max_idle_time_ns =
+    absl::ToInt64Nanoseconds(ArenaPoolOptions().max_idle_time);
+
+std::atomic<int64_t> retained_bytes = 0;
+std::atomic<int64_t> retained_bytes_high_water_mark = 0;
+
+void AddRetainedBytes(int64_t delta) {
+  if (delta == 0) {
+    return;
+  }
+  const int64_t value =
+      retained_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+  int64_t high_water_mark =
+      retained_bytes_high_water_mark.load(std::memory_order_relaxed);
+  while (value > high_water_mark &&
+         !retained_bytes_high_water_mark.compare_exchange_weak(
+             high_water_mark, value, std::memory_order_relaxed)) {
+  }
+}
+
+class ThreadArenaPool;
+
+struct Registry {
+  absl::Mutex mutex;
+  absl::flat_hash_set<const ThreadArenaPool*> pools ABSL_GUARDED_BY(mutex);
+  // Counters of the pools of the finished threads.
+  ArenaPoolStatistics retired ABSL_GUARDED_BY(mutex);
+};
+
+Registry& GetRegistry() {
+  static absl::NoDestructor<Registry> registry;
+  return *registry;
+}
+
+class ThreadArenaPool {
+ public:
+  ThreadArenaPool() {
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(registry.mutex);
+    registry.pools.insert(this);
+  }
+
+  ~ThreadArenaPool() {
+    AddRetainedBytes(-idle_bytes_);
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(registry.mutex);
+    registry.pools.erase(this);
+    AddCountersTo(registry.retired);
+  }
+
+  ThreadArenaPool(const ThreadArenaPool&) = delete;
+  ThreadArenaPool& operator=(const ThreadArenaPool&) = delete;
+
+  // Returns an arena and its reserved_bytes() included in the statistics.
+  std::pair<std::unique_ptr<UnsafeArenaBufferFactory>, int64_t> Acquire(
+      int64_t page_size) {
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    // Prefer the most recently returned arena, its pages are likely cached.
+    for (auto it = idle_arenas_.rbegin(); it != idle_arenas_.rend(); ++it) {
+      if (it->arena->page_size() == page_size) {
+        reuses_.fetch_add(1, std::memory_order_relaxed);
+        std::unique_ptr<UnsafeArenaBufferFactory> arena = std::move(it->arena);
+        const int64_t accounted_bytes = it->accounted_bytes;
+        idle_bytes_ -= accounted_bytes;
+        idle_arenas_.erase(std::next(it).base());
+        return {std::move(arena), accounted_bytes};
+      }
+    }
+    return {std::make_unique<UnsafeArenaBufferFactory>(page_size), 0};
+  }
+
+  void Release(std::unique_ptr<UnsafeArenaBufferFactory> arena,
+               int64_t accounted_bytes) {
+    arena->Reset();
+    const int64_t bytes = arena->reserved_bytes();
+    AddRetainedBytes(bytes - accounted_bytes);
+    const absl::Time now = absl::Now();
+    idle_arenas_.push_back({std::move(arena), bytes, now});
+    idle_bytes_ += bytes;
+    Trim(now);
+  }
+
+  void AddCountersTo(ArenaPoolStatistics& stats) const {
+    stats.acquisitions += acquisitions_.load(std::memory_order_relaxed);
+    stats.reuses += reuses_.load(std::memory_order_relaxed);
+    stats.trimmed += trimmed_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    std::unique_ptr<UnsafeArenaBufferFactory> arena;
+    int64_t accounted_bytes;
+    // Time when the arena was returned to the pool.
+    absl::Time last_release;
+  };
+
+  // Destroys the arenas that exceed the limits of ArenaPoolOptions. The
+  // entries are sorted by last_release, so the least recently returned arenas
+  // are at the front.
+  void Trim(absl::Time now) {
+    const int64_t max_bytes =
+        max_retained_bytes_per_thread.load(std::memory_order_relaxed);
+    const absl::Time min_last_release =
+        now -
+        absl::Nanoseconds(max_idle_time_ns.load(std::memory_order_relaxed));
+    const int64_t old_idle_bytes = idle_bytes_;
+    auto it = idle_arenas_.begin();
+    while (it != idle_arenas_.end() &&
+           (idle_bytes_ > max_bytes || max_bytes <= 0 ||
+            it->last_release < min_last_release)) {
+      idle_bytes_ -= it->accounted_bytes;
+      ++it;
+    }
+    if (it != idle_arenas_.begin()) {
+      trimmed_.fetch_add(it - idle_arenas_.begin(), std::memory_order_relaxed);
+      idle_arenas_.erase(idle_arenas_.begin(), it);
+      AddRetainedBytes(idle_bytes_ - old_idle_bytes);
+    }
+  }
+
+  std::vector<Entry> idle_arenas_;
+  // Sum of accounted_bytes of idle_arenas_.
+  int64_t idle_bytes_ = 0;
+  // Modified only by the owning thread, atomic to be read by
+  // GetArenaPoolStatistics.
+  std::atomic<int64_t> acquisitions_ = 0;
+  std::atomic<int64_t> reuses_ = 0;
+  std::atomic<int64_t> trimmed_ = 0;
+};
+
+ThreadArenaPool& GetThreadArenaPool() {
+  thread_local ThreadArenaPool pool;
+  return pool;
+}
+
+}  // namespace
+
+PooledArena::PooledArena(int64_t page_size) {
+  std::tie(arena_, accounted_bytes_) = GetThreadArenaPool().Acquire(page_size);
+}
+
+PooledArena::~PooledArena() {
+  GetThreadArenaPool().Release(std::move(arena_), accounted_bytes_);
+}
+
+void SetArenaPoolOptions(const ArenaPoolOptions& options) {
+  max_retained_bytes_per_thread.store(options.max_retained_bytes_per_thread,
+                                      std::memory_order_relaxed);
+  max_idle_time_ns.store(absl::ToInt64Nanoseconds(options.max_idle_time),
+                         std::memory_order_relaxed);
+}
+
+ArenaPoolOptions GetArenaPoolOptions() {
+  return {
+      .max_retained_bytes_per_thread =
+          max_retained_bytes_per_thread.load(std::memory_order_relaxed),
+      .max_idle_time = absl::Nanoseconds(
+          max_idle_time_ns.load(std::memory_order_relaxed)),
+  };
+}
+
+ArenaPoolStatistics GetArenaPoolStatistics() {
+  ArenaPoolStatistics result;
+  {
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(registry.mutex);
+    result = registry.retired;
+    for (const ThreadArenaPool* pool : registry.pools) {
+      pool->AddCountersTo(result);
+    }
+  }
+  result.retained_bytes = retained_bytes.load(std::memory_order_relaxed);
+  result.retained_bytes_high_water_mark =
+      retained_bytes_high_water_mark.load(std::memory_order_relaxed);
+  return result;
+}
+
+}  // namespace arolla
@@ -0,0 +1,97 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_MEMORY_ARENA_POOL_H_
+#define AROLLA_MEMORY_ARENA_POOL_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/time/time.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+
+// An UnsafeArenaBufferFactory borrowed from a process-wide pool for the
+// lifetime of the object. Useful for evaluations that need a fresh arena on
+// every call, e.g. ModelExecutor::ExecuteOnHeap.
+//
+// Every thread has its own pool, so no synchronization is needed. An arena is
+// reused only for the same page size, and a pool keeps several arenas per page
+// size to support nested evaluations. When an arena is returned, the pool of
+// the thread destroys (returning their pages to the heap):
+//   * idle arenas returned more than ArenaPoolOptions::max_idle_time ago,
+//   * the least recently returned arenas while the pages of the idle arenas
+//     exceed ArenaPoolOptions::max_retained_bytes_per_thread.
+// So a thread that stops using the pool keeps at most
+// max_retained_bytes_per_thread until it exits.
+//
+// The object must be destroyed on the thread that created it.
+class PooledArena {
+ public:
+  // Takes an arena with the given page size from the pool of the current
+  // thread, or creates a new one.
+  explicit PooledArena(int64_t page_size);
+
+  // Resets the arena and returns it to the pool of the current thread.
+  ~PooledArena();
+
+  PooledArena(const PooledArena&) = delete;
+  PooledArena& operator=(const PooledArena&) = delete;
+
+  UnsafeArenaBufferFactory* get() const { return arena_.get(); }
+
+ private:
+  std::unique_ptr<UnsafeArenaBufferFactory> arena_;
+  // reserved_bytes() of the arena already included in the statistics.
+  int64_t accounted_bytes_;
+};
+
+// Process-wide limits of the PooledArena pools.
+struct ArenaPoolOptions {
+  // Max total size of the pages of the idle arenas kept by the pool of a
+  // thread. 0 disables pooling.
+  int64_t max_retained_bytes_per_thread = int64_t{64} << 20;
+  // Idle arenas that were returned to the pool earlier are destroyed.
+  absl::Duration max_idle_time = absl::Seconds(10);
+};
+
+// Sets the limits for all the threads. The new limits are applied on the next
+// release of an arena on the thread.
+void SetArenaPoolOptions(const ArenaPoolOptions& options);
+
+// Returns the current limits.
+ArenaPoolOptions GetArenaPoolOptions();
+
+// Process-wide statistics of the PooledArena pools.
+struct ArenaPoolStatistics {
+  // Total number of PooledArena objects created.
+  int64_t acquisitions = 0;
+  // Number of PooledArena objects that reused a pooled arena.
+  int64_t reuses = 0;
+  // Number of arenas destroyed because they stayed idle for too long or
+  // exceeded the retention limit.
+  int64_t trimmed = 0;
+  // Bytes in the pages of all pooled arenas (including the arenas in use).
+  int64_t retained_bytes = 0;
+  // Maximum of retained_bytes since the process start.
+  int64_t retained_bytes_high_water_mark = 0;
+};
+
+// Returns the statistics of all the threads, including the finished ones.
+ArenaPoolStatistics GetArenaPoolStatistics();
+
+}  // namespace arolla
+
+#endif  // AROLLA_MEMORY_ARENA_POOL_H_
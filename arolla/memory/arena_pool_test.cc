@@ -0,0 +1,164 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/memory/arena_pool.h"
+
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/memory/raw_buffer_factory.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Ne;
+
+TEST(PooledArenaTest, Reuse) {
+  ArenaPoolStatistics stats = GetArenaPoolStatistics();
+  UnsafeArenaBufferFactory* arena_ptr;
+  {
+    PooledArena arena(1000);
+    EXPECT_THAT(arena.get()->page_size(), Eq(1000));
+    arena_ptr = arena.get();
+  }
+  {
+    PooledArena arena(1000);
+    EXPECT_THAT(arena.get(), Eq(arena_ptr));
+    // Nested arenas are different.
+    PooledArena nested_arena(1000);
+    EXPECT_THAT(nested_arena.get(), Ne(arena_ptr));
+    // Arenas with a different page size are not reused.
+    PooledArena other_arena(1024);
+    EXPECT_THAT(other_arena.get()->page_size(), Eq(1024));
+  }
+  ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+  EXPECT_THAT(new_stats.acquisitions - stats.acquisitions, Eq(4));
+  EXPECT_THAT(new_stats.reuses - stats.reuses, Eq(1));
+}
+
+TEST(PooledArenaTest, ResetOnRelease) {
+  void* data;
+  {
+    PooledArena arena(256);
+    data = std::get<1>(arena.get()->CreateRawBuffer(16));
+  }
+  PooledArena arena(256);
+  EXPECT_THAT(std::get<1>(arena.get()->CreateRawBuffer(16)), Eq(data));
+}
+
+TEST(PooledArenaTest, RetainedBytes) {
+  constexpr int64_t kPageSize = 1 << 20;
+  ArenaPoolStatistics stats = GetArenaPoolStatistics();
+  {
+    PooledArena arena(kPageSize);
+    arena.get()->CreateRawBuffer(100);
+  }
+  ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+  EXPECT_THAT(new_stats.retained_bytes_high_water_mark,
+              Ge(stats.retained_bytes + kPageSize));
+}
+
+// Restores the default ArenaPoolOptions at the end of the scope.
+class ArenaPoolOptionsOverride {
+ public:
+  explicit ArenaPoolOptionsOverride(const ArenaPoolOptions& options) {
+    SetArenaPoolOptions(options);
+  }
+  ~ArenaPoolOptionsOverride() { SetArenaPoolOptions(ArenaPoolOptions()); }
+};
+
+TEST(PooledArenaTest, RetentionLimit) {
+  constexpr int64_t kPageSize = 1 << 12;
+  ArenaPoolOptionsOverride options_override(
+      {.max_retained_bytes_per_thread = 2 * kPageSize});
+  // Use a new thread to start with an empty pool.
+  std::thread([] {
+    ArenaPoolStatistics stats = GetArenaPoolStatistics();
+    {
+      PooledArena arena(kPageSize);
+      PooledArena nested_arena(kPageSize);
+      PooledArena nested_nested_arena(kPageSize);
+      arena.get()->CreateRawBuffer(100);
+      nested_arena.get()->CreateRawBuffer(100);
+      nested_nested_arena.get()->CreateRawBuffer(100);
+    }
+    ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+    // The least recently released arena (`nested_nested_arena`) is destroyed.
+    EXPECT_THAT(new_stats.trimmed - stats.trimmed, Eq(1));
+    EXPECT_THAT(new_stats.retained_bytes - stats.retained_bytes,
+                Eq(2 * kPageSize));
+  }).join();
+}
+
+TEST(PooledArenaTest, DisabledRetention) {
+  ArenaPoolOptionsOverride options_override(
+      {.max_retained_bytes_per_thread = 0});
+  std::thread([] {
+    ArenaPoolStatistics stats = GetArenaPoolStatistics();
+    {
+      PooledArena arena(1 << 12);
+      arena.get()->CreateRawBuffer(100);
+    }
+    {
+      PooledArena arena(1 << 12);
+    }
+    ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+    EXPECT_THAT(new_stats.reuses - stats.reuses, Eq(0));
+    EXPECT_THAT(new_stats.trimmed - stats.trimmed, Eq(2));
+    EXPECT_THAT(new_stats.retained_bytes, Eq(stats.retained_bytes));
+  }).join();
+}
+
+TEST(PooledArenaTest, TrimIdleArenas) {
+  constexpr int64_t kPageSize = 1 << 12;
+  ArenaPoolOptionsOverride options_override(
+      {.max_idle_time = absl::Milliseconds(1)});
+  std::thread([] {
+    {
+      PooledArena arena(kPageSize);
+      PooledArena nested_arena(kPageSize);
+      nested_arena.get()->CreateRawBuffer(100);
+    }
+    ArenaPoolStatistics stats = GetArenaPoolStatistics();
+    absl::SleepFor(absl::Milliseconds(10));
+    // Both pooled arenas are idle for too long, only the reused one is kept.
+    { PooledArena arena(kPageSize); }
+    ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+    EXPECT_THAT(new_stats.trimmed - stats.trimmed, Eq(1));
+    EXPECT_THAT(new_stats.retained_bytes - stats.retained_bytes,
+                Eq(-kPageSize));
+  }).join();
+}
+
+TEST(PooledArenaTest, FinishedThreadsStatistics) {
+  ArenaPoolStatistics stats = GetArenaPoolStatistics();
+  std::thread([] {
+    PooledArena arena(1 << 16);
+    arena.get()->CreateRawBuffer(100);
+  }).join();
+  ArenaPoolStatistics new_stats = GetArenaPoolStatistics();
+  EXPECT_THAT(new_stats.acquisitions - stats.acquisitions, Eq(1));
+  // The pool of the finished thread is destroyed.
+  EXPECT_THAT(new_stats.retained_bytes, Eq(stats.retained_bytes));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -21,10 +21,12 @@
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "arolla/util/algorithms.h"
 
 namespace arolla {
@@ -52,6 +54,34 @@ FrameLayout::FieldFactory FrameLayout::FieldFactory::Derive(
   return res;
 }
 
+FrameLayout::FieldFactory FrameLayout::FieldFactory::WithOffsets(
+    std::vector<size_t> offsets) const {
+  FieldFactory res(type_, field_size_, construct_, destruct_, construct_n_,
+                   destruct_n_);
+  res.offsets_ = std::move(offsets);
+  return res;
+}
+
+FrameLayout::FieldSubset FrameLayout::FieldsUnchangedSince(
+    const void* alloc, absl::string_view snapshot) const {
+  DCHECK_EQ(snapshot.size(), alloc_size_);
+  const char* data = static_cast<const char*>(alloc);
+  FieldSubset result;
+  for (const auto& factory : initializers_.factories) {
+    std::vector<size_t> offsets;
+    for (size_t offset : factory.offsets()) {
+      if (std::memcmp(data + offset, snapshot.data() + offset,
+                      factory.field_size()) == 0) {
+        offsets.push_back(offset);
+      }
+    }
+    if (!offsets.empty()) {
+      result.factories_.push_back(factory.WithOffsets(std::move(offsets)));
+    }
+  }
+  return result;
+}
+
 void FrameLayout::FieldInitializers::AddOffsetToFactory(
     size_t offset, FieldFactory empty_factory) {
   auto it = type2factory.find(empty_factory.type_index());
@@ -33,6 +33,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "arolla/util/algorithms.h"
 #include "arolla/util/demangle.h"
@@ -98,6 +99,17 @@ class FrameLayout {
   // This can be used to perform runtime type checking.
   bool HasField(size_t offset, const std::type_info& type) const;
 
+  // A subset of the non-trivial fields of the layout (the ones that
+  // InitializeAlignedAlloc initializes by calling a constructor).
+  class FieldSubset;
+
+  // Returns the non-trivial fields whose bytes in `alloc` are equal to the
+  // bytes at the same position in `snapshot`, a copy of the AllocSize() bytes
+  // of the same alloc made earlier. I.e. the fields that were not modified
+  // since the snapshot was made.
+  FieldSubset FieldsUnchangedSince(const void* alloc,
+                                   absl::string_view snapshot) const;
+
  private:
   // Called by FrameLayout::Builder::Build().
   explicit FrameLayout(Builder&& builder);
@@ -305,8 +317,8 @@ class FrameLayout::FieldFactory {
         }
       };
     }
-    return FieldFactory(std::type_index(typeid(T)), construct, destruct,
-                        construct_n, destruct_n);
+    return FieldFactory(std::type_index(typeid(T)), sizeof(T), construct,
+                        destruct, construct_n, destruct_n);
   }
 
   // Returns type associated with the FieldFactory.
@@ -321,6 +333,15 @@ class FrameLayout::FieldFactory {
   // Returns a copy of the factory with adjusted offset.
   FieldFactory Derive(size_t offset) const;
 
+  // Returns a copy of the factory with the given offsets.
+  FieldFactory WithOffsets(std::vector<size_t> offsets) const;
+
+  // Offsets of the fields.
+  absl::Span<const size_t> offsets() const { return offsets_; }
+
+  // Size of every field in bytes.
+  size_t field_size() const { return field_size_; }
+
   // Initializes fields within the provided block of storage.
   void Construct(void* ptr) const { construct_(ptr, offsets_); }
 
@@ -337,19 +358,32 @@ class FrameLayout::FieldFactory {
     destruct_n_(ptr, offsets_, block_size, n);
   }
 
+  // Destroys fields within the provided block of storage and initializes them
+  // again, as InitializeAlignedAlloc does.
+  void Reset(void* ptr) const {
+    destruct_(ptr, offsets_);
+    for (size_t offset : offsets_) {
+      memset(static_cast<char*>(ptr) + offset, 0, field_size_);
+    }
+    construct_(ptr, offsets_);
+  }
+
  private:
   using FactoryFn = void (*)(void*, absl::Span<const size_t>);
   using FactoryNFn = void (*)(void*, absl::Span<const size_t>, size_t, size_t);
 
-  FieldFactory(std::type_index tpe, FactoryFn construct, FactoryFn destruct,
-               FactoryNFn construct_n, FactoryNFn destruct_n)
+  FieldFactory(std::type_index tpe, size_t field_size, FactoryFn construct,
+               FactoryFn destruct, FactoryNFn construct_n,
+               FactoryNFn destruct_n)
       : type_(tpe),
+        field_size_(field_size),
         construct_(construct),
         destruct_(destruct),
         construct_n_(construct_n),
         destruct_n_(destruct_n) {}
 
   std::type_index type_;
+  size_t field_size_;
   FactoryFn construct_;
   FactoryFn destruct_;
   std::vector<size_t> offsets_;
@@ -357,6 +391,27 @@ class FrameLayout::FieldFactory {
   FactoryNFn destruct_n_;
 };
 
+class FrameLayout::FieldSubset {
+ public:
+  FieldSubset() = default;
+
+  // Returns true if the subset contains no fields.
+  bool empty() const { return factories_.empty(); }
+
+  // Destroys the fields in the alloc and initializes them again, as
+  // InitializeAlignedAlloc does. The other fields are not modified.
+  void Reset(void* alloc) const {
+    for (const auto& factory : factories_) {
+      factory.Reset(alloc);
+    }
+  }
+
+ private:
+  friend class FrameLayout;
+
+  std::vector<FieldFactory> factories_;
+};
+
 template <class T>
 void FrameLayout::FieldInitializers::Add(size_t offset) {
   AddOffsetToFactory(offset, FieldFactory::Create<T>());
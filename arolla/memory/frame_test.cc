@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <new>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -506,6 +507,40 @@ struct is_bzero_constructible<::arolla::testing::IsBZeroConstructible>
 namespace arolla::testing {
 namespace {
 
+TEST(FrameLayoutTest, FieldsUnchangedSince) {
+  FrameLayout::Builder builder;
+  auto kept_slot = builder.AddSlot<std::shared_ptr<int>>();
+  auto reset_slot = builder.AddSlot<std::shared_ptr<int>>();
+  auto string_slot = builder.AddSlot<std::string>();
+  auto optional_slot = builder.AddSlot<std::optional<int>>();
+  auto int_slot = builder.AddSlot<int>();
+  auto layout = std::move(builder).Build();
+
+  MemoryAllocation alloc(&layout);
+  FramePtr frame = alloc.frame();
+  std::string snapshot(static_cast<const char*>(frame.GetRawPointer(0)),
+                       layout.AllocSize());
+  frame.Set(kept_slot, std::make_shared<int>(1));
+  FrameLayout::FieldSubset fields =
+      layout.FieldsUnchangedSince(frame.GetRawPointer(0), snapshot);
+  EXPECT_FALSE(fields.empty());
+
+  auto value = std::make_shared<int>(2);
+  frame.Set(reset_slot, value);
+  frame.Set(string_slot, std::string(100, 'a'));
+  frame.Set(optional_slot, 57);
+  frame.Set(int_slot, 57);
+  EXPECT_THAT(value.use_count(), Eq(2));
+  fields.Reset(frame.GetRawPointer(0));
+  EXPECT_THAT(*frame.Get(kept_slot), Eq(1));
+  EXPECT_THAT(frame.Get(reset_slot), Eq(nullptr));
+  EXPECT_THAT(value.use_count(), Eq(1));
+  EXPECT_THAT(frame.Get(string_slot), IsEmpty());
+  EXPECT_THAT(frame.Get(optional_slot), Eq(std::nullopt));
+  // Trivial fields are not reset.
+  EXPECT_THAT(frame.Get(int_slot), Eq(57));
+}
+
 TEST(FrameLayoutTest, IsBZeroConstructibleHandling) {
   ASSERT_FALSE(IsBZeroConstructible::ctor_called);
   ASSERT_FALSE(IsBZeroConstructible::dtor_called);
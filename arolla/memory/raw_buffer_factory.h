@@ -133,6 +133,11 @@ class UnsafeArenaBufferFactory : public RawBufferFactory {
   // should destroyed or recreated (e.g. arena=UnsafeArenaBufferFactory(size)).
   void Reset();
 
+  int64_t page_size() const { return page_size_; }
+
+  // Returns the size of the pages that are kept allocated after Reset().
+  int64_t reserved_bytes() const { return pages_.size() * page_size_; }
+
  private:
   using Alloc = std::tuple<RawBufferPtr, void*>;
   void NextPage();
@@ -157,6 +157,26 @@ struct Accumulator<TYPE, RESULT_T, meta::type_list<PARENT_Ts...>,
   }
   static constexpr bool IsFull() { return TYPE == AccumulatorType::kFull; }
 
+  // Range additions (optional).
+  //
+  // An aggregator with a single non-optional child argument of a trivial type
+  // T can additionally define non-virtual methods
+  //
+  //   // Adds all the `values`.
+  //   void AddRange(absl::Span<const T> values);
+  //
+  //   // Adds values[i] for all `i` such that the i-th bit of `mask` is set.
+  //   // values.size() <= 32, missing values may be uninitialized.
+  //   void AddMaskedRange(absl::Span<const T> values, uint32_t mask);
+  //
+  // Group operators detect them at compile time and use them instead of `Add`
+  // for contiguous ranges of child rows (e.g. for SPLIT_POINTS edges), which
+  // saves a virtual call per row. They must give the same result as calling
+  // `Add` for the added values in order. An implementation may combine the
+  // values in a different order (e.g. in several independent lanes, which the
+  // compiler can vectorize) only if the order is not observable, like for
+  // integer sums, or if the aggregator explicitly opts in to it.
+
  protected:
   virtual ~Accumulator() = default;
 };
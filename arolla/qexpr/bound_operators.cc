@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/types/span.h"
@@ -28,16 +29,16 @@
 namespace arolla {
 namespace {
 
-template <bool kHasCancellationContext>
+// Runs `op_count` operators, `run_op(ip)` must run the operator number `ip`.
+template <bool kHasCancellationContext, typename RunOpFn>
 inline int64_t RunBoundOperatorsImpl(
-    absl::Span<const std::unique_ptr<BoundOperator>> ops,
-    EvaluationContext* ctx, FramePtr frame,
+    size_t op_count, RunOpFn run_op, EvaluationContext* ctx,
     [[maybe_unused]] CancellationContext* cancellation_context) {
   DCHECK_OK(ctx->status());
   DCHECK_EQ(ctx->requested_jump(), 0);
   DCHECK(!ctx->signal_received());
-  for (size_t ip = 0; ip < ops.size(); ++ip) {
-    ops[ip]->Run(ctx, frame);
+  for (size_t ip = 0; ip < op_count; ++ip) {
+    run_op(ip);
     // NOTE: consider making signal_received a mask once we have more than two
     // signals.
     if (ctx->signal_received()) [[unlikely]] {
@@ -46,7 +47,7 @@ inline int64_t RunBoundOperatorsImpl(
       }
       if (ctx->requested_jump() != 0) [[likely]] {
         ip += ctx->requested_jump();
-        DCHECK_LT(ip, ops.size());
+        DCHECK_LT(ip, op_count);
       }
       ctx->ResetSignals();
     }
@@ -57,22 +58,46 @@ inline int64_t RunBoundOperatorsImpl(
       }
     }
   }
-  return ops.size() - 1;
+  return op_count - 1;
 }
 
-}  // namespace
-
-int64_t RunBoundOperators(absl::Span<const std::unique_ptr<BoundOperator>> ops,
-                          EvaluationContext* ctx, FramePtr frame) {
+template <typename RunOpFn>
+int64_t RunOperators(size_t op_count, RunOpFn run_op, EvaluationContext* ctx) {
   auto* cancellation_context =
       CancellationContext::ScopeGuard::current_cancellation_context();
   if (cancellation_context == nullptr) [[likely]] {
-    return RunBoundOperatorsImpl<false>(ops, ctx, frame, cancellation_context);
+    return RunBoundOperatorsImpl<false>(op_count, run_op, ctx,
+                                        cancellation_context);
   } else {
-    return RunBoundOperatorsImpl<true>(ops, ctx, frame, cancellation_context);
+    return RunBoundOperatorsImpl<true>(op_count, run_op, ctx,
+                                       cancellation_context);
   }
 }
 
+}  // namespace
+
+int64_t RunBoundOperators(absl::Span<const std::unique_ptr<BoundOperator>> ops,
+                          EvaluationContext* ctx, FramePtr frame) {
+  return RunOperators(
+      ops.size(), [&](size_t ip) { ops[ip]->Run(ctx, frame); }, ctx);
+}
+
+DirectThreadedOperators::DirectThreadedOperators(
+    absl::Span<const std::unique_ptr<BoundOperator>> ops) {
+  records_.resize(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    records_[i].fn = ops[i]->PrepareDirectRun(records_[i].state);
+  }
+}
+
+int64_t DirectThreadedOperators::Run(EvaluationContext* ctx,
+                                     FramePtr frame) const {
+  const Record* records = records_.data();
+  return RunOperators(
+      records_.size(),
+      [&](size_t ip) { records[ip].fn(records[ip].state, ctx, frame); }, ctx);
+}
+
 std::unique_ptr<BoundOperator> JumpBoundOperator(int64_t jump) {
   return MakeBoundOperator([=](EvaluationContext* ctx, FramePtr frame) {
     ctx->set_requested_jump(jump);
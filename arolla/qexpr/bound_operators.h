@@ -19,9 +19,11 @@
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/types/span.h"
 #include "arolla/memory/frame.h"
 #include "arolla/qexpr/eval_context.h"
@@ -37,6 +39,30 @@ namespace arolla {
 int64_t RunBoundOperators(absl::Span<const std::unique_ptr<BoundOperator>> ops,
                           EvaluationContext* ctx, FramePtr frame);
 
+// A sequence of bound operators prepared to run without virtual calls (see
+// BoundOperator::PrepareDirectRun). Function pointers and operator states
+// (usually just slot offsets) are stored in a contiguous array, which avoids
+// a pointer chase and a vtable lookup per operator for long sequences of small
+// operators. The operators must outlive the object.
+class DirectThreadedOperators {
+ public:
+  DirectThreadedOperators() = default;
+  explicit DirectThreadedOperators(
+      absl::Span<const std::unique_ptr<BoundOperator>> ops);
+
+  // Equivalent to RunBoundOperators(ops, ctx, frame).
+  int64_t Run(EvaluationContext* ctx, FramePtr frame) const;
+
+ private:
+  struct Record {
+    BoundOperator::DirectRunFn fn;
+    alignas(BoundOperator::kDirectRunStateAlignment) char
+        state[BoundOperator::kDirectRunStateSize];
+  };
+
+  std::vector<Record> records_;
+};
+
 // Implementation of BoundOperator interface based on the provided functor.
 template <typename Functor>
 class FunctorBoundOperator final : public BoundOperator {
@@ -45,16 +71,27 @@ class FunctorBoundOperator final : public BoundOperator {
       : functor_(std::move(functor)) {}
 
   void Run(EvaluationContext* ctx, FramePtr frame) const final {
-    if constexpr (std::is_same_v<absl::Status,
-                                 decltype(functor_(ctx, frame))>) {
-      auto status = functor_(ctx, frame);
+    RunFunctor(functor_, ctx, frame);
+  }
+
+  // NOTE: Small trivially copyable functors are copied into the state, so they
+  // must not rely on their identity.
+  DirectRunFn PrepareDirectRun(void* state) const final {
+    return PrepareDirectRunWithData<&RunFunctor>(functor_, state);
+  }
+
+ private:
+  static void RunFunctor(const Functor& functor, EvaluationContext* ctx,
+                         FramePtr frame) {
+    if constexpr (std::is_same_v<absl::Status, decltype(functor(ctx, frame))>) {
+      auto status = functor(ctx, frame);
       if (!status.ok()) {
         ctx->set_status(std::move(status));
       }
     } else {
-      static_assert(std::is_same_v<void, decltype(functor_(ctx, frame))>,
+      static_assert(std::is_same_v<void, decltype(functor(ctx, frame))>,
                     "functor(ctx, frame) must return void or absl::Status");
-      functor_(ctx, frame);
+      functor(ctx, frame);
     }
   }
 
@@ -204,6 +204,65 @@ TEST(BoundOperators, RunBoundOperators_Cancellation) {
   }
 }
 
+TEST(BoundOperators, DirectThreadedOperators) {
+  FrameLayout::Builder layout_builder;
+  Slot<int32_t> x_slot = layout_builder.AddSlot<int32_t>();
+  Slot<bool> cond_slot = layout_builder.AddSlot<bool>();
+  FrameLayout layout = std::move(layout_builder).Build();
+  MemoryAllocation alloc(&layout);
+
+  // Trivially copyable functor, stored in DirectThreadedOperators.
+  auto make_increment_operator = [x_slot](int32_t increment) {
+    return MakeBoundOperator(
+        [x_slot, increment](EvaluationContext* ctx, FramePtr frame) {
+          frame.Set(x_slot, frame.Get(x_slot) + increment);
+        });
+  };
+  std::vector<std::unique_ptr<BoundOperator>> bound_operators;
+  bound_operators.push_back(make_increment_operator(1));
+  bound_operators.push_back(JumpIfNotBoundOperator(cond_slot, 1));
+  bound_operators.push_back(make_increment_operator(10));
+  // Not trivially copyable functor, referenced from DirectThreadedOperators.
+  bound_operators.push_back(MakeBoundOperator(
+      [x_slot, increments = std::vector<int32_t>{100, 1000}](
+          EvaluationContext* ctx, FramePtr frame) -> absl::Status {
+        for (int32_t increment : increments) {
+          frame.Set(x_slot, frame.Get(x_slot) + increment);
+        }
+        if (frame.Get(x_slot) > 2000) {
+          return absl::InvalidArgumentError("too large");
+        }
+        return absl::OkStatus();
+      }));
+  // Operator with the default PrepareDirectRun.
+  bound_operators.push_back(
+      std::make_unique<ResetBoundOperator>(TypedSlot::FromSlot(cond_slot)));
+  DirectThreadedOperators direct_operators(bound_operators);
+
+  {
+    EvaluationContext ctx;
+    EXPECT_EQ(direct_operators.Run(&ctx, alloc.frame()), 4);
+    EXPECT_THAT(alloc.frame().Get(x_slot), Eq(1101));
+    EXPECT_THAT(ctx.status(), IsOk());
+  }
+  {
+    alloc.frame().Set(x_slot, 0);
+    alloc.frame().Set(cond_slot, true);
+    EvaluationContext ctx;
+    EXPECT_EQ(direct_operators.Run(&ctx, alloc.frame()), 4);
+    EXPECT_THAT(alloc.frame().Get(x_slot), Eq(1111));
+    EXPECT_THAT(alloc.frame().Get(cond_slot), Eq(false));
+    EXPECT_THAT(ctx.status(), IsOk());
+  }
+  {
+    EvaluationContext ctx;
+    EXPECT_EQ(direct_operators.Run(&ctx, alloc.frame()), 3);
+    EXPECT_THAT(alloc.frame().Get(x_slot), Eq(2212));
+    EXPECT_THAT(ctx.status(),
+                StatusIs(absl::StatusCode::kInvalidArgument, "too large"));
+  }
+}
+
 // Exercise WhereAllBoundOperator by adding mixture of optional and
 // non-optional floats.
 TEST(BoundOperators, WhereAll) {
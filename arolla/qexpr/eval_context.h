@@ -22,12 +22,18 @@
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "arolla/memory/raw_buffer_factory.h"
+#include "arolla/util/threading.h"
 
 namespace arolla {
 
 // EvaluationOptions provides generic facilities like a buffer factory.
 struct EvaluationOptions {
   RawBufferFactory* absl_nonnull buffer_factory = GetHeapBufferFactory();
+
+  // If set, group operations over large inputs (e.g. aggregations over
+  // DenseArray and Array) split the parent rows into ranges and process them
+  // on several threads. The results are the same as in the sequential mode.
+  ThreadingInterface* absl_nullable threading = nullptr;
 };
 
 // EvaluationContext contains all the data QExpr operator may need in runtime.
@@ -18,6 +18,7 @@
 #include <bitset>
 #include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +46,14 @@
 #include "arolla/util/operator_name.h"
 
 namespace arolla {
+
+BoundOperator::DirectRunFn BoundOperator::PrepareDirectRun(void* state) const {
+  new (state) const BoundOperator*(this);
+  return [](const void* state, EvaluationContext* ctx, FramePtr frame) {
+    (*static_cast<const BoundOperator* const*>(state))->Run(ctx, frame);
+  };
+}
+
 namespace {
 
 // QExprOperator family that stores several independent operators sharing the
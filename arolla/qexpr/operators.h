@@ -17,7 +17,9 @@
 
 #include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -40,6 +42,15 @@ namespace arolla {
 
 class BoundOperator {
  public:
+  // Size and alignment of the state buffer passed to PrepareDirectRun.
+  static constexpr size_t kDirectRunStateSize = 56;
+  static constexpr size_t kDirectRunStateAlignment = 8;
+
+  // A function running an operator using the state written by
+  // PrepareDirectRun.
+  using DirectRunFn = void (*)(const void* state, EvaluationContext* ctx,
+                               FramePtr frame);
+
   virtual ~BoundOperator() = default;
 
   // Runs an operation against the provided evaluation context.
@@ -51,8 +62,39 @@ class BoundOperator {
   // to check the status before calling another operation using the same
   // `ctx`.
   virtual void Run(EvaluationContext* ctx, FramePtr frame) const = 0;
+
+  // Prepares the operation to run without a virtual call. Writes a trivially
+  // copyable state (at most kDirectRunStateSize bytes) into `state` and
+  // returns a function such that `fn(copy_of_state, ctx, frame)` is equivalent
+  // to `Run(ctx, frame)`. The state may refer to the operator, so the operator
+  // must outlive all its copies.
+  //
+  // The default implementation stores `this` and calls Run.
+  virtual DirectRunFn PrepareDirectRun(void* state) const;
 };
 
+// A helper to implement BoundOperator::PrepareDirectRun for operators that
+// keep all their data in `data` and run as `kRunFn(data, ctx, frame)`. Small
+// trivially copyable data is copied into the state, otherwise the state
+// stores a pointer to `data`.
+template <auto kRunFn, typename Data>
+BoundOperator::DirectRunFn PrepareDirectRunWithData(const Data& data,
+                                                    void* state) {
+  if constexpr (std::is_trivially_copyable_v<Data> &&
+                sizeof(Data) <= BoundOperator::kDirectRunStateSize &&
+                alignof(Data) <= BoundOperator::kDirectRunStateAlignment) {
+    new (state) Data(data);
+    return [](const void* state, EvaluationContext* ctx, FramePtr frame) {
+      kRunFn(*static_cast<const Data*>(state), ctx, frame);
+    };
+  } else {
+    new (state) const Data*(&data);
+    return [](const void* state, EvaluationContext* ctx, FramePtr frame) {
+      kRunFn(**static_cast<const Data* const*>(state), ctx, frame);
+    };
+  }
+}
+
 class QExprOperator {
  public:
   template <typename T>
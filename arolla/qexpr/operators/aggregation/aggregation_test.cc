@@ -13,6 +13,7 @@
 // limitations under the License.
 //
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <optional>
@@ -24,12 +25,14 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/types/span.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/aggregation_ops_interface.h"
 #include "arolla/qexpr/eval_context.h"
 #include "arolla/qexpr/operators/aggregation/group_op_accumulators.h"
 #include "arolla/util/bytes.h"
 #include "arolla/util/meta.h"
+#include "arolla/util/unit.h"
 
 namespace arolla {
 namespace {
@@ -66,6 +69,86 @@ TEST(Accumulator, AddN) {
   EXPECT_EQ(acc.GetResult(), 50);
 }
 
+// Checks that AddRange and AddMaskedRange are equivalent to Add of the
+// selected values.
+template <typename Acc, typename T>
+void TestRangeAdditions(absl::Span<const T> values, uint32_t mask) {
+  Acc expected;
+  expected.Reset();
+  Acc acc;
+  acc.Reset();
+  for (size_t i = 0; i < values.size(); ++i) {
+    if ((mask >> i) & 1) expected.Add(values[i]);
+  }
+  acc.AddMaskedRange(values, mask);
+  EXPECT_EQ(acc.GetResult(), expected.GetResult()) << mask;
+
+  for (T value : values) expected.Add(value);
+  acc.AddRange(values);
+  EXPECT_EQ(acc.GetResult(), expected.GetResult()) << mask;
+}
+
+TEST(Accumulator, RangeAdditions) {
+  std::vector<float> floats = {1.5f, -2.f, 1e8f, 3.f, -1e8f, 0.25f, 7.f};
+  std::vector<int64_t> ints = {5, -3, 10, 2, -7, 4, 1, 8, 0};
+  std::vector<Unit> units(20);
+  for (uint32_t mask : {0b0u, 0b1u, 0b1000u, 0b1010010u, 0b1111111u}) {
+    TestRangeAdditions<SumAggregator<float>, float>(floats, mask);
+    TestRangeAdditions<MinAggregator<float>, float>(floats, mask);
+    TestRangeAdditions<MaxAggregator<float>, float>(floats, mask);
+    TestRangeAdditions<SumAggregator<int64_t>, int64_t>(ints, mask);
+    TestRangeAdditions<MinAggregator<int64_t>, int64_t>(ints, mask);
+    TestRangeAdditions<MaxAggregator<int64_t>, int64_t>(ints, mask);
+    TestRangeAdditions<SimpleCountAggregator, Unit>(units, mask);
+  }
+}
+
+TEST(Accumulator, LaneRangeAdditions) {
+  // More values than lanes, with a remainder, and wrapping integer sums.
+  std::vector<int32_t> ints32;
+  std::vector<int64_t> ints64;
+  for (int i = 0; i < 29; ++i) {
+    int32_t value = i == 5 ? std::numeric_limits<int32_t>::max()
+                           : (i % 3 == 0 ? -1 : 1) * (i * 1000003 % 7919);
+    ints32.push_back(value);
+    ints64.push_back(value * int64_t{7919});
+  }
+  for (uint32_t mask : {0b0u, 0b1u, 0x10000000u, 0x0f0f0f0fu, 0x1fffffffu}) {
+    TestRangeAdditions<SumAggregator<int32_t>, int32_t>(ints32, mask);
+    TestRangeAdditions<MinAggregator<int32_t>, int32_t>(ints32, mask);
+    TestRangeAdditions<MaxAggregator<int32_t>, int32_t>(ints32, mask);
+    TestRangeAdditions<ProdAggregator<int32_t>, int32_t>(ints32, mask);
+    TestRangeAdditions<SumAggregator<int64_t>, int64_t>(ints64, mask);
+    TestRangeAdditions<MinAggregator<int64_t>, int64_t>(ints64, mask);
+    TestRangeAdditions<MaxAggregator<int64_t>, int64_t>(ints64, mask);
+  }
+}
+
+TEST(Accumulator, ReassociatingSumRangeAdditions) {
+  std::vector<float> floats;
+  for (int i = 0; i < 29; ++i) floats.push_back(1.f / (i + 1) - 0.1f);
+  for (uint32_t mask : {0b1u, 0x0f0f0f0fu, 0x1fffffffu}) {
+    SumAggregator<float> expected;
+    expected.Reset();
+    ReassociatingSumAggregator<float> acc;
+    acc.Reset();
+    expected.AddMaskedRange(floats, mask);
+    acc.AddMaskedRange(floats, mask);
+    EXPECT_TRUE(acc.GetResult().present);
+    EXPECT_NEAR(acc.GetResult().value, expected.GetResult().value, 1e-5)
+        << mask;
+    expected.AddRange(floats);
+    acc.AddRange(floats);
+    EXPECT_NEAR(acc.GetResult().value, expected.GetResult().value, 1e-5)
+        << mask;
+  }
+
+  ReassociatingSumAggregator<float> empty;
+  empty.Reset();
+  empty.AddMaskedRange(floats, 0);
+  EXPECT_FALSE(empty.GetResult().present);
+}
+
 TEST(OpInterface, CreateAccumulator) {
   EvaluationOptions eval_options;
 
@@ -545,5 +628,77 @@ TEST(Accumulator, AggMedianNan) {
   EXPECT_TRUE(std::isnan(acc.GetResult().value));
 }
 
+TEST(Accumulator, ApproxInverseCdf) {
+  // Small groups are processed exactly, so the results match
+  // InverseCdfAccumulator.
+  std::vector<int> values = {7, 1, 1, 2, 9, -3, 5};
+  for (float cdf : {0.f, 0.1f, 0.3f, 0.5f, 0.99f, 1.f}) {
+    InverseCdfAccumulator<int> expected_acc(cdf);
+    ApproxInverseCdfAccumulator<int> acc(cdf, /*k=*/200);
+    EXPECT_OK(acc.GetStatus());
+    acc.Reset();
+    EXPECT_EQ(acc.GetResult(), std::nullopt);
+    expected_acc.Reset();
+    for (int v : values) {
+      acc.Add(v);
+      expected_acc.Add(v);
+    }
+    EXPECT_EQ(acc.GetResult(), expected_acc.GetResult()) << cdf;
+  }
+}
+
+TEST(Accumulator, ApproxInverseCdfBig) {
+  ApproxInverseCdfAccumulator<int64_t> acc(0.3f, /*k=*/200);
+  acc.Reset();
+  constexpr int64_t kSize = 100000;
+  for (int64_t i = 0; i < kSize; ++i) {
+    acc.Add((i * 7919) % kSize);
+  }
+  OptionalValue<int64_t> result = acc.GetResult();
+  ASSERT_TRUE(result.present);
+  EXPECT_NEAR(result.value, 0.3 * kSize, 0.01 * kSize);
+}
+
+TEST(Accumulator, ApproxInverseCdfMerge) {
+  ApproxInverseCdfAccumulator<float> acc1(0.5f, /*k=*/8);
+  ApproxInverseCdfAccumulator<float> acc2(0.5f, /*k=*/8);
+  acc1.Reset();
+  acc2.Reset();
+  acc1.Add(1.f);
+  acc1.Add(5.f);
+  acc2.Add(3.f);
+  acc1.Merge(acc2);
+  EXPECT_EQ(acc1.GetResult(), 3.f);
+
+  acc2.Add(kNaN);
+  acc1.Merge(acc2);
+  EXPECT_TRUE(std::isnan(acc1.GetResult().value));
+}
+
+TEST(Accumulator, ApproxInverseCdfNan) {
+  ApproxInverseCdfAccumulator<float> acc(0.5f, /*k=*/200);
+  acc.Reset();
+  acc.Add(7);
+  acc.Add(kNaN);
+  acc.Add(2);
+  EXPECT_TRUE(std::isnan(acc.GetResult().value));
+  acc.Reset();
+  acc.Add(7);
+  acc.Add(2);
+  EXPECT_EQ(acc.GetResult(), 2.f);
+}
+
+TEST(Accumulator, ApproxInverseCdfInvalidArgs) {
+  EXPECT_THAT(ApproxInverseCdfAccumulator<float>(1.5f, 200).GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid cdf_arg")));
+  EXPECT_THAT(ApproxInverseCdfAccumulator<float>(kNaN, 200).GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid cdf_arg")));
+  EXPECT_THAT(ApproxInverseCdfAccumulator<float>(0.5f, 1).GetStatus(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid k, k must be in [8, 65536], got 1")));
+}
+
 }  // namespace
 }  // namespace arolla
@@ -18,7 +18,9 @@
 #define AROLLA_QEXPR_OPERATORS_AGGREGATION_GROUP_OP_ACCUMULATORS_H_
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -31,6 +33,8 @@
 
 #include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/statusor.h"
@@ -41,6 +45,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/aggregation_ops_interface.h"
 #include "arolla/qexpr/eval_context.h"
+#include "arolla/qexpr/operators/aggregation/kll_sketch.h"
 #include "arolla/qexpr/operators/math/arithmetic.h"
 #include "arolla/util/cancellation.h"
 #include "arolla/util/meta.h"
@@ -58,6 +63,14 @@ struct SimpleCountAccumulator
   void AddN(int64_t n, Unit) final { accumulator += n; }
   int64_t GetResult() final { return accumulator; }
 
+  // Range additions, see aggregation_ops_interface.h.
+  void AddRange(absl::Span<const Unit> values) {
+    accumulator += values.size();
+  }
+  void AddMaskedRange(absl::Span<const Unit>, uint32_t mask) {
+    accumulator += absl::popcount(mask);
+  }
+
   int64_t accumulator{0};
 };
 
@@ -168,7 +181,59 @@ struct WideAccumulator<
   using type = double;
 };
 
-template <typename ValueT, AccumulatorType AccumulatorType>
+namespace group_op_accumulators_impl {
+
+// Number of independent partial results used by LaneReduce.
+constexpr size_t kReductionLanes = 8;
+
+// Combines `values` with `op` starting from `neutral`, which must be the
+// identity of `op`. Uses kReductionLanes independent partial results, so
+// there is no dependency between consecutive iterations and the loop can be
+// vectorized, but the values are combined in a different order than one by
+// one. So `op` must be associative and commutative, or the caller must
+// explicitly accept the reordering.
+template <typename T, typename ValueT, typename Op>
+T LaneReduce(absl::Span<const ValueT> values, T neutral, Op op) {
+  std::array<T, kReductionLanes> lanes;
+  lanes.fill(neutral);
+  size_t i = 0;
+  for (; i + kReductionLanes <= values.size(); i += kReductionLanes) {
+    for (size_t j = 0; j < kReductionLanes; ++j) {
+      lanes[j] = op(lanes[j], static_cast<T>(values[i + j]));
+    }
+  }
+  for (size_t j = 0; i + j < values.size(); ++j) {
+    lanes[j] = op(lanes[j], static_cast<T>(values[i + j]));
+  }
+  T result = lanes[0];
+  for (size_t j = 1; j < kReductionLanes; ++j) {
+    result = op(result, lanes[j]);
+  }
+  return result;
+}
+
+// Same as LaneReduce, but combines only values[i] such that the i-th bit of
+// `mask` is set. values.size() <= 32, missing values may be uninitialized.
+template <typename T, typename ValueT, typename Op>
+T MaskedLaneReduce(absl::Span<const ValueT> values, uint32_t mask, T neutral,
+                   Op op) {
+  DCHECK_LE(values.size(), 32);
+  std::array<T, 32> selected;
+  for (size_t i = 0; i < values.size(); ++i) {
+    selected[i] = ((mask >> i) & 1) ? static_cast<T>(values[i]) : neutral;
+  }
+  return LaneReduce(absl::Span<const T>(selected.data(), values.size()),
+                    neutral, op);
+}
+
+}  // namespace group_op_accumulators_impl
+
+// Sums the values. Integer sums wrap around, so they are associative and
+// range additions use independent lanes. Floating-point values are added one
+// by one in row order unless AllowReassociation is set, in which case range
+// additions may reorder them (the result can differ in the last bits).
+template <typename ValueT, AccumulatorType AccumulatorType,
+          bool AllowReassociation = false>
 struct SumAccumulator
     : Accumulator<AccumulatorType, OptionalValue<ValueT>, meta::type_list<>,
                   meta::type_list<ValueT>> {
@@ -195,6 +260,47 @@ struct SumAccumulator
     return {accumulator.present, static_cast<ValueT>(accumulator.value)};
   }
 
+  // Range additions, see aggregation_ops_interface.h.
+  static constexpr bool kUseLanes =
+      std::is_integral_v<AccumulatorT> || AllowReassociation;
+  // -0.0 rather than 0.0 is the identity of floating-point addition.
+  static constexpr AccumulatorT kNeutral =
+      std::is_integral_v<AccumulatorT> ? AccumulatorT{0} : -AccumulatorT{0};
+
+  void AddRange(absl::Span<const ValueT> values) {
+    if (values.empty()) return;
+    if constexpr (kUseLanes) {
+      accumulator = AddOp()(
+          accumulator.value,
+          group_op_accumulators_impl::LaneReduce(values, kNeutral, AddOp()));
+    } else {
+      // A serial reduction in row order; the only gain over `Add` is that
+      // there are no virtual calls.
+      AccumulatorT sum = accumulator.value;
+      for (ValueT value : values) {
+        sum = AddOp()(sum, static_cast<AccumulatorT>(value));
+      }
+      accumulator = sum;
+    }
+  }
+  void AddMaskedRange(absl::Span<const ValueT> values, uint32_t mask) {
+    if (mask == 0) return;
+    if constexpr (kUseLanes) {
+      accumulator =
+          AddOp()(accumulator.value,
+                  group_op_accumulators_impl::MaskedLaneReduce(
+                      values, mask, kNeutral, AddOp()));
+    } else {
+      // A serial reduction in row order, see AddRange.
+      AccumulatorT sum = accumulator.value;
+      for (; mask != 0; mask &= mask - 1) {
+        sum = AddOp()(
+            sum, static_cast<AccumulatorT>(values[absl::countr_zero(mask)]));
+      }
+      accumulator = sum;
+    }
+  }
+
   OptionalValue<ValueT> initial;
   OptionalValue<AccumulatorT> accumulator;
 };
@@ -203,6 +309,12 @@ template <typename ValueT>
 using SumAggregator = SumAccumulator<ValueT, AccumulatorType::kAggregator>;
 template <typename ValueT>
 using SumPartialAccumulator = SumAccumulator<ValueT, AccumulatorType::kPartial>;
+// Same as SumAggregator, but floating-point range additions may reorder the
+// values, so the result can differ from SumAggregator in the last bits.
+template <typename ValueT>
+using ReassociatingSumAggregator =
+    SumAccumulator<ValueT, AccumulatorType::kAggregator,
+                   /*AllowReassociation=*/true>;
 
 // TODO: Consider implementing this using the iterative mean
 // algorithm to avoid over- and underflows.
@@ -287,6 +399,70 @@ struct FunctorAccumulator
     return {accumulator.present, static_cast<ResultT>(accumulator.value)};
   }
 
+  // Range additions, see aggregation_ops_interface.h. Integer min, max and
+  // product are associative and commutative, so they use independent lanes.
+  // Floating-point values are combined one by one in row order, because the
+  // order is observable (NaNs, signed zeros, rounding).
+  static constexpr bool kUseLanes =
+      std::is_integral_v<AccumulatorT> &&
+      (std::is_same_v<FunctorT, MinOp> || std::is_same_v<FunctorT, MaxOp> ||
+       std::is_same_v<FunctorT, MultiplyOp>);
+
+  static constexpr AccumulatorT LaneNeutral() {
+    if constexpr (std::is_same_v<FunctorT, MinOp>) {
+      return std::numeric_limits<AccumulatorT>::max();
+    } else if constexpr (std::is_same_v<FunctorT, MaxOp>) {
+      return std::numeric_limits<AccumulatorT>::lowest();
+    } else {
+      return AccumulatorT{1};
+    }
+  }
+
+  void AddRange(absl::Span<const ValueT> values) {
+    if (values.empty()) return;
+    if constexpr (kUseLanes) {
+      AccumulatorT reduced = group_op_accumulators_impl::LaneReduce(
+          values, LaneNeutral(), FunctorT());
+      accumulator = accumulator.present
+                        ? FunctorT()(accumulator.value, reduced)
+                        : reduced;
+    } else {
+      // A serial reduction in row order; the only gain over `Add` is that
+      // there are no virtual calls.
+      size_t i = 0;
+      if (!accumulator.present) {
+        accumulator = values[i++];
+      }
+      AccumulatorT acc = accumulator.value;
+      for (; i < values.size(); ++i) {
+        acc = FunctorT()(acc, static_cast<AccumulatorT>(values[i]));
+      }
+      accumulator = acc;
+    }
+  }
+  void AddMaskedRange(absl::Span<const ValueT> values, uint32_t mask) {
+    if (mask == 0) return;
+    if constexpr (kUseLanes) {
+      AccumulatorT reduced = group_op_accumulators_impl::MaskedLaneReduce(
+          values, mask, LaneNeutral(), FunctorT());
+      accumulator = accumulator.present
+                        ? FunctorT()(accumulator.value, reduced)
+                        : reduced;
+    } else {
+      // A serial reduction in row order, see AddRange.
+      if (!accumulator.present) {
+        accumulator = values[absl::countr_zero(mask)];
+        mask &= mask - 1;
+      }
+      AccumulatorT acc = accumulator.value;
+      for (; mask != 0; mask &= mask - 1) {
+        acc = FunctorT()(
+            acc, static_cast<AccumulatorT>(values[absl::countr_zero(mask)]));
+      }
+      accumulator = acc;
+    }
+  }
+
   OptionalValue<ResultT> initial;
   OptionalValue<AccumulatorT> accumulator;
 };
@@ -366,6 +542,83 @@ class InverseCdfAccumulator
   absl::Status status_;
 };
 
+// Approximate version of InverseCdfAccumulator that uses a bounded amount of
+// memory per group: O(k * log(n / k)) values instead of n (see KllSketch).
+// The result is exact for groups with up to ~k values.
+template <typename T>
+class ApproxInverseCdfAccumulator
+    : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
+                         meta::type_list<>, meta::type_list<T>> {
+ public:
+  static constexpr int64_t kMinK = 8;
+  static constexpr int64_t kMaxK = int64_t{1} << 16;
+
+  ApproxInverseCdfAccumulator(float cdf, int64_t k)
+      : cdf_(cdf), sketch_(std::clamp(k, kMinK, kMaxK)) {
+    if (std::isnan(cdf) || cdf < 0 || cdf > 1) {
+      status_ = absl::InvalidArgumentError(absl::StrFormat(
+          "unable to compute math.approx_inverse_cdf: invalid cdf_arg, "
+          "cdf_arg must be in [0, 1], got %f",
+          cdf));
+    } else if (k < kMinK || k > kMaxK) {
+      status_ = absl::InvalidArgumentError(absl::StrFormat(
+          "unable to compute math.approx_inverse_cdf: invalid k, k must be "
+          "in [%d, %d], got %d",
+          kMinK, kMaxK, k));
+    }
+  }
+
+  void Reset() final {
+    sketch_.Clear();
+    nan_value_ = std::nullopt;
+  }
+
+  void Add(view_type_t<T> v) final {
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN) {
+      if (std::isnan(v)) {
+        if (!nan_value_.present) {
+          nan_value_ = v;
+        }
+        return;
+      }
+    }
+    sketch_.Add(v);
+  }
+
+  // Adds the values of the same group aggregated by another accumulator, e.g.
+  // on another shard. Both accumulators must be constructed with the same `k`.
+  void Merge(const ApproxInverseCdfAccumulator& other) {
+    sketch_.Merge(other.sketch_);
+    if (!nan_value_.present) {
+      nan_value_ = other.nan_value_;
+    }
+  }
+
+  OptionalValue<view_type_t<T>> GetResult() final {
+    if (!status_.ok()) {
+      return std::nullopt;
+    }
+    if (nan_value_.present) {
+      return nan_value_;
+    }
+    if (sketch_.count() == 0) {
+      return std::nullopt;
+    }
+    // The same offset as in InverseCdfAccumulator.
+    int64_t offset = static_cast<int64_t>(ceil(cdf_ * sketch_.count()) - 1);
+    offset = std::clamp<int64_t>(offset, 0, sketch_.count() - 1);
+    return sketch_.ValueAtRank(offset);
+  }
+
+  absl::Status GetStatus() final { return status_; }
+
+ private:
+  float cdf_;
+  KllSketch<T> sketch_;
+  OptionalValue<T> nan_value_;
+  absl::Status status_;
+};
+
 template <typename T>
 class CollapseAccumulator
     : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
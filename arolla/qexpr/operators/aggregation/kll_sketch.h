@@ -0,0 +1,199 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_QEXPR_OPERATORS_AGGREGATION_KLL_SKETCH_H_
+#define AROLLA_QEXPR_OPERATORS_AGGREGATION_KLL_SKETCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+
+namespace arolla {
+
+// Streaming quantile sketch described in Karnin, Lang, Liberty, "Optimal
+// Quantile Approximation in Streams" (2016).
+//
+// The sketch keeps O(k * log(n / k)) of n added values. The values are stored
+// in levels; a value on level h represents 2^h of the added values. When
+// a level is full, it is sorted and every other value is moved to the next
+// level. While no more than ~k values are added, all of them are kept and the
+// results are exact.
+//
+// The sketches with the same `k` can be merged, e.g. to combine partial
+// aggregations computed on different shards.
+//
+// The compaction is pseudo-random, but deterministic: the same sequence of
+// operations always gives the same result.
+//
+// T must be totally ordered by operator<, e.g. floating point values must not
+// be NaN.
+template <typename T>
+class KllSketch {
+ public:
+  // `k` controls the accuracy and the memory usage. With k = 200 the rank
+  // error of a single quantile is typically below 1% of the number of added
+  // values.
+  explicit KllSketch(int64_t k) : k_(k) {
+    DCHECK_GE(k, 2);
+    Clear();
+  }
+
+  // Removes all the values. Keeps the allocated memory.
+  void Clear() {
+    for (auto& level : levels_) {
+      level.clear();
+    }
+    if (levels_.empty()) {
+      levels_.emplace_back();
+    }
+    level_count_ = 1;
+    count_ = 0;
+    retained_count_ = 0;
+    max_retained_count_ = Capacity(0);
+    random_state_ = 0;
+  }
+
+  void Add(T value) {
+    levels_[0].push_back(value);
+    ++count_;
+    if (++retained_count_ >= max_retained_count_) {
+      Compress();
+    }
+  }
+
+  // Adds all the values of `other` sketch. `other` must have the same `k`.
+  void Merge(const KllSketch& other) {
+    DCHECK_NE(this, &other);
+    DCHECK_EQ(k_, other.k_);
+    while (level_count_ < other.level_count_) {
+      AddLevel();
+    }
+    for (int h = 0; h < other.level_count_; ++h) {
+      levels_[h].insert(levels_[h].end(), other.levels_[h].begin(),
+                        other.levels_[h].end());
+    }
+    count_ += other.count_;
+    retained_count_ += other.retained_count_;
+    while (retained_count_ >= max_retained_count_) {
+      Compress();
+    }
+  }
+
+  // Number of the added values.
+  int64_t count() const { return count_; }
+
+  // Number of the values stored in the sketch.
+  int64_t retained_count() const { return retained_count_; }
+
+  // Returns an approximation of the value at position `rank` (0-based) in
+  // the sorted sequence of the added values. Requires 0 <= rank < count().
+  T ValueAtRank(int64_t rank) const {
+    DCHECK_GE(rank, 0);
+    DCHECK_LT(rank, count_);
+    std::vector<std::pair<T, int64_t>> weighted_values;
+    weighted_values.reserve(retained_count_);
+    for (int h = 0; h < level_count_; ++h) {
+      for (const T& value : levels_[h]) {
+        weighted_values.emplace_back(value, int64_t{1} << h);
+      }
+    }
+    std::sort(weighted_values.begin(), weighted_values.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    // The total weight of the stored values is always equal to count().
+    int64_t cumulative_weight = 0;
+    for (const auto& [value, weight] : weighted_values) {
+      cumulative_weight += weight;
+      if (cumulative_weight > rank) {
+        return value;
+      }
+    }
+    return weighted_values.back().first;
+  }
+
+ private:
+  // Max number of values on the level `h`. Lower levels have exponentially
+  // smaller capacities, so most of the values are on the top levels.
+  int64_t Capacity(int h) const {
+    static constexpr double kCapacityDecay = 2.0 / 3.0;
+    int depth = level_count_ - h - 1;
+    return std::max<int64_t>(
+        2, static_cast<int64_t>(std::ceil(k_ * std::pow(kCapacityDecay,
+                                                        depth))) + 1);
+  }
+
+  void AddLevel() {
+    ++level_count_;
+    if (static_cast<int>(levels_.size()) < level_count_) {
+      levels_.emplace_back();
+    }
+    max_retained_count_ = 0;
+    for (int h = 0; h < level_count_; ++h) {
+      max_retained_count_ += Capacity(h);
+    }
+  }
+
+  // Compacts the lowest full levels until the sketch has free capacity.
+  void Compress() {
+    for (int h = 0; h < level_count_; ++h) {
+      if (static_cast<int64_t>(levels_[h].size()) < Capacity(h)) {
+        continue;
+      }
+      if (h + 1 == level_count_) {
+        AddLevel();
+      }
+      std::vector<T>& level = levels_[h];
+      std::vector<T>& next_level = levels_[h + 1];
+      std::sort(level.begin(), level.end());
+      // If the size is odd, the smallest value stays on the level.
+      size_t kept_count = level.size() % 2;
+      size_t moved_count = 0;
+      for (size_t i = kept_count + NextRandomBit(); i < level.size(); i += 2) {
+        next_level.push_back(level[i]);
+        ++moved_count;
+      }
+      retained_count_ -= level.size() - kept_count - moved_count;
+      level.resize(kept_count);
+      if (retained_count_ < max_retained_count_) {
+        break;
+      }
+    }
+  }
+
+  // splitmix64 generator, but only one bit of each output is used.
+  size_t NextRandomBit() {
+    uint64_t z = (random_state_ += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return (z ^ (z >> 31)) & 1;
+  }
+
+  int64_t k_;
+  // levels_.size() can be greater than level_count_ to reuse memory after
+  // Clear().
+  std::vector<std::vector<T>> levels_;
+  int level_count_;
+  int64_t count_;
+  int64_t retained_count_;
+  int64_t max_retained_count_;
+  uint64_t random_state_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_QEXPR_OPERATORS_AGGREGATION_KLL_SKETCH_H_
@@ -0,0 +1,117 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/qexpr/operators/aggregation/kll_sketch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Le;
+
+// Returns a random permutation of [0, n).
+std::vector<int64_t> Shuffled(int64_t n) {
+  std::vector<int64_t> values(n);
+  for (int64_t i = 0; i < n; ++i) {
+    values[i] = i;
+  }
+  std::mt19937_64 rng(42);
+  std::shuffle(values.begin(), values.end(), rng);
+  return values;
+}
+
+// Returns max |ValueAtRank(r) - r| / n over percentiles, assuming that
+// the sketch contains a permutation of [0, n).
+double MaxRankError(const KllSketch<int64_t>& sketch) {
+  const int64_t n = sketch.count();
+  double max_error = 0;
+  for (int64_t percent = 0; percent <= 100; ++percent) {
+    int64_t rank = std::min(n - 1, percent * n / 100);
+    max_error = std::max(
+        max_error,
+        std::abs(static_cast<double>(sketch.ValueAtRank(rank) - rank)) / n);
+  }
+  return max_error;
+}
+
+TEST(KllSketchTest, ExactForSmallInputs) {
+  std::vector<float> values = {5.f, -1.f, 3.f, 3.f, 100.f, 0.5f, -7.f};
+  KllSketch<float> sketch(/*k=*/200);
+  for (float v : values) {
+    sketch.Add(v);
+  }
+  EXPECT_THAT(sketch.count(), Eq(values.size()));
+  EXPECT_THAT(sketch.retained_count(), Eq(values.size()));
+  std::sort(values.begin(), values.end());
+  for (int64_t rank = 0; rank < values.size(); ++rank) {
+    EXPECT_THAT(sketch.ValueAtRank(rank), Eq(values[rank]));
+  }
+}
+
+TEST(KllSketchTest, AccuracyAndMemory) {
+  constexpr int64_t kSize = 1000000;
+  KllSketch<int64_t> sketch(/*k=*/200);
+  for (int64_t v : Shuffled(kSize)) {
+    sketch.Add(v);
+  }
+  EXPECT_THAT(sketch.count(), Eq(kSize));
+  EXPECT_THAT(sketch.retained_count(), Le(1000));
+  EXPECT_THAT(MaxRankError(sketch), Le(0.01));
+}
+
+TEST(KllSketchTest, Merge) {
+  constexpr int64_t kSize = 200000;
+  constexpr int64_t kShardCount = 7;
+  std::vector<KllSketch<int64_t>> shards(kShardCount,
+                                         KllSketch<int64_t>(/*k=*/200));
+  std::vector<int64_t> values = Shuffled(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    shards[i % kShardCount].Add(values[i]);
+  }
+  KllSketch<int64_t> merged(/*k=*/200);
+  for (const auto& shard : shards) {
+    merged.Merge(shard);
+  }
+  EXPECT_THAT(merged.count(), Eq(kSize));
+  EXPECT_THAT(merged.retained_count(), Le(1000));
+  EXPECT_THAT(MaxRankError(merged), Le(0.01));
+}
+
+TEST(KllSketchTest, ClearAndDeterminism) {
+  KllSketch<int64_t> sketch(/*k=*/16);
+  std::vector<int64_t> values = Shuffled(10000);
+  for (int64_t v : values) {
+    sketch.Add(v);
+  }
+  int64_t median = sketch.ValueAtRank(5000);
+  sketch.Clear();
+  EXPECT_THAT(sketch.count(), Eq(0));
+  EXPECT_THAT(sketch.retained_count(), Eq(0));
+  for (int64_t v : values) {
+    sketch.Add(v);
+  }
+  EXPECT_THAT(sketch.ValueAtRank(5000), Eq(median));
+}
+
+}  // namespace
+}  // namespace arolla
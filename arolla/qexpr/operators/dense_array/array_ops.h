@@ -31,6 +31,7 @@
 #include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/ops/dense_ops.h"
+#include "arolla/dense_array/ops/integer_group_by.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
@@ -213,6 +214,9 @@ struct DenseArrayUniqueOp {
   template <typename T>
   DenseArray<T> operator()(EvaluationContext* ctx,
                            const DenseArray<T>& input) const {
+    if constexpr (kIsIntegerGroupByKey<T>) {
+      return IntegerUnique(input, &ctx->buffer_factory());
+    }
     typename Buffer<T>::Builder bldr(input.size(), &ctx->buffer_factory());
     auto inserter = bldr.GetInserter();
     absl::flat_hash_set<view_type_t<T>> unique_values;
@@ -35,6 +35,7 @@
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/edge.h"
 #include "arolla/dense_array/ops/dense_group_ops.h"
+#include "arolla/dense_array/ops/integer_group_by.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/buffer.h"
 #include "arolla/memory/optional_value.h"
@@ -312,6 +313,13 @@ struct DenseArrayGroupByOp {
                                             const DenseArray<T>& series,
                                             const Edge& over) const {
     int64_t group_counter = 0;
+    if constexpr (kIsIntegerGroupByKey<T>) {
+      ASSIGN_OR_RETURN(DenseArray<int64_t> mapping,
+                       IntegerGroupBy(series, over, group_counter,
+                                      &ctx->buffer_factory()));
+      return DenseArrayEdge::UnsafeFromMapping(std::move(mapping),
+                                               group_counter);
+    }
     DenseGroupOps<GroupByAccumulator<T>> op(
         &ctx->buffer_factory(), GroupByAccumulator<T>(&group_counter));
     ASSIGN_OR_RETURN(DenseArray<int64_t> mapping, op.Apply(over, series));
@@ -51,7 +51,8 @@ class DenseArrayGroupLifter<Accumulator, meta::type_list<GroupTs...>,
     auto accumulator =
         CreateAccumulator<Accumulator>(ctx->options(), init_args...);
     DenseGroupOps<Accumulator> agg(&ctx->buffer_factory(),
-                                   std::move(accumulator));
+                                   std::move(accumulator),
+                                   {.threading = ctx->options().threading});
     return agg.Apply(edge, g_args..., d_args...);
   }
 };
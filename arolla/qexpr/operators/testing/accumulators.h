@@ -29,6 +29,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "arolla/memory/optional_value.h"
 #include "arolla/qexpr/aggregation_ops_interface.h"
 #include "arolla/util/meta.h"
@@ -50,6 +51,42 @@ class AggSumAccumulator final
   OptionalValue<T> accumulator_;
 };
 
+// Same as AggSumAccumulator, but also supports range additions (see
+// aggregation_ops_interface.h). Counts the values added one by one in
+// `*single_add_count`.
+template <typename T>
+class AggSumRangeAccumulator final
+    : public Accumulator<AccumulatorType::kAggregator, OptionalValue<T>,
+                         meta::type_list<>, meta::type_list<T>> {
+ public:
+  explicit AggSumRangeAccumulator(int64_t* single_add_count)
+      : single_add_count_(single_add_count) {}
+
+  void Reset() final { accumulator_ = {false, 0}; }
+  void Add(T value) final {
+    accumulator_ = accumulator_.value + value;
+    ++*single_add_count_;
+  }
+  void AddRange(absl::Span<const T> values) {
+    for (T value : values) {
+      accumulator_ = accumulator_.value + value;
+    }
+  }
+  void AddMaskedRange(absl::Span<const T> values, uint32_t mask) {
+    CHECK_LE(values.size(), 32);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if ((mask >> i) & 1) {
+        accumulator_ = accumulator_.value + values[i];
+      }
+    }
+  }
+  OptionalValue<T> GetResult() final { return accumulator_; }
+
+ private:
+  OptionalValue<T> accumulator_;
+  int64_t* single_add_count_;
+};
+
 // A simple accumulator with default value for empty groups.
 template <typename T>
 class AggCountAccumulator final
@@ -27,6 +27,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -69,6 +70,17 @@ class BatchToFramesCopier {
   // output_buffers.
   virtual void CopyNextBatch(absl::Span<FramePtr> output_buffers) = 0;
 
+  // Returns true if CopyBatchAt is supported.
+  virtual bool SupportsCopyBatchAt() const { return false; }
+
+  // Same as CopyNextBatch, but reads the values starting from `row_id` and
+  // doesn't change the state of the copier, so can be called concurrently.
+  // Should be called only after Start() and if SupportsCopyBatchAt().
+  virtual void CopyBatchAt(int64_t row_id,
+                           absl::Span<FramePtr> output_buffers) const {
+    LOG(FATAL) << "CopyBatchAt is not supported";
+  }
+
  protected:
   absl::Status SetRowCount(int64_t row_count) {
     if (!row_count_.has_value()) {
@@ -109,6 +121,26 @@ class BatchFromFramesCopier {
   virtual absl::Status CopyNextBatch(
       absl::Span<const ConstFramePtr> input_buffers) = 0;
 
+  // Row ranges passed to concurrent CopyBatchAt calls must be aligned to this
+  // number of rows, so that the ranges don't share words of the output
+  // bitmaps.
+  static constexpr int64_t kCopyBatchAtRowAlignment = 64;
+
+  // Returns true if CopyBatchAt is supported.
+  virtual bool SupportsCopyBatchAt() const { return false; }
+
+  // Same as CopyNextBatch, but stores the values to the rows starting from
+  // `row_id`. Can be called concurrently from several threads if each of them
+  // processes its own row range, starting at a multiple of
+  // kCopyBatchAtRowAlignment and ending at such a multiple or at the end of
+  // the arrays, in the order of increasing `row_id`. Should be called only
+  // after Start(row_count) and if SupportsCopyBatchAt(). Must not be mixed
+  // with CopyNextBatch.
+  virtual void CopyBatchAt(int64_t row_id,
+                           absl::Span<const ConstFramePtr> input_buffers) {
+    LOG(FATAL) << "CopyBatchAt is not supported";
+  }
+
   // Creates output arrays and stores it to the given frame.
   // Can be called only once after the last CopyNextBatch.
   virtual absl::Status Finalize(FramePtr arrays_frame) = 0;
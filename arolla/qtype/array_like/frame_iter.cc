@@ -166,6 +166,15 @@ FrameIterator::FrameIterator(
   }
   for (auto& copier : input_copiers_) copier->Start();
   for (auto& copier : output_copiers_) copier->Start(row_count);
+  supports_copy_batch_at_ =
+      std::all_of(input_copiers_.begin(), input_copiers_.end(),
+                  [](const auto& copier) {
+                    return copier->SupportsCopyBatchAt();
+                  }) &&
+      std::all_of(output_copiers_.begin(), output_copiers_.end(),
+                  [](const auto& copier) {
+                    return copier->SupportsCopyBatchAt();
+                  });
 }
 
 FrameIterator::~FrameIterator() {
@@ -197,4 +206,18 @@ void FrameIterator::SaveOutputsOfProcessedFrames(size_t frames_count) {
   }
 }
 
+void FrameIterator::PreloadFramesAt(int64_t row_id,
+                                    absl::Span<FramePtr> frames) {
+  for (const auto& copier : input_copiers_) {
+    copier->CopyBatchAt(row_id, frames);
+  }
+}
+
+void FrameIterator::SaveOutputsAt(int64_t row_id,
+                                  absl::Span<const ConstFramePtr> frames) {
+  for (const auto& copier : output_copiers_) {
+    copier->CopyBatchAt(row_id, frames);
+  }
+}
+
 }  // namespace arolla
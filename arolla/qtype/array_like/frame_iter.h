@@ -16,6 +16,7 @@
 #define AROLLA_QTYPE_ARRAY_LIKE_FRAME_ITER_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -109,10 +110,114 @@ class FrameIterator {
     }
   }
 
+  // The same as ForEachFrame(fn), but applies `fn` to spans of frames
+  // (absl::Span<const FramePtr>). Useful for evaluators that can process
+  // several rows at once.
+  template <typename Fn>
+  void ForEachFrameBatch(Fn&& fn) {
+    for (int64_t offset = 0; offset < row_count_; offset += frames_.size()) {
+      int64_t count = std::min<int64_t>(frames_.size(), row_count_ - offset);
+      PreloadFrames(count);
+      fn(absl::Span<const FramePtr>(frames_.data(), count));
+      SaveOutputsOfProcessedFrames(count);
+    }
+  }
+
   // The same as ForEachFrame(fn), but can use several threads.
   template <typename Fn>
   void ForEachFrame(Fn&& fn, ThreadingInterface& threading, int thread_count) {
     DCHECK_GE(thread_count, 1);
+    if (supports_copy_batch_at_) {
+      ForEachFrameWithoutBarriers(fn, threading, thread_count);
+    } else {
+      ForEachFrameWithBarriers(fn, threading, thread_count);
+    }
+  }
+
+  // Stores output arrays to given frame. Can be called only once after the last
+  // iteration. Can be skipped if there is no output arrays.
+  absl::Status StoreOutput(FramePtr output_frame);
+
+ private:
+  void* GetAllocByIndex(size_t index) {
+    return buffer_.data() + index * dense_scalar_layout_size_;
+  }
+
+  void PreloadFrames(size_t frames_count);
+  void SaveOutputsOfProcessedFrames(size_t frames_count);
+  // Same as above, but for the rows starting from `row_id`. Don't change
+  // the state of the iterator, so can be called concurrently (see
+  // BatchFromFramesCopier::CopyBatchAt for the requirements).
+  void PreloadFramesAt(int64_t row_id, absl::Span<FramePtr> frames);
+  void SaveOutputsAt(int64_t row_id, absl::Span<const ConstFramePtr> frames);
+
+  // Multi-threaded ForEachFrame for the copiers that support CopyBatchAt.
+  // Every thread owns a part of the buffer of frames, and processes blocks of
+  // rows independently of the other threads: copies the inputs of the block
+  // into its own frames and stores the outputs directly into the block's
+  // range of the output arrays. The blocks are distributed dynamically, so
+  // a slow thread doesn't stall the others.
+  template <typename Fn>
+  void ForEachFrameWithoutBarriers(Fn& fn, ThreadingInterface& threading,
+                                   int thread_count) {
+    thread_count = std::min<int64_t>(thread_count, frames_.size());
+    if (thread_count <= 1) {
+      ForEachFrame(fn);
+      return;
+    }
+    const int64_t frames_per_worker = frames_.size() / thread_count;
+    // Aligned blocks guarantee that different threads never write to the same
+    // words of the output bitmaps.
+    constexpr int64_t kAlignment =
+        BatchFromFramesCopier::kCopyBatchAtRowAlignment;
+    const int64_t block_size =
+        (frames_per_worker + kAlignment - 1) / kAlignment * kAlignment;
+    std::atomic<int64_t> next_block_start = 0;
+
+    auto worker_fn = [&](int worker_id) {
+      const int64_t first_frame = worker_id * frames_per_worker;
+      absl::Span<FramePtr> frames(frames_.data() + first_frame,
+                                  frames_per_worker);
+      absl::Span<const ConstFramePtr> const_frames(
+          const_frames_.data() + first_frame, frames_per_worker);
+      while (true) {
+        int64_t block_start =
+            next_block_start.fetch_add(block_size, std::memory_order_relaxed);
+        if (block_start >= row_count_) {
+          return;
+        }
+        int64_t block_end = std::min(row_count_, block_start + block_size);
+        for (int64_t offset = block_start; offset < block_end;
+             offset += frames_per_worker) {
+          int64_t count = std::min(frames_per_worker, block_end - offset);
+          PreloadFramesAt(offset, frames.subspan(0, count));
+          for (int64_t i = 0; i < count; ++i) {
+            fn(frames[i]);
+          }
+          SaveOutputsAt(offset, const_frames.subspan(0, count));
+        }
+      }
+    };
+
+    threading.WithThreading([&] {
+      std::vector<std::function<void()>> join_fns;
+      join_fns.reserve(thread_count - 1);
+      for (int i = 1; i < thread_count; ++i) {
+        join_fns.push_back(
+            threading.StartThread([&worker_fn, i] { worker_fn(i); }));
+      }
+      worker_fn(0);
+      for (auto& join : join_fns) join();
+    });
+  }
+
+  // Multi-threaded ForEachFrame for the copiers that don't support
+  // CopyBatchAt: the buffer of frames is split between the threads, and
+  // the threads are synchronized for copying every batch of inputs and
+  // outputs.
+  template <typename Fn>
+  void ForEachFrameWithBarriers(Fn& fn, ThreadingInterface& threading,
+                                int thread_count) {
     const int frames_per_worker =
         (frames_.size() + thread_count - 1) / thread_count;
 
@@ -155,17 +260,6 @@ class FrameIterator {
     });
   }
 
-  // Stores output arrays to given frame. Can be called only once after the last
-  // iteration. Can be skipped if there is no output arrays.
-  absl::Status StoreOutput(FramePtr output_frame);
-
- private:
-  void* GetAllocByIndex(size_t index) {
-    return buffer_.data() + index * dense_scalar_layout_size_;
-  }
-
-  void PreloadFrames(size_t frames_count);
-  void SaveOutputsOfProcessedFrames(size_t frames_count);
 
   FrameIterator(
       std::vector<std::unique_ptr<BatchToFramesCopier>>&& input_copiers,
@@ -185,6 +279,8 @@ class FrameIterator {
   std::vector<char> buffer_;
   const FrameLayout* scalar_layout_;
   size_t dense_scalar_layout_size_;
+  // True if all the copiers support CopyBatchAt.
+  bool supports_copy_batch_at_;
 };
 
 }  // namespace arolla
@@ -23,6 +23,8 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
 #include "arolla/memory/frame.h"
@@ -30,6 +32,7 @@
 #include "arolla/memory/optional_value.h"
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
+#include "arolla/util/text.h"
 #include "arolla/util/threading.h"
 
 namespace arolla {
@@ -112,6 +115,19 @@ TEST(FrameIterator, Iterate) {
     check_output_fn(frame_iterator);
   }
 
+  {  // by batches
+    ASSERT_OK_AND_ASSIGN(
+        auto frame_iterator,
+        FrameIterator::Create(input_refs, scalar_slots, output_slots,
+                              scalar_slots, &scalar_layout,
+                              {.frame_buffer_count = 3}));
+    frame_iterator.ForEachFrameBatch([&](absl::Span<const FramePtr> frames) {
+      EXPECT_LE(frames.size(), 3);
+      for (FramePtr frame : frames) scalar_processing_fn(frame);
+    });
+    check_output_fn(frame_iterator);
+  }
+
   // with multithreading
   StdThreading threading(4);
   for (int threads = 1; threads <= 4; ++threads) {
@@ -125,6 +141,79 @@ TEST(FrameIterator, Iterate) {
   }
 }
 
+TEST(FrameIterator, MultithreadingWithManyRows) {
+  constexpr int64_t kRowCount = 1000;
+  FrameLayout::Builder scalar_bldr;
+  auto scalar_i_slot = scalar_bldr.AddSlot<OptionalValue<int64_t>>();
+  auto scalar_t_slot = scalar_bldr.AddSlot<OptionalValue<Text>>();
+  auto scalar_layout = std::move(scalar_bldr).Build();
+
+  std::vector<OptionalValue<int64_t>> values(kRowCount);
+  for (int64_t i = 0; i < kRowCount; ++i) {
+    if (i % 3 != 0) values[i] = i;
+  }
+  DenseArray<int64_t> arr_i = CreateDenseArray<int64_t>(values);
+
+  FrameLayout::Builder arrays_bldr;
+  auto arr_output_i = arrays_bldr.AddSlot<DenseArray<int64_t>>();
+  auto arr_output_t = arrays_bldr.AddSlot<DenseArray<Text>>();
+  auto output_arrays_layout = std::move(arrays_bldr).Build();
+
+  auto scalar_processing_fn = [&](FramePtr frame) {
+    OptionalValue<int64_t> i = frame.Get(scalar_i_slot);
+    if (i.present) {
+      frame.Set(scalar_i_slot, i.value * 2);
+      frame.Set(scalar_t_slot, Text(absl::StrCat(i.value)));
+    } else {
+      frame.Set(scalar_t_slot, OptionalValue<Text>());
+    }
+  };
+
+  StdThreading threading(4);
+  // The integer-only output can be stored concurrently by the threads, while
+  // the text output requires synchronization.
+  for (bool with_text_output : {false, true}) {
+    std::vector<TypedSlot> output_scalar_slots = {
+        TypedSlot::FromSlot(scalar_i_slot)};
+    std::vector<TypedSlot> output_array_slots = {
+        TypedSlot::FromSlot(arr_output_i)};
+    if (with_text_output) {
+      output_scalar_slots.push_back(TypedSlot::FromSlot(scalar_t_slot));
+      output_array_slots.push_back(TypedSlot::FromSlot(arr_output_t));
+    }
+    for (int64_t frame_buffer_count : {1, 7, 64, 100}) {
+      for (int threads = 1; threads <= 4; ++threads) {
+        ASSERT_OK_AND_ASSIGN(
+            auto frame_iterator,
+            FrameIterator::Create(
+                {TypedRef::FromValue(arr_i)},
+                {TypedSlot::FromSlot(scalar_i_slot)}, output_array_slots,
+                output_scalar_slots, &scalar_layout,
+                {.frame_buffer_count = frame_buffer_count}));
+        frame_iterator.ForEachFrame(scalar_processing_fn, threading, threads);
+        MemoryAllocation alloc(&output_arrays_layout);
+        FramePtr output_frame = alloc.frame();
+        ASSERT_OK(frame_iterator.StoreOutput(output_frame));
+
+        const DenseArray<int64_t>& res_i = output_frame.Get(arr_output_i);
+        const DenseArray<Text>& res_t = output_frame.Get(arr_output_t);
+        ASSERT_EQ(res_i.size(), kRowCount);
+        ASSERT_EQ(res_t.size(), with_text_output ? kRowCount : 0);
+        for (int64_t i = 0; i < kRowCount; ++i) {
+          if (i % 3 == 0) {
+            EXPECT_FALSE(res_i[i].present) << i;
+          } else {
+            EXPECT_EQ(res_i[i], i * 2) << i;
+            if (with_text_output) {
+              EXPECT_EQ(res_t[i].value, absl::StrCat(i)) << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(FrameIterator, EmptyArrays) {
   FrameLayout::Builder scalar_bldr;
   auto scalar_slot = scalar_bldr.AddSlot<OptionalValue<float>>();
@@ -0,0 +1,149 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serving/async_executor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/threading.h"
+
+namespace arolla {
+
+AsyncExecutor::AsyncExecutor(ThreadingInterface& threading,
+                             AsyncExecutorOptions options)
+    : max_queue_size_(options.max_queue_size) {
+  int thread_count = options.thread_count > 0
+                         ? options.thread_count
+                         : threading.GetRecommendedThreadCount();
+  if (thread_count < 1) {
+    thread_count = 1;
+  }
+  join_fns_.reserve(thread_count);
+  for (int i = 0; i < thread_count; ++i) {
+    join_fns_.push_back(threading.StartThread([this] { WorkerLoop(); }));
+  }
+  timer_join_fn_ = threading.StartThread([this] { TimerLoop(); });
+}
+
+AsyncExecutor::~AsyncExecutor() {
+  {
+    absl::MutexLock lock(mutex_);
+    shutting_down_ = true;
+  }
+  for (auto& join_fn : join_fns_) {
+    join_fn();
+  }
+  {
+    absl::MutexLock lock(timer_mutex_);
+    timer_shutting_down_ = true;
+  }
+  timer_join_fn_();
+}
+
+absl::Status AsyncExecutor::Schedule(Task task) {
+  absl::MutexLock lock(mutex_);
+  if (shutting_down_) {
+    return absl::FailedPreconditionError("AsyncExecutor is shutting down");
+  }
+  if (max_queue_size_ != 0 && queue_.size() >= max_queue_size_) {
+    return absl::ResourceExhaustedError(absl::StrCat(
+        "AsyncExecutor queue is full (max_queue_size=", max_queue_size_, ")"));
+  }
+  queue_.push_back(std::move(task));
+  return absl::OkStatus();
+}
+
+size_t AsyncExecutor::queue_size() const {
+  absl::MutexLock lock(mutex_);
+  return queue_.size();
+}
+
+AsyncExecutor::DeadlineRegistration AsyncExecutor::CancelAtDeadline(
+    CancellationContextPtr cancellation_context, absl::Time deadline) {
+  absl::MutexLock lock(timer_mutex_);
+  std::pair<absl::Time, int64_t> key(deadline, next_deadline_id_++);
+  deadlines_.emplace(key, std::move(cancellation_context));
+  return DeadlineRegistration(this, key);
+}
+
+AsyncExecutor::DeadlineRegistration::~DeadlineRegistration() {
+  if (executor_ != nullptr) {
+    absl::MutexLock lock(executor_->timer_mutex_);
+    executor_->deadlines_.erase(key_);
+  }
+}
+
+void AsyncExecutor::TimerLoop() {
+  std::vector<CancellationContextPtr> expired;
+  while (true) {
+    {
+      absl::MutexLock lock(timer_mutex_);
+      const auto first_deadline = [this]()
+          ABSL_EXCLUSIVE_LOCKS_REQUIRED(timer_mutex_) {
+            return deadlines_.empty() ? absl::InfiniteFuture()
+                                      : deadlines_.begin()->first.first;
+          };
+      const absl::Time wait_until = first_deadline();
+      // Wake up earlier if a new deadline precedes the awaited one.
+      auto has_work = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(timer_mutex_) {
+        return timer_shutting_down_ || first_deadline() < wait_until;
+      };
+      timer_mutex_.AwaitWithDeadline(absl::Condition(&has_work), wait_until);
+      if (timer_shutting_down_) {
+        return;
+      }
+      const absl::Time now = absl::Now();
+      while (!deadlines_.empty() && deadlines_.begin()->first.first <= now) {
+        expired.push_back(std::move(deadlines_.begin()->second));
+        deadlines_.erase(deadlines_.begin());
+      }
+    }
+    // Cancel outside of the lock, because it runs the subscribed callbacks.
+    for (const auto& cancellation_context : expired) {
+      cancellation_context->Cancel(
+          absl::DeadlineExceededError("deadline exceeded"));
+    }
+    expired.clear();
+  }
+}
+
+void AsyncExecutor::WorkerLoop() {
+  auto has_work = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !queue_.empty() || shutting_down_;
+  };
+  while (true) {
+    Task task;
+    {
+      absl::MutexLock lock(mutex_);
+      mutex_.Await(absl::Condition(&has_work));
+      if (queue_.empty()) {
+        return;  // Shutting down and all the tasks are done.
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    std::move(task)();
+  }
+}
+
+}  // namespace arolla
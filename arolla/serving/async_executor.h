@@ -0,0 +1,128 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERVING_ASYNC_EXECUTOR_H_
+#define AROLLA_SERVING_ASYNC_EXECUTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/threading.h"
+
+namespace arolla {
+
+struct AsyncExecutorOptions {
+  // Number of worker threads. 0 means
+  // ThreadingInterface::GetRecommendedThreadCount().
+  int thread_count = 0;
+
+  // Max number of tasks waiting in the queue, Schedule fails if it is
+  // reached. 0 means no limit.
+  size_t max_queue_size = 0;
+};
+
+// A fixed set of worker threads, started via ThreadingInterface, that run
+// tasks from a shared FIFO queue. Used by ExprCompiler::CompileAsync, so that
+// an event-loop based server can evaluate models without blocking its own
+// threads and with a bounded number of evaluation threads. An additional timer
+// thread cancels the contexts registered with CancelAtDeadline.
+//
+// All methods are thread-safe.
+class AsyncExecutor {
+ public:
+  using Task = absl::AnyInvocable<void() &&>;
+
+  // Unregisters the deadline on destruction, see CancelAtDeadline.
+  class [[nodiscard]] DeadlineRegistration {
+   public:
+    DeadlineRegistration(DeadlineRegistration&& other) noexcept
+        : executor_(std::exchange(other.executor_, nullptr)),
+          key_(other.key_) {}
+    DeadlineRegistration& operator=(DeadlineRegistration&&) = delete;
+    ~DeadlineRegistration();
+
+   private:
+    friend class AsyncExecutor;
+    DeadlineRegistration(AsyncExecutor* executor,
+                         std::pair<absl::Time, int64_t> key)
+        : executor_(executor), key_(key) {}
+
+    AsyncExecutor* executor_;
+    std::pair<absl::Time, int64_t> key_;
+  };
+
+  // Starts the worker and timer threads. ThreadingInterface::StartThread is
+  // called directly (not within WithThreading), `threading` must support that
+  // and must outlive the executor.
+  explicit AsyncExecutor(ThreadingInterface& threading,
+                         AsyncExecutorOptions options = {});
+
+  // Runs all the scheduled tasks and joins the worker threads. Must not be
+  // called from a task.
+  ~AsyncExecutor();
+
+  AsyncExecutor(const AsyncExecutor&) = delete;
+  AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+  // Schedules the task for execution on one of the worker threads. Returns
+  // ResourceExhaustedError if the queue is full (or FailedPreconditionError if
+  // the executor is being destroyed), in this case the task is destroyed
+  // without being run.
+  absl::Status Schedule(Task task);
+
+  // Number of the worker threads.
+  int thread_count() const { return static_cast<int>(join_fns_.size()); }
+
+  // Number of tasks waiting in the queue.
+  size_t queue_size() const;
+
+  // Cancels the context with DeadlineExceededError when the deadline passes,
+  // unless the returned registration is destroyed before that. The context is
+  // cancelled on the timer thread, so a running task observes it at its next
+  // cancellation check.
+  DeadlineRegistration CancelAtDeadline(
+      CancellationContextPtr cancellation_context, absl::Time deadline);
+
+ private:
+  void WorkerLoop();
+  void TimerLoop();
+
+  const size_t max_queue_size_;
+  mutable absl::Mutex mutex_;
+  std::deque<Task> queue_ ABSL_GUARDED_BY(mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<ThreadingInterface::JoinFn> join_fns_;
+
+  absl::Mutex timer_mutex_;
+  // Registered deadlines, keyed by (deadline, registration id).
+  absl::btree_map<std::pair<absl::Time, int64_t>, CancellationContextPtr>
+      deadlines_ ABSL_GUARDED_BY(timer_mutex_);
+  int64_t next_deadline_id_ ABSL_GUARDED_BY(timer_mutex_) = 0;
+  bool timer_shutting_down_ ABSL_GUARDED_BY(timer_mutex_) = false;
+  ThreadingInterface::JoinFn timer_join_fn_;
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_SERVING_ASYNC_EXECUTOR_H_
@@ -0,0 +1,115 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serving/async_executor.h"
+
+#include <atomic>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/threading.h"
+
+namespace arolla {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::HasSubstr;
+
+TEST(AsyncExecutorTest, RunsAllTasks) {
+  constexpr int kTaskCount = 1000;
+  std::atomic<int> counter = 0;
+  absl::Mutex mutex;
+  absl::flat_hash_set<std::thread::id> thread_ids;
+  {
+    StdThreading threading(4);
+    AsyncExecutor executor(threading);
+    EXPECT_THAT(executor.thread_count(), Eq(4));
+    for (int i = 0; i < kTaskCount; ++i) {
+      ASSERT_OK(executor.Schedule([&] {
+        counter.fetch_add(1);
+        absl::MutexLock lock(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+      }));
+    }
+    // The destructor waits for the scheduled tasks.
+  }
+  EXPECT_THAT(counter.load(), Eq(kTaskCount));
+  EXPECT_THAT(thread_ids.size(), Gt(0));
+  EXPECT_FALSE(thread_ids.contains(std::this_thread::get_id()));
+}
+
+TEST(AsyncExecutorTest, MaxQueueSize) {
+  std::atomic<int> counter = 0;
+  absl::Notification started;
+  absl::Notification unblock;
+  StdThreading threading(1);
+  AsyncExecutor executor(threading, {.max_queue_size = 2});
+  ASSERT_OK(executor.Schedule([&] {
+    started.Notify();
+    unblock.WaitForNotification();
+  }));
+  started.WaitForNotification();
+
+  ASSERT_OK(executor.Schedule([&] { counter.fetch_add(1); }));
+  ASSERT_OK(executor.Schedule([&] { counter.fetch_add(1); }));
+  EXPECT_THAT(executor.queue_size(), Eq(2));
+  EXPECT_THAT(executor.Schedule([&] { counter.fetch_add(100); }),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("queue is full (max_queue_size=2)")));
+
+  unblock.Notify();
+  while (executor.queue_size() != 0) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  ASSERT_OK(executor.Schedule([&] { counter.fetch_add(1); }));
+}
+
+TEST(AsyncExecutorTest, CancelAtDeadline) {
+  StdThreading threading(1);
+  AsyncExecutor executor(threading);
+  auto late_context = CancellationContext::Make();
+  auto late_registration = executor.CancelAtDeadline(
+      late_context, absl::Now() + absl::Hours(1));
+  // The timer wakes up earlier for a new deadline.
+  auto context = CancellationContext::Make();
+  auto registration =
+      executor.CancelAtDeadline(context, absl::Now() + absl::Milliseconds(10));
+  auto unregistered_context = CancellationContext::Make();
+  {
+    auto unregistered = executor.CancelAtDeadline(
+        unregistered_context, absl::Now() + absl::Milliseconds(10));
+  }
+  while (!context->Cancelled()) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_THAT(context->GetStatus(),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_FALSE(unregistered_context->Cancelled());
+  EXPECT_FALSE(late_context->Cancelled());
+}
+
+}  // namespace
+}  // namespace arolla
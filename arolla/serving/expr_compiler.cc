@@ -18,10 +18,15 @@
 
 #include "absl/base/no_destructor.h"
 #include "arolla/expr/optimization/optimizer.h"
+#include "arolla/util/fingerprint.h"
 
 namespace arolla::serving_impl {
 
 absl::NoDestructor<std::optional<expr::Optimizer>>
     ExprCompilerDefaultOptimizer::optimizer_;
 
+Fingerprint ExprCompilerDefaultOptimizer::fingerprint() {
+  return FingerprintHasher("::arolla::serving_impl::DefaultOptimizer").Finish();
+}
+
 }  // namespace arolla::serving_impl
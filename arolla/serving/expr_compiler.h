@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>  // NOLINT(build/c++11)
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,10 +29,13 @@
 
 #include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/model_executor.h"
@@ -48,6 +52,9 @@
 #include "arolla/qexpr/evaluation_engine.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_ref.h"
+#include "arolla/serving/async_executor.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/fingerprint.h"
 
 namespace arolla {
 
@@ -60,8 +67,65 @@ struct ExprCompilerFlags {
   static constexpr int kEvalWithOptions = 1;
 };
 
+// Options of a single evaluation of a model compiled by
+// ExprCompiler::CompileAsync.
+struct AsyncEvaluationOptions {
+  // If the context is cancelled before the evaluation starts, the evaluation
+  // is skipped. If it is cancelled during the evaluation, the evaluation is
+  // interrupted. In both cases the callback receives the cancellation status.
+  CancellationContextPtr cancellation_context = nullptr;
+
+  // If the evaluation has not started before the deadline (e.g. because all
+  // the worker threads are busy), it is skipped. If the deadline passes during
+  // the evaluation, the evaluation is interrupted at its next cancellation
+  // check. In both cases the callback receives DeadlineExceededError. The
+  // deadline doesn't cancel `cancellation_context` itself.
+  absl::Time deadline = absl::InfiniteFuture();
+
+  EvaluationOptions eval_options;
+};
+
+// Callback that receives the result of an asynchronous model evaluation.
+template <typename Output>
+using AsyncModelCallback = absl::AnyInvocable<void(absl::StatusOr<Output>) &&>;
+
+// Returns a callback for a model compiled by ExprCompiler::CompileAsync
+// together with the future that receives the evaluation result.
+//
+// Usage example:
+//
+//   auto [done, result] = MakeAsyncModelFuture<float>();
+//   model(input, {}, std::move(done));
+//   ...
+//   ASSIGN_OR_RETURN(float value, result.get());
+//
+template <typename Output>
+std::pair<AsyncModelCallback<Output>, std::future<absl::StatusOr<Output>>>
+MakeAsyncModelFuture() {
+  std::promise<absl::StatusOr<Output>> promise;
+  std::future<absl::StatusOr<Output>> future = promise.get_future();
+  AsyncModelCallback<Output> callback =
+      [promise = std::move(promise)](absl::StatusOr<Output> result) mutable {
+        promise.set_value(std::move(result));
+      };
+  return {std::move(callback), std::move(future)};
+}
+
 namespace serving_impl {
 
+template <typename Input, typename Output, typename SideOutput>
+struct ToAsyncModelFunction {
+  using type = std::function<void(const Input&, SideOutput*,
+                                  const AsyncEvaluationOptions&,
+                                  AsyncModelCallback<Output>)>;
+};
+
+template <typename Input, typename Output>
+struct ToAsyncModelFunction<Input, Output, void> {
+  using type = std::function<void(const Input&, const AsyncEvaluationOptions&,
+                                  AsyncModelCallback<Output>)>;
+};
+
 template <typename Input, typename Output, typename SideOutput>
 struct ToModelFunction {
   using without_options =
@@ -84,6 +148,10 @@ class ExprCompilerDefaultOptimizer {
  public:
   static const std::optional<expr::Optimizer>& get() { return *optimizer_; }
 
+  // Identifies the optimizer for the compiled expressions cache. The default
+  // optimizer doesn't change after initialization, so it is a constant.
+  static Fingerprint fingerprint();
+
  private:
   friend class ExprCompilerDefaultOptimizerInitializer;
   static absl::NoDestructor<std::optional<expr::Optimizer>> optimizer_;
@@ -106,6 +174,8 @@ class ExprCompilerBase {
       expr::ThreadSafeCloneWhenBusyModelExecutor<Input, Output, SideOutput>;
   using ThreadSafePoolModelExecutor =
       expr::ThreadSafePoolModelExecutor<Input, Output, SideOutput>;
+  using ThreadSafeShardedPoolModelExecutor =
+      expr::ThreadSafeShardedPoolModelExecutor<Input, Output, SideOutput>;
   using CopyableThreadUnsafeModelExecutor =
       expr::CopyableThreadUnsafeModelExecutor<Input, Output, SideOutput>;
   using ToFunctionHelper =
@@ -122,6 +192,11 @@ class ExprCompilerBase {
   using Function = Func<ExprCompilerFlags::kDefault>;
   using FunctionWithOptions = Func<ExprCompilerFlags::kEvalWithOptions>;
 
+  // std::function that CompileAsync generates. It schedules the evaluation
+  // and returns immediately, the result is passed to the callback.
+  using AsyncFunction = typename serving_impl::ToAsyncModelFunction<
+      Input, Output, SideOutput>::type;
+
   // IO types
   using input_type = Input;
   using output_type = Output;
@@ -136,7 +211,8 @@ class ExprCompilerBase {
     const std::optional<expr::Optimizer>& opt =
         serving_impl::ExprCompilerDefaultOptimizer::get();
     if (opt.has_value()) {
-      SetExprOptimizer(*opt);
+      SetExprOptimizer(
+          *opt, serving_impl::ExprCompilerDefaultOptimizer::fingerprint());
     }
   }
 
@@ -234,6 +310,24 @@ class ExprCompilerBase {
     return std::move(SetPoolThreadSafetyPolicy());
   }
 
+  // Sets "sharded object pool" thread safety policy. Similar to the "object
+  // pool" policy, but the pool is split into lock-free per-thread shards, so
+  // it scales better for a large number of threads. Evaluation contexts that
+  // stay idle are destroyed. See expr::ThreadSafeShardedPoolModelExecutor.
+  //
+  // Use CompileWithStatistics to access the pool statistics of a compiled
+  // model.
+  Subclass& SetShardedPoolThreadSafetyPolicy(
+      expr::ShardedPoolModelExecutorOptions options = {}) & {
+    thread_safety_policy_ = ThreadSafetyPolicy::kShardedPool;
+    sharded_pool_options_ = options;
+    return subclass();
+  }
+  Subclass&& SetShardedPoolThreadSafetyPolicy(
+      expr::ShardedPoolModelExecutorOptions options = {}) && {
+    return std::move(SetShardedPoolThreadSafetyPolicy(options));
+  }
+
   // Sets "unsafe" thread safety policy. If used, the resulting function will be
   // thread-unsafe and potentially expensive (although thread-safe) to copy. But
   // the copies may be executed concurrently from different threads.
@@ -268,20 +362,81 @@ class ExprCompilerBase {
     return std::move(SetExperimentalArenaAllocator(page_size_bytes));
   }
 
+  // Keeps up to `size` frames with initialized literals for reuse in
+  // ExecuteOnHeap. See expr::ModelExecutorOptions::frame_pool_size
+  // documentation for details.
+  Subclass& SetFramePoolSize(size_t size) & {
+    model_executor_options_.frame_pool_size = size;
+    return subclass();
+  }
+  Subclass&& SetFramePoolSize(size_t size) && {
+    return std::move(SetFramePoolSize(size));
+  }
+
+  // Reuses compiled expressions from the process-wide cache, so compiling
+  // the same model again (e.g. on reload) skips the expression compilation.
+  // See expr::ModelExecutorOptions::use_compiled_expr_cache for details. The
+  // cache must be enabled with expr::SetCompiledExprCacheCapacity.
+  Subclass& SetUseCompiledExprCache(bool use_compiled_expr_cache = true) & {
+    model_executor_options_.use_compiled_expr_cache = use_compiled_expr_cache;
+    return subclass();
+  }
+  Subclass&& SetUseCompiledExprCache(bool use_compiled_expr_cache = true) && {
+    return std::move(SetUseCompiledExprCache(use_compiled_expr_cache));
+  }
+
   // Sets Expr optimizer. Overrides the default optimizer, errors will be
   // forwarded to the result of Compile() call.
   //
+  // `fingerprint` must identify the optimizer, it is used by the compiled
+  // expressions cache (see SetUseCompiledExprCache). Without it, the models
+  // are compiled bypassing the cache.
+  //
   // Use this function only if you have custom expr optimizations specific for
   // your project. It is suggested to call DefaultOptimizer() from your custom
   // optimizer anyway.
-  Subclass& SetExprOptimizer(absl::StatusOr<expr::Optimizer> optimizer_or) & {
+  Subclass& SetExprOptimizer(
+      absl::StatusOr<expr::Optimizer> optimizer_or,
+      std::optional<Fingerprint> fingerprint = std::nullopt) & {
     ASSIGN_OR_RETURN(auto optimizer, std::move(optimizer_or),
                      RegisterError(_ << "in ExprCompiler::SetExprOptimizer"));
     model_executor_options_.eval_options.optimizer = std::move(optimizer);
+    optimizer_fingerprint_ = fingerprint;
+    UpdateOptimizerFingerprint();
     return subclass();
   }
-  Subclass&& SetExprOptimizer(absl::StatusOr<expr::Optimizer> optimizer_or) && {
-    return std::move(SetExprOptimizer(std::move(optimizer_or)));
+  Subclass&& SetExprOptimizer(
+      absl::StatusOr<expr::Optimizer> optimizer_or,
+      std::optional<Fingerprint> fingerprint = std::nullopt) && {
+    return std::move(SetExprOptimizer(std::move(optimizer_or), fingerprint));
+  }
+
+  // Sets an optimizer that is applied once to the whole lowered expression,
+  // after the optimizer from SetExprOptimizer. Errors will be forwarded to the
+  // result of Compile() call. See
+  // DynamicEvaluationEngineOptions::global_optimizer for details.
+  //
+  // `fingerprint` has the same meaning as in SetExprOptimizer.
+  //
+  // Example: SetExprGlobalOptimizer(FuseDecisionForestOperators) evaluates
+  // decision forests applied to the same inputs together.
+  Subclass& SetExprGlobalOptimizer(
+      absl::StatusOr<expr::Optimizer> optimizer_or,
+      std::optional<Fingerprint> fingerprint = std::nullopt) & {
+    ASSIGN_OR_RETURN(
+        auto optimizer, std::move(optimizer_or),
+        RegisterError(_ << "in ExprCompiler::SetExprGlobalOptimizer"));
+    model_executor_options_.eval_options.global_optimizer =
+        std::move(optimizer);
+    global_optimizer_fingerprint_ = fingerprint;
+    UpdateOptimizerFingerprint();
+    return subclass();
+  }
+  Subclass&& SetExprGlobalOptimizer(
+      absl::StatusOr<expr::Optimizer> optimizer_or,
+      std::optional<Fingerprint> fingerprint = std::nullopt) && {
+    return std::move(
+        SetExprGlobalOptimizer(std::move(optimizer_or), fingerprint));
   }
 
   // With this option the compiled model will return an error if the evaluation
@@ -357,9 +512,10 @@ class ExprCompilerBase {
 
   // Overrides the default setting for expression optimization.
   //
-  // NOTE: This works in tandem with SetExprOptimizer. Expression optimization
-  // occurs only if an optimizer is available (default provided by the build
-  // target `:expr_compiler_optimizer`) and `enable_expr_optimization` is true
+  // NOTE: This works in tandem with SetExprOptimizer and
+  // SetExprGlobalOptimizer. Expression optimization occurs only if an
+  // optimizer is available (default provided by the build target
+  // `:expr_compiler_optimizer`) and `enable_expr_optimization` is true
   // (default).
   Subclass& EnableExprOptimization(bool enable_expr_optimization) & {
     if (enable_expr_optimization) {
@@ -415,6 +571,42 @@ class ExprCompilerBase {
     return Compile<Flags>(*expr);
   }
 
+  // Compiled model together with its pool statistics, see
+  // CompileWithStatistics.
+  template <int Flags>
+  struct FuncWithStatistics {
+    Func<Flags> function;
+    // Returns the current pool statistics of `function`. Stays valid after
+    // `function` is destroyed.
+    std::function<expr::ModelExecutorPoolStatistics()> statistics;
+  };
+
+  // Same as Compile(model), but also returns a function that returns the pool
+  // statistics of the compiled model. Requires the "sharded object pool"
+  // thread safety policy, see SetShardedPoolThreadSafetyPolicy.
+  template <int Flags = ExprCompilerFlags::kDefault, typename Model>
+  absl::StatusOr<FuncWithStatistics<Flags>> CompileWithStatistics(
+      const Model& model) const {
+    if (thread_safety_policy_ != ThreadSafetyPolicy::kShardedPool) {
+      return absl::FailedPreconditionError(
+          "CompileWithStatistics requires the sharded pool thread safety "
+          "policy, use ExprCompiler::SetShardedPoolThreadSafetyPolicy()");
+    }
+    ASSIGN_OR_RETURN(Func<Flags> function, Compile<Flags>(model));
+    const auto* pool_executor =
+        function.template target<ThreadSafeShardedPoolModelExecutor>();
+    if (pool_executor == nullptr) {
+      return absl::InternalError(
+          "compiled function doesn't use ThreadSafeShardedPoolModelExecutor");
+    }
+    std::function<expr::ModelExecutorPoolStatistics()> statistics =
+        [pool_executor = *pool_executor] {
+          return pool_executor.GetStatistics();
+        };
+    return FuncWithStatistics<Flags>{.function = std::move(function),
+                                     .statistics = std::move(statistics)};
+  }
+
   // Compiles a model represented by ExprOperatorPtr with positional arguments.
   // The Input must be a tuple. InputLoader is generated automatically, so it
   // shouldn't be specified manually. SideOutput is not supported.
@@ -470,6 +662,57 @@ class ExprCompilerBase {
                                thread_safety_policy_);
   }
 
+  // Compiles a model (CompiledExpr or ExprNodePtr) into a function that
+  // evaluates it asynchronously on the `executor` threads, so the calling
+  // thread is never blocked. The callback is called exactly once: on one of
+  // the `executor` threads, or on the calling thread if the evaluation can
+  // not be scheduled (e.g. the queue is full or the cancellation context is
+  // already cancelled).
+  //
+  // The thread safety policy is applied as in Compile, so concurrent
+  // evaluations on different threads reuse the evaluation contexts
+  // accordingly.
+  //
+  // The `input` (and `side_output`) passed to the function must stay alive
+  // until the callback is called. The `executor` must outlive the function
+  // and all its copies.
+  //
+  // Usage example:
+  //
+  //   AsyncExecutor executor(threading, {.thread_count = 4});
+  //   ASSIGN_OR_RETURN(
+  //       auto model,
+  //       (ExprCompiler<MyInput, std::optional<float>>())
+  //           .SetInputLoader(std::move(my_input_loader))
+  //           .CompileAsync(my_expression, executor));
+  //   model(my_input, {.cancellation_context = my_cancellation_context},
+  //         [](absl::StatusOr<std::optional<float>> result) { ... });
+  //
+  template <typename Model>
+  absl::StatusOr<AsyncFunction> CompileAsync(const Model& model,
+                                             AsyncExecutor& executor) const {
+    ASSIGN_OR_RETURN(FunctionWithOptions function,
+                     Compile<ExprCompilerFlags::kEvalWithOptions>(model));
+    auto shared_function =
+        std::make_shared<const FunctionWithOptions>(std::move(function));
+    if constexpr (std::is_same_v<SideOutput, void>) {
+      return [shared_function = std::move(shared_function), &executor](
+                 const Input& input, const AsyncEvaluationOptions& options,
+                 AsyncModelCallback<Output> done) {
+        ScheduleAsync(shared_function, executor, input, nullptr, options,
+                      std::move(done));
+      };
+    } else {
+      return [shared_function = std::move(shared_function), &executor](
+                 const Input& input, SideOutput* side_output,
+                 const AsyncEvaluationOptions& options,
+                 AsyncModelCallback<Output> done) {
+        ScheduleAsync(shared_function, executor, input, side_output, options,
+                      std::move(done));
+      };
+    }
+  }
+
  protected:
   // Registers an error to be reported from the Validate call. Can be used with
   // ASSIGN_OR_RETURN macros.
@@ -492,6 +735,8 @@ class ExprCompilerBase {
     kCloneWhenBusy,
     // Use ThreadSafePoolModelExecutor.
     kPool,
+    // Use ThreadSafeShardedPoolModelExecutor.
+    kShardedPool,
     // Be thread unsafe.
     kUnsafe
   };
@@ -587,11 +832,94 @@ class ExprCompilerBase {
     };
   }
 
+  template <int Flags>
+  Func<Flags> MakeShardedPoolFunction(ModelExecutor&& executor) const {
+    return Func<Flags>(ThreadSafeShardedPoolModelExecutor(
+        std::move(executor), sharded_pool_options_));
+  }
+
+  // State of a scheduled asynchronous evaluation.
+  struct AsyncCall {
+    std::shared_ptr<const FunctionWithOptions> function;
+    AsyncExecutor* executor;
+    const Input* input;
+    SideOutput* side_output;
+    AsyncEvaluationOptions options;
+    AsyncModelCallback<Output> done;
+
+    void Run() && {
+      absl::StatusOr<Output> result;
+      if (options.deadline != absl::InfiniteFuture() &&
+          absl::Now() > options.deadline) {
+        result = absl::DeadlineExceededError(
+            "the model evaluation has not started before the deadline");
+      } else {
+        CancellationContextPtr cancellation_context =
+            std::move(options.cancellation_context);
+        // The deadline cancels a separate context of the evaluation, and the
+        // cancellation of the caller's context is forwarded to it.
+        CancellationContext::Subscription subscription;
+        std::optional<AsyncExecutor::DeadlineRegistration> deadline;
+        if (options.deadline != absl::InfiniteFuture()) {
+          CancellationContextPtr caller_context =
+              std::move(cancellation_context);
+          cancellation_context = CancellationContext::Make();
+          if (caller_context != nullptr) {
+            // The callback is called only from caller_context->Cancel(), so
+            // the raw pointer is valid.
+            subscription = caller_context->Subscribe(
+                [evaluation_context = cancellation_context,
+                 caller = caller_context.get()] {
+                  evaluation_context->Cancel(caller->GetStatus());
+                });
+          }
+          deadline.emplace(executor->CancelAtDeadline(cancellation_context,
+                                                      options.deadline));
+        }
+        CancellationContext::ScopeGuard cancellation_scope(
+            std::move(cancellation_context));
+        if (absl::Status status = CheckCancellation(); !status.ok()) {
+          result = std::move(status);
+        } else if constexpr (std::is_same_v<SideOutput, void>) {
+          result = (*function)(options.eval_options, *input);
+        } else {
+          result = (*function)(options.eval_options, *input, side_output);
+        }
+      }
+      std::move(done)(std::move(result));
+    }
+  };
+
+  static void ScheduleAsync(
+      std::shared_ptr<const FunctionWithOptions> function,
+      AsyncExecutor& executor, const Input& input, SideOutput* side_output,
+      const AsyncEvaluationOptions& options, AsyncModelCallback<Output> done) {
+    if (options.cancellation_context != nullptr &&
+        options.cancellation_context->Cancelled()) {
+      std::move(done)(options.cancellation_context->GetStatus());
+      return;
+    }
+    // The call is shared, so that the callback can be still called if the
+    // executor rejects (and destroys) the task.
+    auto call = std::make_shared<AsyncCall>(
+        AsyncCall{.function = std::move(function),
+                  .executor = &executor,
+                  .input = &input,
+                  .side_output = side_output,
+                  .options = options,
+                  .done = std::move(done)});
+    if (absl::Status status =
+            executor.Schedule([call] { std::move(*call).Run(); });
+        !status.ok()) {
+      std::move(call->done)(std::move(status));
+    }
+  }
+
   // Wraps ModelExecutor into std::function, applying the requested thread
   // safety policy.
   template <bool EvalWithOptions>
-  static absl::StatusOr<Func<EvalWithOptions>> MakeFunction(
-      ModelExecutor&& executor, ThreadSafetyPolicy thread_safety_policy) {
+  absl::StatusOr<Func<EvalWithOptions>> MakeFunction(
+      ModelExecutor&& executor, ThreadSafetyPolicy thread_safety_policy) const {
     switch (thread_safety_policy) {
       case ThreadSafetyPolicy::kAlwaysClone:
         return MakeAlwaysCloneFunction<EvalWithOptions>(std::move(executor));
@@ -602,6 +930,8 @@ class ExprCompilerBase {
       case ThreadSafetyPolicy::kPool:
         return Func<EvalWithOptions>(
             ThreadSafePoolModelExecutor(std::move(executor)));
+      case ThreadSafetyPolicy::kShardedPool:
+        return MakeShardedPoolFunction<EvalWithOptions>(std::move(executor));
       case ThreadSafetyPolicy::kUnsafe:
         return Func<EvalWithOptions>(
             CopyableThreadUnsafeModelExecutor(std::move(executor)));
@@ -629,6 +959,24 @@ class ExprCompilerBase {
     return absl::OkStatus();
   }
 
+  // Sets eval_options.optimizer_fingerprint from the fingerprints of the
+  // optimizers, or resets it if some optimizer has no fingerprint.
+  void UpdateOptimizerFingerprint() {
+    auto& eval_options = model_executor_options_.eval_options;
+    eval_options.optimizer_fingerprint = std::nullopt;
+    if ((eval_options.optimizer.has_value() &&
+         !optimizer_fingerprint_.has_value()) ||
+        (eval_options.global_optimizer.has_value() &&
+         !global_optimizer_fingerprint_.has_value())) {
+      return;
+    }
+    eval_options.optimizer_fingerprint =
+        FingerprintHasher("::arolla::ExprCompiler::Optimizers")
+            .Combine(optimizer_fingerprint_.value_or(Fingerprint{}),
+                     global_optimizer_fingerprint_.value_or(Fingerprint{}))
+            .Finish();
+  }
+
   absl::Status ValidateCompileOperator() const {
     RETURN_IF_ERROR(first_error_);
     static_assert(std::is_same_v<SideOutput, void>,
@@ -647,7 +995,10 @@ class ExprCompilerBase {
   std::unique_ptr<const SlotListener<SideOutput>> slot_listener_ = nullptr;
 
   ThreadSafetyPolicy thread_safety_policy_ = ThreadSafetyPolicy::kUnspecified;
+  expr::ShardedPoolModelExecutorOptions sharded_pool_options_;
   expr::ModelExecutorOptions model_executor_options_;
+  std::optional<Fingerprint> optimizer_fingerprint_;
+  std::optional<Fingerprint> global_optimizer_fingerprint_;
 };
 
 // Compiler for Arolla expressions into std::function.
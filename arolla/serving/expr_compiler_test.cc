@@ -30,7 +30,11 @@
 #include "arolla/util/status_macros_backport.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "arolla/expr/eval/compiled_expr_cache.h"
 #include "arolla/expr/eval/eval.h"
 #include "arolla/expr/eval/thread_safe_model_executor.h"
 #include "arolla/expr/eval/verbose_runtime_error.h"
@@ -54,7 +58,11 @@
 #include "arolla/qtype/typed_ref.h"
 #include "arolla/qtype/typed_slot.h"
 #include "arolla/qtype/typed_value.h"
+#include "arolla/serving/async_executor.h"
+#include "arolla/util/cancellation.h"
+#include "arolla/util/fingerprint.h"
 #include "arolla/util/testing/status_matchers.h"
+#include "arolla/util/threading.h"
 
 namespace {
 
@@ -370,6 +378,55 @@ TEST_F(ExprCompilerTest, Optimizer) {
   EXPECT_THAT(model(input), IsOkAndHolds(-1));
 }
 
+TEST_F(ExprCompilerTest, CompiledExprCache) {
+  expr::SetCompiledExprCacheCapacity(10);
+  expr::ClearCompiledExprCache();
+  // Compiles the model with a new compiler every time, like on model reload.
+  auto compile = [&](auto set_optimizer) {
+    auto compiler = ExprCompiler<TestInput, std::optional<float>>();
+    compiler.SetInputLoader(CreateInputLoader())
+        .SetUseCompiledExprCache()
+        .AllowOutputCasting();
+    set_optimizer(compiler);
+    return compiler.Compile(expr_);
+  };
+  auto keep_default_optimizer = [](auto& compiler) {};
+  TestInput input{.x = 28, .y = 29};
+
+  ASSERT_OK_AND_ASSIGN(auto model, compile(keep_default_optimizer));
+  EXPECT_THAT(model(input), IsOkAndHolds(57));
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().hits, 0);
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().misses, 1);
+  ASSERT_OK_AND_ASSIGN(model, compile(keep_default_optimizer));
+  EXPECT_THAT(model(input), IsOkAndHolds(57));
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().hits, 1);
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().misses, 1);
+
+  auto identity = [](expr::ExprNodePtr x) -> absl::StatusOr<expr::ExprNodePtr> {
+    return x;
+  };
+  // An optimizer without a fingerprint bypasses the cache.
+  ASSERT_OK_AND_ASSIGN(model, compile([&](auto& compiler) {
+                         compiler.SetExprOptimizer(identity);
+                       }));
+  EXPECT_THAT(model(input), IsOkAndHolds(57));
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().hits, 1);
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().misses, 1);
+  // An optimizer with a fingerprint has its own cache entry.
+  auto set_identity = [&](auto& compiler) {
+    compiler.SetExprOptimizer(identity, FingerprintHasher("identity").Finish());
+  };
+  ASSERT_OK_AND_ASSIGN(model, compile(set_identity));
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().hits, 1);
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().misses, 2);
+  ASSERT_OK_AND_ASSIGN(model, compile(set_identity));
+  EXPECT_THAT(model(input), IsOkAndHolds(57));
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().hits, 2);
+  EXPECT_EQ(expr::GetCompiledExprCacheStats().misses, 2);
+
+  expr::SetCompiledExprCacheCapacity(0);
+}
+
 TEST_F(ExprCompilerTest, OtherOptionsSmokeTest) {
   ASSERT_OK_AND_ASSIGN(
       auto model,
@@ -444,6 +501,46 @@ TEST_F(ExprCompilerTest, PoolThreadSafetyPolicy) {
               NotNull());
 }
 
+TEST_F(ExprCompilerTest, ShardedPoolThreadSafetyPolicy) {
+  using Compiler =
+      ExprCompiler<TestInput, std::optional<float>, TestSideOutput>;
+  Compiler compiler;
+  compiler.SetInputLoader(CreateInputLoader())
+      .SetSlotListener(CreateSlotListener())
+      .SetShardedPoolThreadSafetyPolicy({.shard_count = 2})
+      .AllowOutputCasting();
+  ASSERT_OK_AND_ASSIGN(auto compiled, compiler.CompileWithStatistics(expr_));
+  // Statistics of different compilations are independent.
+  ASSERT_OK_AND_ASSIGN(auto other_compiled,
+                       compiler.CompileWithStatistics(expr_));
+  Compiler::Function model = std::move(compiled.function);
+  auto statistics = std::move(compiled.statistics);
+  TestInput input{.x = 28, .y = 29};
+  TestSideOutput side_output;
+  // NOTE: Thread safety is tested in
+  // expr/eval/thread_safe_model_executor_test.cc
+  EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  EXPECT_THAT(side_output.subtract, Eq(-1));
+  EXPECT_THAT(model(input, &side_output), IsOkAndHolds(57));
+  EXPECT_THAT((model.target<expr::ThreadSafeShardedPoolModelExecutor<
+                   TestInput, std::optional<float>, TestSideOutput>>()),
+              NotNull());
+  ASSERT_TRUE(statistics);
+  EXPECT_THAT(statistics().clones, Eq(1));
+  EXPECT_THAT(statistics().hits, Eq(1));
+  EXPECT_THAT(other_compiled.statistics().clones, Eq(0));
+
+  EXPECT_THAT(
+      (Compiler()
+           .SetInputLoader(CreateInputLoader())
+           .SetSlotListener(CreateSlotListener())
+           .SetPoolThreadSafetyPolicy()
+           .AllowOutputCasting()
+           .CompileWithStatistics(expr_)),
+      StatusIs(absl::StatusCode::kFailedPrecondition,
+               HasSubstr("requires the sharded pool thread safety policy")));
+}
+
 TEST_F(ExprCompilerTest, AlwaysCloneThreadSafetyPolicy) {
   ASSERT_OK_AND_ASSIGN(
       auto model,
@@ -491,6 +588,123 @@ TEST_F(ExprCompilerTest, ThreadUnsafe) {
   EXPECT_THAT(side_output.subtract, Eq(-1));
 }
 
+TEST_F(ExprCompilerTest, CompileAsync) {
+  StdThreading threading(2);
+  AsyncExecutor executor(threading);
+  ASSERT_OK_AND_ASSIGN(auto model,
+                       (ExprCompiler<TestInput, std::optional<float>>())
+                           .SetInputLoader(CreateInputLoader())
+                           .AllowOutputCasting()
+                           .CompileAsync(expr_, executor));
+  static_assert(
+      std::is_same_v<decltype(model),
+                     std::function<void(
+                         const TestInput&, const AsyncEvaluationOptions&,
+                         AsyncModelCallback<std::optional<float>>)>>);
+  TestInput input{.x = 28, .y = 29};
+  {
+    auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+    model(input, {}, std::move(done));
+    EXPECT_THAT(result.get(), IsOkAndHolds(57));
+  }
+  {
+    auto cancellation_context = CancellationContext::Make();
+    cancellation_context->Cancel(absl::CancelledError("too late"));
+    auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+    model(input, {.cancellation_context = std::move(cancellation_context)},
+          std::move(done));
+    EXPECT_THAT(result.get(),
+                StatusIs(absl::StatusCode::kCancelled, "too late"));
+  }
+  {
+    auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+    model(input, {.deadline = absl::Now() - absl::Seconds(1)},
+          std::move(done));
+    EXPECT_THAT(result.get(),
+                StatusIs(absl::StatusCode::kDeadlineExceeded,
+                         HasSubstr("has not started before the deadline")));
+  }
+}
+
+TEST_F(ExprCompilerTest, CompileAsyncDeadline) {
+  StdThreading threading(1);
+  AsyncExecutor executor(threading);
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (ExprCompiler<TestInput, std::optional<float>>())
+          .SetInputLoader(::arolla::CreateAccessorsInputLoader<TestInput>(
+              "x",
+              [](const TestInput& input) {
+                // A long evaluation that is interrupted by cancellation.
+                while (!Cancelled()) {
+                  absl::SleepFor(absl::Milliseconds(1));
+                }
+                return input.x;
+              },
+              "y", [](const TestInput& input) { return input.y; }))
+          .AllowOutputCasting()
+          .CompileAsync(expr_, executor));
+  TestInput input{.x = 28, .y = 29};
+  {
+    auto cancellation_context = CancellationContext::Make();
+    auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+    model(input,
+          {.cancellation_context = cancellation_context,
+           .deadline = absl::Now() + absl::Milliseconds(10)},
+          std::move(done));
+    EXPECT_THAT(result.get(), StatusIs(absl::StatusCode::kDeadlineExceeded));
+    // The caller's context is not cancelled by the deadline.
+    EXPECT_FALSE(cancellation_context->Cancelled());
+  }
+  {
+    // Cancellation of the caller's context is still observed.
+    auto cancellation_context = CancellationContext::Make();
+    auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+    model(input,
+          {.cancellation_context = cancellation_context,
+           .deadline = absl::Now() + absl::Hours(1)},
+          std::move(done));
+    cancellation_context->Cancel(absl::CancelledError("stop"));
+    EXPECT_THAT(result.get(), StatusIs(absl::StatusCode::kCancelled, "stop"));
+  }
+}
+
+TEST_F(ExprCompilerTest, CompileAsyncWithSideOutput) {
+  StdThreading threading(1);
+  AsyncExecutor executor(threading, {.max_queue_size = 1});
+  ASSERT_OK_AND_ASSIGN(
+      auto model,
+      (ExprCompiler<TestInput, std::optional<float>, TestSideOutput>())
+          .SetInputLoader(CreateInputLoader())
+          .SetSlotListener(CreateSlotListener())
+          .AllowOutputCasting()
+          .CompileAsync(*compiled_expr_, executor));
+  TestInput input{.x = 28, .y = 29};
+  TestSideOutput side_output;
+  auto [done, result] = MakeAsyncModelFuture<std::optional<float>>();
+  model(input, &side_output, {}, std::move(done));
+  EXPECT_THAT(result.get(), IsOkAndHolds(57));
+  EXPECT_THAT(side_output.subtract, Eq(-1));
+
+  // Block the only worker thread and fill the queue.
+  absl::Notification unblock;
+  ASSERT_OK(executor.Schedule([&unblock] { unblock.WaitForNotification(); }));
+  while (executor.queue_size() != 0) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  auto [queued_done, queued_result] =
+      MakeAsyncModelFuture<std::optional<float>>();
+  model(input, nullptr, {}, std::move(queued_done));
+  auto [rejected_done, rejected_result] =
+      MakeAsyncModelFuture<std::optional<float>>();
+  model(input, nullptr, {}, std::move(rejected_done));
+  EXPECT_THAT(rejected_result.get(),
+              StatusIs(absl::StatusCode::kResourceExhausted,
+                       HasSubstr("queue is full")));
+  unblock.Notify();
+  EXPECT_THAT(queued_result.get(), IsOkAndHolds(57));
+}
+
 TEST_F(ExprCompilerTest, ForceNonOptionalOutput) {
   ASSERT_OK_AND_ASSIGN(auto expr, CallOp("math.neg", {Leaf("x")}));
   ASSERT_OK_AND_ASSIGN(
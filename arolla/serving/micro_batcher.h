@@ -0,0 +1,227 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef AROLLA_SERVING_MICRO_BATCHER_H_
+#define AROLLA_SERVING_MICRO_BATCHER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "arolla/expr/eval/model_executor.h"
+#include "arolla/util/cancellation.h"
+
+namespace arolla {
+
+struct MicroBatcherOptions {
+  // Max number of requests evaluated in one batch.
+  int64_t max_batch_size = 64;
+
+  // Max time the first request of a batch waits for other requests before the
+  // batch is evaluated. Bounds the latency that batching adds to a request.
+  absl::Duration max_wait_time = absl::Microseconds(200);
+};
+
+// Statistics of a MicroBatcher. The histograms have power-of-two buckets:
+// histogram[0] counts zeros and histogram[i] counts values in
+// [2^(i-1), 2^i). Trailing empty buckets are omitted.
+struct MicroBatcherStatistics {
+  int64_t request_count = 0;
+  int64_t batch_count = 0;
+
+  // Sizes of the evaluated batches.
+  std::vector<int64_t> batch_size_histogram;
+
+  // Number of requests waiting for a batch to be evaluated, observed when
+  // a new request arrives.
+  std::vector<int64_t> queue_depth_histogram;
+};
+
+namespace serving_impl {
+
+inline void AddToPowerOfTwoHistogram(std::vector<int64_t>& histogram,
+                                     uint64_t value) {
+  size_t bucket = absl::bit_width(value);
+  if (histogram.size() <= bucket) {
+    histogram.resize(bucket + 1);
+  }
+  ++histogram[bucket];
+}
+
+}  // namespace serving_impl
+
+// Coalesces concurrent single-row requests into batches, evaluates each batch
+// with one ModelExecutor::ExecuteBatch call and returns the individual results
+// to the callers. For models that are compiled with
+// ModelExecutorOptions::enable_batch_lifting this replaces many scalar
+// evaluations by one evaluation of the model lifted to DenseArrays.
+//
+// There are no background threads: the first request of a batch (the
+// "leader") waits for up to `max_wait_time` until `max_batch_size` requests
+// are collected, and then evaluates the batch on its own thread while the
+// other callers of the batch are blocked. Meanwhile the next batch is
+// collected by the next leader, so several batches may be evaluated
+// concurrently, each on its own clone of the executor.
+//
+// Every request gets its own result (see ModelExecutor::ExecuteBatchPerRow),
+// so an error in one row does not affect the other rows. The cancellation
+// contexts of the callers are not propagated into the evaluation.
+//
+// All methods are thread-safe.
+template <typename Input, typename Output>
+class MicroBatcher {
+  using ModelExecutor = expr::ModelExecutor<Input, Output>;
+
+ public:
+  explicit MicroBatcher(ModelExecutor executor,
+                        MicroBatcherOptions options = {})
+      : options_(options), prototype_(std::move(executor)) {
+    DCHECK_GT(options_.max_batch_size, 0);
+  }
+
+  MicroBatcher(const MicroBatcher&) = delete;
+  MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+  // Evaluates the model on the input. Blocks until the batch containing the
+  // request is evaluated.
+  absl::StatusOr<Output> Execute(const Input& input) {
+    Request request;
+    request.input = &input;
+    std::vector<Request*> batch;
+    std::unique_ptr<ModelExecutor> executor;
+    {
+      absl::MutexLock lock(mutex_);
+      ++statistics_.request_count;
+      serving_impl::AddToPowerOfTwoHistogram(statistics_.queue_depth_histogram,
+                                             pending_.size());
+      pending_.push_back(&request);
+      if (has_leader_) {
+        mutex_.Await(absl::Condition(&Request::NotQueued, &request));
+        if (request.state == RequestState::kDone) {
+          return std::move(request.result);
+        }
+      } else {
+        has_leader_ = true;
+        request.state = RequestState::kLeader;
+      }
+      // This request is the leader of the next batch.
+      auto batch_is_full = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+        return static_cast<int64_t>(pending_.size()) >= options_.max_batch_size;
+      };
+      mutex_.AwaitWithTimeout(absl::Condition(&batch_is_full),
+                              options_.max_wait_time);
+      size_t batch_size =
+          std::min<size_t>(pending_.size(), options_.max_batch_size);
+      batch.assign(pending_.begin(), pending_.begin() + batch_size);
+      pending_.erase(pending_.begin(), pending_.begin() + batch_size);
+      if (pending_.empty()) {
+        has_leader_ = false;
+      } else {
+        pending_.front()->state = RequestState::kLeader;
+      }
+      ++statistics_.batch_count;
+      serving_impl::AddToPowerOfTwoHistogram(statistics_.batch_size_histogram,
+                                             batch_size);
+      if (!free_executors_.empty()) {
+        executor = std::move(free_executors_.back());
+        free_executors_.pop_back();
+      }
+    }
+    if (executor == nullptr) {
+      // Clone only reads the immutable data of the prototype, so it is done
+      // outside of the lock.
+      absl::StatusOr<ModelExecutor> clone = prototype_.Clone();
+      if (clone.ok()) {
+        executor = std::make_unique<ModelExecutor>(*std::move(clone));
+      } else {
+        for (Request* r : batch) {
+          r->result = clone.status();
+        }
+      }
+    }
+    if (executor != nullptr) {
+      EvaluateBatch(*executor, batch);
+    }
+    absl::MutexLock lock(mutex_);
+    for (Request* r : batch) {
+      r->state = RequestState::kDone;
+    }
+    if (executor != nullptr) {
+      free_executors_.push_back(std::move(executor));
+    }
+    return std::move(request.result);
+  }
+
+  MicroBatcherStatistics GetStatistics() const {
+    absl::MutexLock lock(mutex_);
+    return statistics_;
+  }
+
+ private:
+  enum class RequestState { kQueued, kLeader, kDone };
+
+  struct Request {
+    const Input* input = nullptr;
+    RequestState state = RequestState::kQueued;
+    absl::StatusOr<Output> result;
+
+    static bool NotQueued(Request* request) {
+      return request->state != RequestState::kQueued;
+    }
+  };
+
+  static void EvaluateBatch(ModelExecutor& executor,
+                            absl::Span<Request* const> batch) {
+    // The batch is evaluated on the thread of one of the callers, so its
+    // cancellation context must not affect the other requests.
+    CancellationContext::ScopeGuard cancellation_scope(nullptr);
+    std::vector<const Input*> inputs;
+    inputs.reserve(batch.size());
+    for (const Request* r : batch) {
+      inputs.push_back(r->input);
+    }
+    std::vector<absl::StatusOr<Output>> results =
+        executor.ExecuteBatchPerRow({}, inputs);
+    DCHECK_EQ(results.size(), batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      batch[i]->result = std::move(results[i]);
+    }
+  }
+
+  const MicroBatcherOptions options_;
+  // Never used for evaluation, only cloned.
+  const ModelExecutor prototype_;
+  mutable absl::Mutex mutex_;
+  std::deque<Request*> pending_ ABSL_GUARDED_BY(mutex_);
+  bool has_leader_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::unique_ptr<ModelExecutor>> free_executors_
+      ABSL_GUARDED_BY(mutex_);
+  MicroBatcherStatistics statistics_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace arolla
+
+#endif  // AROLLA_SERVING_MICRO_BATCHER_H_
@@ -0,0 +1,134 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/serving/micro_batcher.h"
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "arolla/util/status_macros_backport.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "arolla/expr/eval/model_executor.h"
+#include "arolla/expr/expr.h"
+#include "arolla/io/accessors_input_loader.h"
+#include "arolla/io/input_loader.h"
+
+namespace arolla {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::arolla::expr::CallOp;
+using ::arolla::expr::Leaf;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+struct TestInput {
+  int64_t x;
+  int64_t y;
+};
+
+absl::StatusOr<expr::ModelExecutor<TestInput, int64_t>> CompileModel(
+    absl::string_view op_name) {
+  ASSIGN_OR_RETURN(auto expr, CallOp(op_name, {Leaf("x"), Leaf("y")}));
+  ASSIGN_OR_RETURN(auto input_loader,
+                   CreateAccessorsInputLoader<TestInput>(
+                       "x", [](const TestInput& in) { return in.x; },  //
+                       "y", [](const TestInput& in) { return in.y; }));
+  return expr::ModelExecutor<TestInput, int64_t>::Compile(
+      expr, *input_loader, /*slot_listener=*/nullptr,
+      {.enable_batch_lifting = true});
+}
+
+TEST(PowerOfTwoHistogramTest, Buckets) {
+  std::vector<int64_t> histogram;
+  for (uint64_t value : {0, 1, 2, 3, 4, 7, 8}) {
+    serving_impl::AddToPowerOfTwoHistogram(histogram, value);
+  }
+  EXPECT_THAT(histogram, ElementsAre(1, 1, 2, 2, 1));
+}
+
+TEST(MicroBatcherTest, SingleThread) {
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModel("math.add"));
+  ASSERT_TRUE(executor.IsBatchLifted());
+  MicroBatcher<TestInput, int64_t> batcher(
+      std::move(executor), {.max_wait_time = absl::ZeroDuration()});
+  EXPECT_THAT(batcher.Execute({.x = 5, .y = 7}), IsOkAndHolds(12));
+  EXPECT_THAT(batcher.Execute({.x = 50, .y = 7}), IsOkAndHolds(57));
+  MicroBatcherStatistics statistics = batcher.GetStatistics();
+  EXPECT_THAT(statistics.request_count, Eq(2));
+  EXPECT_THAT(statistics.batch_count, Eq(2));
+  EXPECT_THAT(statistics.batch_size_histogram, ElementsAre(0, 2));
+  EXPECT_THAT(statistics.queue_depth_histogram, ElementsAre(2));
+}
+
+TEST(MicroBatcherTest, ConcurrentRequests) {
+  constexpr int kThreadCount = 8;
+  constexpr int kRequestsPerThread = 200;
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModel("math.add"));
+  MicroBatcher<TestInput, int64_t> batcher(
+      std::move(executor),
+      {.max_batch_size = 4, .max_wait_time = absl::Milliseconds(1)});
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&batcher, t] {
+      for (int i = 0; i < kRequestsPerThread; ++i) {
+        EXPECT_THAT(batcher.Execute({.x = t, .y = i}), IsOkAndHolds(t + i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  MicroBatcherStatistics statistics = batcher.GetStatistics();
+  EXPECT_THAT(statistics.request_count, Eq(kThreadCount * kRequestsPerThread));
+  // Batch sizes are in [1, 4], i.e. in the buckets 1..3.
+  EXPECT_LE(statistics.batch_size_histogram.size(), 4);
+  EXPECT_THAT(std::accumulate(statistics.batch_size_histogram.begin(),
+                              statistics.batch_size_histogram.end(), 0),
+              Eq(statistics.batch_count));
+  EXPECT_THAT(std::accumulate(statistics.queue_depth_histogram.begin(),
+                              statistics.queue_depth_histogram.end(), 0),
+              Eq(statistics.request_count));
+}
+
+TEST(MicroBatcherTest, ErrorsDoNotAffectOtherRows) {
+  ASSERT_OK_AND_ASSIGN(auto executor, CompileModel("math.floordiv"));
+  ASSERT_TRUE(executor.IsBatchLifted());
+  MicroBatcher<TestInput, int64_t> batcher(
+      std::move(executor),
+      {.max_batch_size = 2, .max_wait_time = absl::Seconds(10)});
+  absl::StatusOr<int64_t> error_result;
+  std::thread thread(
+      [&] { error_result = batcher.Execute({.x = 1, .y = 0}); });
+  EXPECT_THAT(batcher.Execute({.x = 12, .y = 5}), IsOkAndHolds(2));
+  thread.join();
+  EXPECT_THAT(error_result, StatusIs(absl::StatusCode::kInvalidArgument,
+                                     HasSubstr("division by zero")));
+  EXPECT_THAT(batcher.GetStatistics().batch_size_histogram,
+              ElementsAre(0, 0, 1));
+}
+
+}  // namespace
+}  // namespace arolla
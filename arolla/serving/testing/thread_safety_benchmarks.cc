@@ -187,27 +187,46 @@ struct Pool {
   }
 };
 
+// Model factory setting ShardedPoolThreadSafetyPolicy.
+template <int size>
+struct ShardedPool {
+  ModelFunction operator()() const {
+    return GetExprCompiler()
+        .SetShardedPoolThreadSafetyPolicy()
+        .Compile(BenchmarkModel(size))
+        .value();
+  }
+};
+
 BENCHMARK(BM_LocalModel<ThreadUnsafe<10>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_LocalModel<AlwaysClone<10>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_LocalModel<Pool<10>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_LocalModel<ShardedPool<10>>)->Apply(BenchmarkSettings);
 
 BENCHMARK(BM_SharedModel<AlwaysClone<10>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_SharedModel<Pool<10>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_SharedModel<ShardedPool<10>>)->Apply(BenchmarkSettings);
 
 BENCHMARK(BM_SharedModelWithInterleaving<AlwaysClone<10>>)
     ->Apply(BenchmarkSettings);
 BENCHMARK(BM_SharedModelWithInterleaving<Pool<10>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_SharedModelWithInterleaving<ShardedPool<10>>)
+    ->Apply(BenchmarkSettings);
 
 BENCHMARK(BM_LocalModel<ThreadUnsafe<1000>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_LocalModel<AlwaysClone<1000>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_LocalModel<Pool<1000>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_LocalModel<ShardedPool<1000>>)->Apply(BenchmarkSettings);
 
 BENCHMARK(BM_SharedModel<AlwaysClone<1000>>)->Apply(BenchmarkSettings);
 BENCHMARK(BM_SharedModel<Pool<1000>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_SharedModel<ShardedPool<1000>>)->Apply(BenchmarkSettings);
 
 BENCHMARK(BM_SharedModelWithInterleaving<AlwaysClone<1000>>)
     ->Apply(BenchmarkSettings);
 BENCHMARK(BM_SharedModelWithInterleaving<Pool<1000>>)->Apply(BenchmarkSettings);
+BENCHMARK(BM_SharedModelWithInterleaving<ShardedPool<1000>>)
+    ->Apply(BenchmarkSettings);
 
 }  // namespace
 }  // namespace arolla
@@ -89,6 +89,9 @@ class LruCache {
     return &entries_.front().value;
   }
 
+  // Returns the number of stored values.
+  size_t size() const { return entries_.size(); }
+
   // Clears the cache.
   void Clear() {
     entries_.clear();
@@ -69,8 +69,10 @@ TEST(LruCache, Clear) {
   ASSERT_THAT(cache.LookupOrNull(1), IsNull());
   cache.Put(1, 1.5);
   ASSERT_THAT(cache.LookupOrNull(1), Pointee(1.5));
+  ASSERT_EQ(cache.size(), 1);
   cache.Clear();
   ASSERT_THAT(cache.LookupOrNull(1), IsNull());
+  ASSERT_EQ(cache.size(), 0);
 }
 
 TEST(LruCache, Overwrite) {
@@ -17,12 +17,19 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+
 namespace arolla {
 
 StdThreading::StdThreading()
@@ -32,6 +39,213 @@ std::function<void()> StdThreading::StartThread(std::function<void()> fn) {
   return [t = std::make_shared<std::thread>(std::move(fn))] { t->join(); };
 }
 
+struct WorkStealingThreading::Task {
+  explicit Task(TaskFn fn) : fn(std::move(fn)) {}
+
+  TaskFn fn;
+  std::atomic<bool> claimed = false;
+  absl::Notification done;
+};
+
+struct WorkStealingThreading::Worker {
+  const WorkStealingThreading* owner;
+  absl::Mutex mutex;
+  std::deque<std::shared_ptr<Task>> tasks ABSL_GUARDED_BY(mutex);
+  std::thread thread;
+};
+
+namespace {
+
+// The worker that runs on the current thread, if any.
+thread_local constinit const void* current_worker = nullptr;
+
+}  // namespace
+
+WorkStealingThreading::WorkStealingThreading(
+    WorkStealingThreadingOptions options)
+    : thread_count_(options.thread_count > 0
+                        ? options.thread_count
+                        : std::max<int>(std::thread::hardware_concurrency(),
+                                        1)),
+      spin_iterations_(std::max(options.spin_iterations, 0)) {
+  for (int i = 0; i < thread_count_; ++i) {
+    AddWorker();
+  }
+}
+
+WorkStealingThreading::~WorkStealingThreading() {
+  {
+    absl::MutexLock lock(mutex_);
+    stopping_ = true;
+  }
+  // Tasks that are still running may add new workers, so the list is
+  // re-read until all the workers are joined.
+  for (size_t joined = 0;; ++joined) {
+    std::thread* thread;
+    {
+      absl::ReaderMutexLock lock(workers_mutex_);
+      if (joined == workers_.size()) {
+        break;
+      }
+      thread = &workers_[joined]->thread;
+    }
+    thread->join();
+  }
+  DCHECK_EQ(pending_count_.load(), 0);
+}
+
+int WorkStealingThreading::worker_count() const {
+  absl::ReaderMutexLock lock(workers_mutex_);
+  return static_cast<int>(workers_.size());
+}
+
+void WorkStealingThreading::AddWorker() {
+  free_worker_count_.fetch_add(1);
+  absl::MutexLock lock(workers_mutex_);
+  auto& worker = workers_.emplace_back(std::make_unique<Worker>());
+  worker->owner = this;
+  worker->thread = std::thread(
+      [this, worker = worker.get()] { WorkerLoop(worker); });
+}
+
+ThreadingInterface::JoinFn WorkStealingThreading::StartThread(TaskFn fn) {
+  auto task = std::make_shared<Task>(std::move(fn));
+  {
+    absl::ReaderMutexLock lock(workers_mutex_);
+    const Worker* self = static_cast<const Worker*>(current_worker);
+    Worker* worker =
+        self != nullptr && self->owner == this
+            ? const_cast<Worker*>(self)
+            : workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                       workers_.size()]
+                  .get();
+    absl::MutexLock worker_lock(worker->mutex);
+    worker->tasks.push_back(task);
+  }
+  // NOTE: The default (sequentially consistent) memory order is needed for
+  // all the counters, see the comment in WorkerLoop.
+  if (pending_count_.fetch_add(1) + 1 > free_worker_count_.load()) {
+    // All the workers may be blocked by the tasks, so a new one is needed to
+    // guarantee that the task starts.
+    AddWorker();
+  }
+  if (parked_count_.load() > 0) {
+    // Releasing the mutex makes the parked workers re-check their condition.
+    absl::MutexLock lock(mutex_);
+  }
+  return [this, task = std::move(task)] {
+    if (TryClaim(*task)) {
+      task->fn();
+      task->done.Notify();
+    } else {
+      task->done.WaitForNotification();
+    }
+  };
+}
+
+bool WorkStealingThreading::TryClaim(Task& task) {
+  if (task.claimed.exchange(true, std::memory_order_acq_rel)) {
+    return false;
+  }
+  pending_count_.fetch_sub(1);
+  return true;
+}
+
+std::shared_ptr<WorkStealingThreading::Task> WorkStealingThreading::FindTask(
+    Worker* self) {
+  auto pop = [&](Worker& worker, bool back) -> std::shared_ptr<Task> {
+    absl::MutexLock lock(worker.mutex);
+    while (!worker.tasks.empty()) {
+      std::shared_ptr<Task> task;
+      if (back) {
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+      } else {
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+      }
+      // Skip the tasks that were run by their JoinFn.
+      if (TryClaim(*task)) {
+        return task;
+      }
+    }
+    return nullptr;
+  };
+  if (auto task = pop(*self, /*back=*/true)) {
+    return task;
+  }
+  absl::ReaderMutexLock lock(workers_mutex_);
+  const size_t worker_count = workers_.size();
+  const size_t start = next_worker_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < worker_count; ++i) {
+    Worker& victim = *workers_[(start + i) % worker_count];
+    if (&victim != self) {
+      if (auto task = pop(victim, /*back=*/false)) {
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingThreading::WorkerLoop(Worker* self) {
+  current_worker = self;
+  auto has_work_or_stopping = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return pending_count_.load() > 0 || stopping_;
+  };
+  while (true) {
+    // The worker stops being free *before* it claims a task. So when
+    // StartThread observes `pending_count > free_worker_count`, either some
+    // free worker is guaranteed to claim the task, or a new worker is added.
+    free_worker_count_.fetch_sub(1);
+    if (std::shared_ptr<Task> task = FindTask(self)) {
+      task->fn();
+      task->done.Notify();
+      free_worker_count_.fetch_add(1);
+      continue;
+    }
+    free_worker_count_.fetch_add(1);
+    for (int i = 0; i < spin_iterations_ && pending_count_.load() == 0; ++i) {
+      std::this_thread::yield();
+    }
+    absl::MutexLock lock(mutex_);
+    parked_count_.fetch_add(1);
+    mutex_.Await(absl::Condition(&has_work_or_stopping));
+    parked_count_.fetch_sub(1);
+    if (stopping_ && pending_count_.load() == 0) {
+      free_worker_count_.fetch_sub(1);
+      return;
+    }
+  }
+}
+
+void ExecuteTasksInParallel(ThreadingInterface& threading,
+                            int max_parallelism,
+                            const std::vector<std::function<void()>>& tasks) {
+  std::atomic<size_t> current_task_num(0);
+  auto worker_fn = [&tasks, &current_task_num]() {
+    while (true) {
+      size_t id = current_task_num.fetch_add(1);
+      if (id >= tasks.size()) {
+        return;
+      }
+      tasks[id]();
+    }
+  };
+  const int num_threads = std::min<int>(tasks.size(), max_parallelism);
+  threading.WithThreading([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    join_fns.reserve(std::max(num_threads - 1, 0));
+    for (int i = 1; i < num_threads; ++i) {
+      join_fns.push_back(threading.StartThread(worker_fn));
+    }
+    worker_fn();
+    for (auto& join_fn : join_fns) {
+      join_fn();
+    }
+  });
+}
+
 void ExecuteTasksInParallel(int max_parallelism,
                             const std::vector<std::function<void()>>& tasks) {
   std::atomic<size_t> current_task_num(0);
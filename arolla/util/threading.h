@@ -16,9 +16,15 @@
 #define AROLLA_UTIL_THREADING_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
 namespace arolla {
 
 // Generic interface to start threads.
@@ -69,6 +75,77 @@ class StdThreading : public ThreadingInterface {
   int thread_count_;
 };
 
+struct WorkStealingThreadingOptions {
+  // The recommended thread count and the initial number of worker threads.
+  // 0 means std::thread::hardware_concurrency().
+  int thread_count = 0;
+
+  // Number of times an idle worker checks for new tasks (yielding in between)
+  // before it parks. Spinning reduces the latency of StartThread calls that
+  // come in quick succession, e.g. for every batch of rows.
+  int spin_iterations = 1000;
+};
+
+// Implementation of ThreadingInterface based on a persistent pool of worker
+// threads, so StartThread does not create a new thread every time.
+//
+// Every worker has its own deque of tasks. StartThread called from a worker
+// pushes the task into the worker's own deque, otherwise the deques are
+// chosen round-robin. A worker takes tasks from the back of its own deque and
+// steals from the front of the other deques.
+//
+// Like StdThreading, StartThread guarantees that the task runs concurrently
+// with all the other started tasks (they may e.g. wait for each other on
+// a barrier): if there is no idle worker, a new one is added to the pool.
+// So the number of workers may grow above `thread_count` and never shrinks.
+// The JoinFn runs the task in the calling thread if no worker has started it
+// yet.
+class WorkStealingThreading final : public ThreadingInterface {
+ public:
+  explicit WorkStealingThreading(WorkStealingThreadingOptions options = {});
+
+  // Waits for all the started tasks and stops the workers.
+  ~WorkStealingThreading() final;
+
+  WorkStealingThreading(const WorkStealingThreading&) = delete;
+  WorkStealingThreading& operator=(const WorkStealingThreading&) = delete;
+
+  int GetRecommendedThreadCount() const final { return thread_count_; }
+  [[nodiscard]] JoinFn StartThread(TaskFn fn) final;
+
+  // The current number of worker threads.
+  int worker_count() const;
+
+ private:
+  struct Task;
+  struct Worker;
+
+  void AddWorker();
+  void WorkerLoop(Worker* self);
+  // Finds and claims a task, preferring the tasks of `self`.
+  std::shared_ptr<Task> FindTask(Worker* self);
+  // Claims the task for running, returns false if it is already claimed.
+  bool TryClaim(Task& task);
+
+  const int thread_count_;
+  const int spin_iterations_;
+
+  mutable absl::Mutex workers_mutex_;
+  std::vector<std::unique_ptr<Worker>> workers_
+      ABSL_GUARDED_BY(workers_mutex_);
+  std::atomic<uint64_t> next_worker_ = 0;
+
+  // Number of the started tasks that are not claimed yet.
+  std::atomic<int64_t> pending_count_ = 0;
+  // Number of workers that are not running (or about to run) a task.
+  std::atomic<int64_t> free_worker_count_ = 0;
+  // Number of workers waiting on `mutex_`.
+  std::atomic<int64_t> parked_count_ = 0;
+
+  absl::Mutex mutex_;
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
 // Executes the given set of tasks in parallel and then waits for them to all
 // complete.
 //
@@ -77,6 +154,13 @@ class StdThreading : public ThreadingInterface {
 void ExecuteTasksInParallel(int max_parallelism,
                             const std::vector<std::function<void()>>& tasks);
 
+// Same as above, but the threads are started using `threading` (e.g.
+// WorkStealingThreading to reuse them between calls). One of the tasks may
+// run in the calling thread.
+void ExecuteTasksInParallel(ThreadingInterface& threading,
+                            int max_parallelism,
+                            const std::vector<std::function<void()>>& tasks);
+
 }  // namespace arolla
 
 #endif  // AROLLA_UTIL_THREADING_H_
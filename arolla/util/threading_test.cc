@@ -0,0 +1,104 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "arolla/util/threading.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/synchronization/barrier.h"
+
+namespace arolla {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Ge;
+
+TEST(WorkStealingThreadingTest, RecommendedThreadCount) {
+  WorkStealingThreading threading({.thread_count = 3});
+  EXPECT_THAT(threading.GetRecommendedThreadCount(), Eq(3));
+  EXPECT_THAT(threading.worker_count(), Eq(3));
+}
+
+TEST(WorkStealingThreadingTest, TasksRunConcurrently) {
+  constexpr int kTaskCount = 6;
+  WorkStealingThreading threading({.thread_count = 2});
+  for (int i = 0; i < 100; ++i) {
+    // The tasks block until all of them are started, so the test would hang
+    // if the pool did not grow beyond the initial 2 workers.
+    absl::Barrier barrier(kTaskCount + 1);
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    for (int j = 0; j < kTaskCount; ++j) {
+      join_fns.push_back(
+          threading.StartThread([&barrier] { barrier.Block(); }));
+    }
+    barrier.Block();
+    for (auto& join_fn : join_fns) {
+      join_fn();
+    }
+  }
+  EXPECT_THAT(threading.worker_count(), Ge(kTaskCount));
+}
+
+TEST(WorkStealingThreadingTest, NestedStartThread) {
+  WorkStealingThreading threading({.thread_count = 2});
+  std::atomic<int> counter = 0;
+  auto join_fn = threading.StartThread([&] {
+    std::vector<ThreadingInterface::JoinFn> join_fns;
+    for (int i = 0; i < 8; ++i) {
+      join_fns.push_back(threading.StartThread([&] { counter.fetch_add(1); }));
+    }
+    for (auto& join_fn : join_fns) {
+      join_fn();
+    }
+  });
+  join_fn();
+  EXPECT_THAT(counter.load(), Eq(8));
+}
+
+TEST(WorkStealingThreadingTest, ExecuteTasksInParallel) {
+  WorkStealingThreading threading({.thread_count = 4});
+  for (int i = 0; i < 100; ++i) {
+    std::atomic<int64_t> sum = 0;
+    std::vector<std::function<void()>> tasks;
+    for (int j = 0; j < 16; ++j) {
+      tasks.push_back([&sum, j] { sum.fetch_add(j); });
+    }
+    ExecuteTasksInParallel(threading, /*max_parallelism=*/4, tasks);
+    EXPECT_THAT(sum.load(), Eq(120));
+  }
+}
+
+TEST(WorkStealingThreadingTest, DestructorWaitsForTasks) {
+  std::atomic<int> counter = 0;
+  {
+    WorkStealingThreading threading({.thread_count = 1});
+    for (int i = 0; i < 10; ++i) {
+      // Ignoring JoinFn is fine, the destructor waits for the tasks anyway.
+      (void)threading.StartThread([&counter] {
+        std::this_thread::yield();
+        counter.fetch_add(1);
+      });
+    }
+  }
+  EXPECT_THAT(counter.load(), Eq(10));
+}
+
+}  // namespace
+}  // namespace arolla
@@ -15,18 +15,25 @@
 // Python extension module for memoryview of arolla dense arrays.
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "absl/types/span.h"
 #include "arolla/array/qtype/types.h"
+#include "arolla/dense_array/bitmap.h"
 #include "arolla/dense_array/dense_array.h"
 #include "arolla/dense_array/qtype/types.h"
+#include "arolla/memory/buffer.h"
 #include "arolla/qtype/base_types.h"
 #include "arolla/qtype/optional_qtype.h"
 #include "arolla/qtype/qtype.h"
 #include "arolla/qtype/typed_value.h"
 #include "py/arolla/abc/pybind11_utils.h"
+#include "py/arolla/py_utils/py_utils.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 #include "pybind11_abseil/absl_casters.h"
@@ -36,6 +43,51 @@ namespace {
 
 namespace py = pybind11;
 
+// Returns a dense array that refers to the memory of `values` without copying.
+// The python object stays alive while the dense array (or any buffer derived
+// from it) exists. If the data is not properly aligned, it gets copied.
+template <typename T>
+TypedValue DenseArrayFromBufferInfo(py::buffer_info&& values,
+                                    const std::optional<py::buffer>& mask) {
+  const int64_t size = values.shape[0];
+  const T* data = static_cast<const T*>(values.ptr);
+  Buffer<T> buffer;
+  if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+    // The last reference to the buffer can be released from any thread, so
+    // the deleter acquires the GIL to release the python buffer.
+    std::shared_ptr<const void> holder(
+        new py::buffer_info(std::move(values)), [](py::buffer_info* info) {
+          AcquirePyGIL guard;
+          delete info;
+        });
+    buffer = Buffer<T>(std::move(holder), absl::MakeConstSpan(data, size));
+  } else {
+    typename Buffer<T>::Builder builder(size);
+    std::memcpy(builder.GetMutableSpan().data(), data, size * sizeof(T));
+    buffer = std::move(builder).Build();
+  }
+  bitmap::Bitmap bitmap;
+  if (mask.has_value()) {
+    py::buffer_info mask_info = mask->request();
+    if (mask_info.ndim != 1 || !mask_info.item_type_is_equivalent_to<bool>() ||
+        mask_info.strides[0] != sizeof(bool)) {
+      throw py::value_error(
+          "expected `mask` to be a contiguous one-dimensional boolean buffer");
+    }
+    if (mask_info.shape[0] != size) {
+      throw py::value_error(
+          "expected `mask` to have the same size as `values`");
+    }
+    bitmap::Builder bitmap_builder(size);
+    bitmap_builder.AddForEach(
+        absl::MakeConstSpan(static_cast<const bool*>(mask_info.ptr), size),
+        [](bool present) { return present; });
+    bitmap = std::move(bitmap_builder).Build();
+  }
+  return TypedValue::FromValue(
+      DenseArray<T>{std::move(buffer), std::move(bitmap)});
+}
+
 PYBIND11_MODULE(clib, m) {
   struct QValueBufferProxy {
     TypedValue qvalue;
@@ -95,6 +147,39 @@ PYBIND11_MODULE(clib, m) {
       py::arg("dense_array"), py::pos_only(),
       py::doc("get_dense_array_memoryview(dense_array, /)\n--\n\n"
               "Returns a memoryview of the internal buffer of `dense_array`."));
+
+  m.def(
+      "dense_array_from_buffer",
+      [](const py::buffer& values, const std::optional<py::buffer>& mask) {
+        py::buffer_info info = values.request();
+        if (info.ndim != 1 || info.strides[0] != info.itemsize) {
+          throw py::value_error(
+              "expected `values` to be a contiguous one-dimensional buffer");
+        }
+        if (info.item_type_is_equivalent_to<bool>()) {
+          return DenseArrayFromBufferInfo<bool>(std::move(info), mask);
+        } else if (info.item_type_is_equivalent_to<float>()) {
+          return DenseArrayFromBufferInfo<float>(std::move(info), mask);
+        } else if (info.item_type_is_equivalent_to<double>()) {
+          return DenseArrayFromBufferInfo<double>(std::move(info), mask);
+        } else if (info.item_type_is_equivalent_to<int32_t>()) {
+          return DenseArrayFromBufferInfo<int32_t>(std::move(info), mask);
+        } else if (info.item_type_is_equivalent_to<int64_t>()) {
+          return DenseArrayFromBufferInfo<int64_t>(std::move(info), mask);
+        } else if (info.item_type_is_equivalent_to<uint64_t>()) {
+          return DenseArrayFromBufferInfo<uint64_t>(std::move(info), mask);
+        }
+        PyErr_Format(PyExc_NotImplementedError,
+                     "cannot construct a dense array from a buffer "
+                     "(format=%s)",
+                     info.format.c_str());
+        throw py::error_already_set();
+      },
+      py::arg("values"), py::arg("mask") = py::none(), py::pos_only(),
+      py::doc("dense_array_from_buffer(values, mask=None, /)\n--\n\n"
+              "Returns a dense array that shares the memory with `values`.\n\n"
+              "`mask` is an optional boolean buffer of the same size; False\n"
+              "marks the missing elements."));
 }
 
 }  // namespace
@@ -12,8 +12,13 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from typing import Any
+
 from arolla import arolla
 
+def dense_array_from_buffer(
+    values: Any, mask: Any = None, /
+) -> arolla.QValue: ...
 def get_dense_array_memoryview(
     dense_array: arolla.QValue, /
 ) -> memoryview: ...
@@ -12,7 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
-"""Tools for low-level conversion from arolla dense array to numpy array."""
+"""Tools for low-level conversion between arolla dense arrays and numpy."""
 
 from arolla import arolla
 from arolla.experimental import clib
@@ -36,3 +36,27 @@ def numpy_ndarray_from_dense_array(dense_array: arolla.abc.QValue, /):
       clib.get_dense_array_memoryview(dense_array),
       dtype=_numpy_dtype_from_qtype[dense_array.qtype],
   )
+
+
+def dense_array_from_numpy_ndarray(ndarray, mask=None, /):
+  """Returns a dense array that shares the memory with `ndarray`.
+
+  The data is not copied if `ndarray` is C-contiguous and has one of the
+  supported dtypes (bool, float32, float64, int32, int64, uint64); otherwise
+  it is converted to a contiguous array first. The dense array keeps a
+  reference to the data, so `ndarray` must not be modified afterwards.
+
+  Args:
+    ndarray: A one-dimensional numpy array with the values.
+    mask: An optional boolean array of the same size; False marks the missing
+      values.
+  """
+  if ndarray.ndim != 1:
+    raise ValueError(
+        'expected a single dimensional array, got an array with'
+        f' {ndarray.ndim} dimensions'
+    )
+  ndarray = np.ascontiguousarray(ndarray)
+  if mask is not None:
+    mask = np.ascontiguousarray(mask, dtype=np.bool_)
+  return clib.dense_array_from_buffer(ndarray, mask)
@@ -97,6 +97,84 @@ class DenseArrayConversionTest(parameterized.TestCase):
     ):
       dense_array_numpy_conversion.numpy_ndarray_from_dense_array(dense_array)
 
+  @parameterized.parameters(
+      ('bool_', arolla.DENSE_ARRAY_BOOLEAN, [True, False, True]),
+      ('float32', arolla.DENSE_ARRAY_FLOAT32, [0.0, 1.5, -float('inf')]),
+      ('float64', arolla.DENSE_ARRAY_FLOAT64, [0.0, 1.5, -float('inf')]),
+      ('int32', arolla.DENSE_ARRAY_INT32, [1, -1, 2**31 - 1]),
+      ('int64', arolla.DENSE_ARRAY_INT64, [1, -1, 2**63 - 1]),
+      ('uint64', arolla.types.DENSE_ARRAY_UINT64, [0, 1, (2**64) - 1]),
+  )
+  def test_dense_array_from_numpy_ndarray(
+      self, dtype_name, expected_qtype, py_values
+  ):
+    ndarray = np.array(py_values, dtype=dtype_name)
+    dense_array = dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+        ndarray
+    )
+    self.assertEqual(dense_array.qtype, expected_qtype)
+    self.assertEqual(dense_array.py_value(), py_values)
+
+  def test_dense_array_from_numpy_ndarray_with_mask(self):
+    dense_array = dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+        np.arange(40, dtype='float32'), np.arange(40) % 3 != 0
+    )
+    self.assertEqual(
+        dense_array.py_value(),
+        [None if i % 3 == 0 else float(i) for i in range(40)],
+    )
+
+  def test_dense_array_from_numpy_ndarray_is_zero_copy(self):
+    ndarray = np.array([1.0, 2.0, 3.0], dtype='float64')
+    dense_array = dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+        ndarray
+    )
+    self.assertEqual(
+        dense_array_numpy_conversion.numpy_ndarray_from_dense_array(
+            dense_array
+        ).ctypes.data,
+        ndarray.ctypes.data,
+    )
+    # The dense array keeps the data alive.
+    ndarray_weakref = weakref.ref(ndarray)
+    del ndarray
+    gc.collect()
+    self.assertIsNotNone(ndarray_weakref())
+    self.assertEqual(dense_array.py_value(), [1.0, 2.0, 3.0])
+    del dense_array
+    gc.collect()
+    self.assertIsNone(ndarray_weakref())
+
+  def test_dense_array_from_numpy_ndarray_non_contiguous(self):
+    ndarray = np.arange(10, dtype='int32')[::2]
+    dense_array = dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+        ndarray
+    )
+    self.assertEqual(dense_array.py_value(), [0, 2, 4, 6, 8])
+
+  def test_dense_array_from_numpy_ndarray_value_error(self):
+    with self.assertRaisesWithLiteralMatch(
+        ValueError,
+        'expected a single dimensional array, got an array with 2 dimensions',
+    ):
+      dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+          np.zeros((2, 2))
+      )
+    with self.assertRaisesWithLiteralMatch(
+        ValueError, 'expected `mask` to have the same size as `values`'
+    ):
+      dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+          np.zeros(3), np.ones(2, dtype=np.bool_)
+      )
+
+  def test_dense_array_from_numpy_ndarray_not_implemented_error(self):
+    with self.assertRaisesRegex(
+        NotImplementedError, 'cannot construct a dense array from a buffer'
+    ):
+      dense_array_numpy_conversion.dense_array_from_numpy_ndarray(
+          np.zeros(3, dtype='int8')
+      )
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -0,0 +1,74 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import re
+
+from absl.testing import absltest
+from absl.testing import parameterized
+from arolla import arolla
+from arolla.operator_tests import backend_test_base
+from arolla.operator_tests import utils
+
+M = arolla.M
+
+
+class MathApproxInverseCdfTest(
+    parameterized.TestCase, backend_test_base.SelfEvalMixin
+):
+
+  @parameterized.named_parameters(*utils.ARRAY_FACTORIES)
+  def testSmallGroupsAreExact(self, array_factory):
+    values = array_factory([7, 9, 4, 1, 13, 2, 5, 3], arolla.INT32)
+    edge = arolla.eval(M.edge.from_sizes(array_factory([6, 0, 2])))
+    for cdf in [0.0, 0.1, 0.5, 0.6, 1.0]:
+      arolla.testing.assert_qvalue_allequal(
+          self.eval(M.math.approx_inverse_cdf(values, cdf, edge)),
+          self.eval(M.math.inverse_cdf(values, cdf, edge)),
+      )
+
+  @parameterized.named_parameters(*utils.ARRAY_FACTORIES)
+  def testLargeGroup(self, array_factory):
+    size = 100000
+    values = array_factory(
+        [(i * 7919) % size for i in range(size)], arolla.INT64
+    )
+    actual_result = self.eval(
+        M.math.approx_inverse_cdf(values, 0.3, k=arolla.int64(400))
+    )
+    self.assertTrue(actual_result.is_present)
+    self.assertAlmostEqual(actual_result.value, 0.3 * size, delta=0.01 * size)
+
+  @parameterized.named_parameters(*utils.ARRAY_FACTORIES)
+  def testNaNValue(self, array_factory):
+    values = array_factory([7, float('nan'), 4, 1, 13, 2], arolla.FLOAT32)
+    edge = arolla.eval(M.edge.from_sizes(array_factory([3, 3])))
+    arolla.testing.assert_qvalue_allclose(
+        self.eval(M.math.approx_inverse_cdf(values, 0.1, edge)),
+        array_factory([float('nan'), 1]),
+    )
+
+  @parameterized.named_parameters(*utils.ARRAY_FACTORIES)
+  def testInvalidArgs(self, array_factory):
+    values = array_factory([7, 9, 4], arolla.FLOAT32)
+    with self.assertRaisesRegex(
+        ValueError, re.escape('invalid cdf_arg, cdf_arg must be in [0, 1]')
+    ):
+      _ = self.eval(M.math.approx_inverse_cdf(values, 1.5))
+    with self.assertRaisesRegex(
+        ValueError, re.escape('invalid k, k must be in [8, 65536], got 4')
+    ):
+      _ = self.eval(M.math.approx_inverse_cdf(values, 0.5, k=4))
+
+
+if __name__ == '__main__':
+  absltest.main()
@@ -602,6 +602,54 @@ def inverse_cdf(x, cdf_arg, into=arolla.unspecified()):
   return _inverse_cdf(x, into, M_core.to_float32(cdf_arg))
 
 
+@arolla.optools.add_to_registry()
+@arolla.optools.as_backend_operator(
+    'math._approx_inverse_cdf',
+    qtype_inference_expr=M_qtype.with_value_qtype(
+        M_qtype.get_parent_shape_qtype(P.into), M_qtype.get_scalar_qtype(P.x)
+    ),
+)
+def _approx_inverse_cdf(x, into, cdf_arg, k):
+  raise NotImplementedError('provided by backend')
+
+
+@arolla.optools.add_to_registry()
+@arolla.optools.as_lambda_operator(
+    'math.approx_inverse_cdf',
+    qtype_constraints=[
+        constraints.expect_numerics(P.x),
+        constraints.expect_array(P.x),
+        constraints.expect_numerics(P.cdf_arg),
+        constraints.expect_scalar_or_optional(P.cdf_arg),
+        *constraints.expect_edge_or_unspecified(P.into, child_side_param=P.x),
+        constraints.expect_scalar_integer(P.k),
+    ],
+)
+def approx_inverse_cdf(x, cdf_arg, into=arolla.unspecified(), k=200):
+  """Returns an approximation of math.inverse_cdf using bounded memory.
+
+  Instead of storing all the values of a group, keeps a KLL sketch with
+  O(k * log(size / k)) of them. The rank of the result differs from the exact
+  one by ~1% of the group size for the default k = 200; the error decreases
+  proportionally to 1 / k. Groups with up to k values are processed exactly.
+
+  Args:
+    x: (array) An array of numbers.
+    cdf_arg: (float) CDF value.
+    into: (Edge) An edge to aggregate into. If not specified, the entire array
+      is considered a single group.
+    k: (int) Accuracy parameter, must be in [8, 65536].
+
+  Returns:
+    An array (or optional value, if aggregating to scalar) of values of
+    the same type as `x`.
+  """
+  into = M_core.default_if_unspecified(into, M_edge.to_scalar(x))
+  return _approx_inverse_cdf(
+      x, into, M_core.to_float32(cdf_arg), M_core.to_int64(k)
+  )
+
+
 @arolla.optools.add_to_registry()
 @arolla.optools.as_backend_operator(
     'math.t_distribution_inverse_cdf',